@@ -35,7 +35,8 @@ ifeq ($(PLATFORM),Linux)
     LIBSNDFILE \
     LIBCAIRO \
     LIBFREETYPE \
-    LIBX11
+    LIBX11 \
+    LIBXEXT
 
   TEST_DEPENDENCIES        += \
     LSP_R3D_BASE_LIB \
@@ -49,7 +50,8 @@ ifeq ($(PLATFORM),BSD)
     LIBICONV \
     LIBCAIRO \
     LIBFREETYPE \
-    LIBX11
+    LIBX11 \
+    LIBXEXT
 
   TEST_DEPENDENCIES        += \
     LSP_R3D_BASE_LIB \
@@ -72,6 +74,7 @@ ALL_DEPENDENCIES = \
   LIBFREETYPE \
   LIBICONV \
   LIBX11 \
+  LIBXEXT \
   LIBGL \
   LIBSHLWAPI \
   LIBWINMM \
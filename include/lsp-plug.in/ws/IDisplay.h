@@ -35,6 +35,8 @@
 #include <lsp-plug.in/ws/ISurface.h>
 #include <lsp-plug.in/ws/IDataSink.h>
 #include <lsp-plug.in/ws/IDataSource.h>
+#include <lsp-plug.in/ws/IIconSet.h>
+#include <lsp-plug.in/ws/SpriteAtlas.h>
 #include <lsp-plug.in/ws/IWindow.h>
 
 namespace lsp
@@ -277,6 +279,81 @@ namespace lsp
                  */
                 virtual IWindow *create_window(void *handle);
 
+                /** Create native window with the specified border style at the default screen.
+                 * Windows of BS_POPUP and BS_DROPDOWN style can be taken from the pool of
+                 * pre-initialized windows kept by the display, so showing menus and dropdown
+                 * lists does not require creation of a new native window
+                 *
+                 * @param style border style of the window
+                 * @return native window
+                 */
+                virtual IWindow *create_window(border_style_t style);
+
+                /** Set the number of pre-initialized windows of each pooled border style
+                 * (BS_POPUP, BS_DROPDOWN) kept by the display. Destroyed windows of these styles
+                 * are returned to the pool until it becomes full
+                 *
+                 * @param count number of windows, zero value disables the pool
+                 * @return status of operation
+                 */
+                virtual status_t set_window_pool_size(size_t count);
+
+                /** Get the number of pre-initialized windows of each pooled border style
+                 *
+                 * @return number of windows
+                 */
+                virtual size_t window_pool_size();
+
+                /** Set the maximum amount of memory kept by the pool of released image surfaces.
+                 * Surfaces created by create_surface(), ISurface::create() and ISurface::create_copy()
+                 * return their pixel data to the pool on destroy, so the temporary layers
+                 * re-created every frame do not cause new allocations
+                 *
+                 * @param bytes number of bytes, zero value disables the pool
+                 * @return status of operation
+                 */
+                virtual status_t set_surface_pool_limit(size_t bytes);
+
+                /** Get the maximum amount of memory kept by the pool of released image surfaces
+                 *
+                 * @return number of bytes
+                 */
+                virtual size_t surface_pool_limit();
+
+                /** Get statistics of the pool of released image surfaces
+                 *
+                 * @param stats pointer to store statistics
+                 * @return status of operation
+                 */
+                virtual status_t get_surface_pool_stats(surface_pool_stats_t *stats);
+
+                /** Destroy the set of windows at once. Windows created as children of other
+                 * windows in the set are destroyed by the window system together with
+                 * their parents, so no additional requests are issued for them.
+                 * The window objects should be deleted by the caller after the call
+                 *
+                 * @param list list of windows, NULL entries are skipped
+                 * @param count number of elements in the list
+                 */
+                virtual void destroy_windows(IWindow * const *list, size_t count);
+
+                /** Create empty icon set which can be shared between windows of the display.
+                 * Images are converted into the native format once when added to the set,
+                 * so assigning the icon set to a window does not repeat the conversion
+                 *
+                 * @return icon set or NULL if not supported, should be deleted by the caller
+                 */
+                virtual IIconSet *create_icon_set();
+
+                /** Create sprite atlas which packs small images into shared pages of the
+                 * specified size, pages are created by create_surface()
+                 *
+                 * @param width width of the atlas page
+                 * @param height height of the atlas page
+                 * @return sprite atlas or NULL on error, should be deleted by the caller
+                 */
+                virtual SpriteAtlas *create_sprite_atlas(size_t width, size_t height);
+
                 /**
                  * Wrap window handle
                  * @param handle handle to wrap
@@ -298,6 +375,15 @@ namespace lsp
                  */
                 virtual ISurface *create_surface(size_t width, size_t height);
 
+                /** Create image surface of the specified pixel format for drawing
+                 *
+                 * @param width surface width
+                 * @param height surface height
+                 * @param format pixel format
+                 * @return surface or NULL on error or if the format is not supported
+                 */
+                virtual ISurface *create_surface(size_t width, size_t height, surface_format_t format);
+
                 /**
                  * Get estimation surface. This surface is not for drawing but
                  * for estimating additional parameters like text parameters, etc.
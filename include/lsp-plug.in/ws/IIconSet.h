@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_WS_IICONSET_H_
+#define LSP_PLUG_IN_WS_IICONSET_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        /**
+         * Set of window icon images of different resolution. The set is created once
+         * by the display and can be assigned to any number of windows. Windows do not
+         * keep references to the set, so it can be deleted after assignment
+         */
+        class IIconSet
+        {
+            private:
+                IIconSet & operator = (const IIconSet &);
+                IIconSet(const IIconSet &);
+
+            public:
+                explicit IIconSet();
+                virtual ~IIconSet();
+
+            public:
+                /** Add image of the specific resolution to the icon set
+                 *
+                 * @param bgra the packed array of Blue, Green, Red and Alpha components
+                 * @param width width of the image
+                 * @param height height of the image
+                 * @return status of operation
+                 */
+                virtual status_t add(const void *bgra, size_t width, size_t height);
+
+                /** Get number of images in the icon set
+                 *
+                 * @return number of images
+                 */
+                virtual size_t size() const;
+
+                /** Remove all images from the icon set
+                 *
+                 */
+                virtual void clear();
+        };
+    }
+}
+
+#endif /* LSP_PLUG_IN_WS_IICONSET_H_ */
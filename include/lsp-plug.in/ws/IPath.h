@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_WS_IPATH_H_
+#define LSP_PLUG_IN_WS_IPATH_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        /**
+         * Reusable drawing path. The path is built once by the toolkit and then can be
+         * filled or stroked many times at different positions by the surface which created
+         * it or by any other surface of the same display. Coordinates of the path are
+         * relative to the position passed to the drawing methods
+         */
+        class IPath
+        {
+            private:
+                IPath & operator = (const IPath &);
+                IPath(const IPath &);
+
+            public:
+                explicit IPath();
+                virtual ~IPath();
+
+            public:
+                /** Start new sub-path at the specified point
+                 *
+                 * @param x horizontal coordinate
+                 * @param y vertical coordinate
+                 * @return status of operation
+                 */
+                virtual status_t move_to(float x, float y);
+
+                /** Add line from the current point to the specified point
+                 *
+                 * @param x horizontal coordinate
+                 * @param y vertical coordinate
+                 * @return status of operation
+                 */
+                virtual status_t line_to(float x, float y);
+
+                /** Add cubic Bezier spline from the current point to the specified point
+                 *
+                 * @param x1 horizontal coordinate of the first control point
+                 * @param y1 vertical coordinate of the first control point
+                 * @param x2 horizontal coordinate of the second control point
+                 * @param y2 vertical coordinate of the second control point
+                 * @param x3 horizontal coordinate of the end point
+                 * @param y3 vertical coordinate of the end point
+                 * @return status of operation
+                 */
+                virtual status_t curve_to(float x1, float y1, float x2, float y2, float x3, float y3);
+
+                /** Add circular arc in the direction of increasing angles. If there is current
+                 * point, the line to the start of the arc is added first
+                 *
+                 * @param cx horizontal coordinate of the center
+                 * @param cy vertical coordinate of the center
+                 * @param r radius
+                 * @param a1 start angle in radians
+                 * @param a2 end angle in radians
+                 * @return status of operation
+                 */
+                virtual status_t arc(float cx, float cy, float r, float a1, float a2);
+
+                /** Close the current sub-path
+                 *
+                 * @return status of operation
+                 */
+                virtual status_t close();
+
+                /** Add closed rectangle with rounded corners, the default implementation
+                 * is built on top of move_to(), line_to(), arc() and close() methods
+                 *
+                 * @param mask corner mask, see SURFMASK_* constants
+                 * @param radius corner radius
+                 * @param left left coordinate
+                 * @param top top coordinate
+                 * @param width width of the rectangle
+                 * @param height height of the rectangle
+                 * @return status of operation
+                 */
+                virtual status_t round_rect(size_t mask, float radius, float left, float top, float width, float height);
+
+                /** Add closed circular sector, the default implementation is built
+                 * on top of move_to(), arc() and close() methods
+                 *
+                 * @param cx horizontal coordinate of the center
+                 * @param cy vertical coordinate of the center
+                 * @param r radius
+                 * @param a1 start angle in radians
+                 * @param a2 end angle in radians
+                 * @return status of operation
+                 */
+                virtual status_t sector(float cx, float cy, float r, float a1, float a2);
+
+                /** Get the bounding box of the path including control points of splines
+                 *
+                 * @param bounds array of four elements to store left, top, right and bottom coordinates
+                 * @return true if the path is not empty
+                 */
+                virtual bool get_bounds(float *bounds) const;
+
+                /** Remove all elements from the path
+                 *
+                 */
+                virtual void clear();
+        };
+    }
+}
+
+#endif /* LSP_PLUG_IN_WS_IPATH_H_ */
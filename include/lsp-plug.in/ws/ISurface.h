@@ -26,6 +26,7 @@
 
 #include <lsp-plug.in/ws/Font.h>
 #include <lsp-plug.in/ws/IGradient.h>
+#include <lsp-plug.in/ws/IPath.h>
 
 #define SURFMASK_LT_CORNER      0x01
 #define SURFMASK_RT_CORNER      0x02
@@ -90,6 +91,12 @@ namespace lsp
                  */
                 inline surface_type_t type()  const { return nType; }
 
+                /** Get pixel format of the surface
+                 *
+                 * @return pixel format of the surface
+                 */
+                virtual surface_format_t format() const;
+
             public:
                 /** Create child surface for drawing
                  * @param width surface width
@@ -98,12 +105,37 @@ namespace lsp
                  */
                 virtual ISurface *create(size_t width, size_t height);
 
+                /** Create child image surface of the specified pixel format for drawing.
+                 * Opaque layers can use SFMT_RGB24 format, alpha masks like shadows
+                 * and glyph masks can use SFMT_A8 format and be drawn by draw_mask()
+                 *
+                 * @param width surface width
+                 * @param height surface height
+                 * @param format pixel format
+                 * @return created surface or NULL if the format is not supported
+                 */
+                virtual ISurface *create(size_t width, size_t height, surface_format_t format);
+
                 /**
                  * Create copy of current surface
                  * @return copy of current surface
                  */
                 virtual ISurface *create_copy();
 
+                /**
+                 * Create view of the rectangular area of the surface. The view shares pixel data
+                 * with this surface, uses the same coordinate system and limits drawing to the area.
+                 * Drawing on views should be wrapped with start_direct() and end_direct() calls
+                 * of this surface, the surface should stay alive while there are views
+                 *
+                 * @param left left coordinate of the area
+                 * @param top top coordinate of the area
+                 * @param width width of the area
+                 * @param height height of the area
+                 * @return view of the surface or NULL if not supported
+                 */
+                virtual ISurface *create_view(ssize_t left, ssize_t top, size_t width, size_t height);
+
                 /** Create linear gradient
                  *
                  * @param x0
@@ -130,6 +162,13 @@ namespace lsp
                     float cx1, float cy1, float r1
                 );
 
+                /** Create empty path which can be filled or stroked many times by this
+                 * surface or other surfaces of the same display
+                 *
+                 * @return path or NULL if not supported, should be deleted by the caller
+                 */
+                virtual IPath *create_path();
+
                 /** Destroy surface
                  *
                  */
@@ -145,6 +184,17 @@ namespace lsp
                  */
                 virtual void end();
 
+                /** Get the region damaged by drawing since the last begin() call.
+                 * The region is stored as a limited set of device-space rectangles,
+                 * overlapping rectangles may be merged into their bounding box. Surfaces
+                 * which do not present the damaged region may report the whole surface
+                 *
+                 * @param rects array to store rectangles, may be NULL if count is zero
+                 * @param count maximum number of rectangles to store
+                 * @return total number of rectangles in the damaged region
+                 */
+                virtual size_t get_damage(ws::rectangle_t *rects, size_t count);
+
             public:
                 /** Draw surface
                  *
@@ -164,6 +214,18 @@ namespace lsp
                  */
                 virtual void draw(ISurface *s, float x, float y, float sx, float sy);
 
+                /** Draw surface with the specified filter. Low-quality filters are useful
+                 * for drawing of scaled thumbnails and frames of filmstrips
+                 *
+                 * @param s surface to draw
+                 * @param x offset from left
+                 * @param y offset from top
+                 * @param sx surface scale x
+                 * @param sy surface scale y
+                 * @param filter filter hint
+                 */
+                virtual void draw(ISurface *s, float x, float y, float sx, float sy, surface_filter_t filter);
+
                 /**
                  * Draw surface
                  * @param s surface to draw
@@ -206,6 +268,25 @@ namespace lsp
                  */
                 virtual void draw_clipped(ISurface *s, float x, float y, float sx, float sy, float sw, float sh);
 
+                /** Draw multiple rectangular areas of the same source surface in one call,
+                 * the result is equal to the sequence of draw_clipped() calls
+                 *
+                 * @param s surface to draw
+                 * @param list list of source rectangles and destination positions
+                 * @param count number of elements in the list
+                 */
+                virtual void draw_batch(ISurface *s, const surface_blit_t *list, size_t count);
+
+                /** Fill the area with the color using the alpha channel of the surface as a mask.
+                 * Surfaces of SFMT_A8 format are the most effective masks
+                 *
+                 * @param color color to fill
+                 * @param mask surface which alpha channel is used as mask
+                 * @param x offset from left
+                 * @param y offset from top
+                 */
+                virtual void draw_mask(const Color &color, ISurface *mask, float x, float y);
+
                 /** Draw filled rectangle
                  *
                  * @param color color of rectangle
@@ -692,6 +773,35 @@ namespace lsp
                  */
                 virtual void line(float x0, float y0, float x1, float y1, float width, IGradient *g);
 
+                /** Draw the batch of line segments of the same width and color. Backends that
+                 * override the method stroke the batch as a single path, so overlapping parts of
+                 * translucent segments are composited once. The default implementation calls line()
+                 * for each segment, so overlapping parts are composited once per segment
+                 *
+                 * @param x0 array of x coordinates of the first point of each segment
+                 * @param y0 array of y coordinates of the first point of each segment
+                 * @param x1 array of x coordinates of the second point of each segment
+                 * @param y1 array of y coordinates of the second point of each segment
+                 * @param n number of segments
+                 * @param width line width
+                 * @param color line color
+                 */
+                virtual void draw_lines(const float *x0, const float *y0, const float *x1, const float *y1, size_t n, float width, const Color &color);
+
+                /** Draw the batch of polylines of the same width and color. Backends that
+                 * override the method stroke the batch as a single path, so overlapping parts of
+                 * translucent polylines are composited once. The default implementation calls
+                 * wire_poly() for each polyline, so overlapping parts are composited once per polyline
+                 *
+                 * @param x array of x coordinates of points of all polylines, one polyline after another
+                 * @param y array of y coordinates of points of all polylines, one polyline after another
+                 * @param count array of numbers of points in each polyline
+                 * @param n number of polylines
+                 * @param width line width
+                 * @param color line color
+                 */
+                virtual void draw_polylines(const float *x, const float *y, const size_t *count, size_t n, float width, const Color &color);
+
                 /** Draw parametric line defined by equation a*x + b*y + c = 0
                  *
                  * @param a the x multiplier
@@ -803,6 +913,34 @@ namespace lsp
                  */
                 virtual void draw_poly(const Color &fill, const Color &wire, float width, const float *x, const float *y, size_t n);
 
+                /** Fill path created by create_path()
+                 *
+                 * @param color fill color
+                 * @param path path to fill
+                 * @param x horizontal offset of the path
+                 * @param y vertical offset of the path
+                 */
+                virtual void fill_path(const Color &color, IPath *path, float x, float y);
+
+                /** Fill path created by create_path()
+                 *
+                 * @param g gradient
+                 * @param path path to fill
+                 * @param x horizontal offset of the path
+                 * @param y vertical offset of the path
+                 */
+                virtual void fill_path(IGradient *g, IPath *path, float x, float y);
+
+                /** Stroke path created by create_path()
+                 *
+                 * @param color line color
+                 * @param width line width
+                 * @param path path to stroke
+                 * @param x horizontal offset of the path
+                 * @param y vertical offset of the path
+                 */
+                virtual void wire_path(const Color &color, float width, IPath *path, float x, float y);
+
                 /** Fill circle
                  *
                  * @param x center x
@@ -854,6 +992,23 @@ namespace lsp
                  */
                 virtual bool set_antialiasing(bool set);
 
+                /** Get decimation state of dense polygons
+                 *
+                 * @return decimation state
+                 */
+                virtual bool get_decimation();
+
+                /** Enable decimation of dense polygons and polylines passed to fill_poly(),
+                 * wire_poly(), draw_poly() and draw_polylines(): each run of points within
+                 * the same pixel column is reduced to the first, the lowest, the highest and
+                 * the last point, which preserves the visual envelope of the curve. The state
+                 * is reset by begin()
+                 *
+                 * @param enable new decimation state
+                 * @return previous decimation state
+                 */
+                virtual bool set_decimation(bool enable);
+
                 /** Get line cap
                  *
                  * @return line cap
@@ -896,6 +1051,13 @@ namespace lsp
                  * End direct access to the surface
                  */
                 virtual     void end_direct();
+
+                /**
+                 * End direct access to the surface and mark only the modified area as dirty
+                 * @param dirty the modified area in coordinates of the buffer returned by
+                 *   start_direct(), NULL means the whole surface
+                 */
+                virtual     void end_direct(const rectangle_t *dirty);
         };
     }
 
@@ -353,6 +353,13 @@ namespace lsp
                  */
                 virtual status_t set_icon(const void *bgra, size_t width, size_t height);
 
+                /** Set window icon from the icon set of the display
+                 *
+                 * @param icon icon set created by the display, the window does not keep the reference
+                 * @return status of operation
+                 */
+                virtual status_t set_icon(const IIconSet *icon);
+
                 /** Get bitmask of allowed window actions
                  *
                  * @param actions pointer to store action mask
@@ -410,6 +417,43 @@ namespace lsp
                  * @return status of operation
                  */
                 virtual status_t set_role(const char *wrole);
+
+                /**
+                 * Release the drawing surface of the hidden window and all memory associated
+                 * with it. The surface is created again when the window becomes visible.
+                 * Useful for windows that are not expected to be shown for a long time.
+                 * @return status of operation
+                 */
+                virtual status_t release_surface();
+
+                /**
+                 * Set buffering mode of the window drawing surface
+                 * @param mode buffering mode
+                 * @return status of operation
+                 */
+                virtual status_t set_buffering(buffering_t mode);
+
+                /**
+                 * Get buffering mode of the window drawing surface
+                 * @return buffering mode
+                 */
+                virtual buffering_t get_buffering();
+
+                /**
+                 * Begin the batch update of the window. Until the matching commit_update()
+                 * call, changes of caption, class, role, border style, window actions
+                 * and geometry are only staged and not sent to the window system.
+                 * Calls may be nested, the changes are applied by the outermost commit.
+                 * @return status of operation
+                 */
+                virtual status_t begin_update();
+
+                /**
+                 * Apply all changes staged since the matching begin_update() call
+                 * with a minimum possible number of requests to the window system
+                 * @return status of operation
+                 */
+                virtual status_t commit_update();
         };
     } /* namespace ws */
 } /* namespace lsp */
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_WS_PROXYGRADIENT_H_
+#define LSP_PLUG_IN_WS_PROXYGRADIENT_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/ws/IGradient.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        /**
+         * Gradient created by the recording surface, just stores its parameters
+         * and color stops for further replay
+         */
+        class ProxyGradient: public IGradient
+        {
+            public:
+                enum gradient_type_t
+                {
+                    GR_LINEAR,
+                    GR_RADIAL
+                };
+
+                typedef struct stop_t
+                {
+                    float       fOffset;
+                    float       fRed;
+                    float       fGreen;
+                    float       fBlue;
+                    float       fAlpha;
+                } stop_t;
+
+            private:
+                ProxyGradient & operator = (const ProxyGradient &);
+                ProxyGradient(const ProxyGradient &);
+
+            protected:
+                gradient_type_t         enType;
+                float                   vParams[6];
+                lltl::darray<stop_t>    vStops;
+
+            public:
+                explicit ProxyGradient(float x0, float y0, float x1, float y1);
+                explicit ProxyGradient(float cx0, float cy0, float r0, float cx1, float cy1, float r1);
+                virtual ~ProxyGradient();
+
+            public:
+                virtual void add_color(float offset, float r, float g, float b, float a);
+
+            public:
+                inline gradient_type_t  type() const            { return enType;                }
+                inline const float     *params() const          { return vParams;               }
+                inline size_t           stops() const           { return vStops.size();         }
+                inline const stop_t    *stop(size_t index) const { return vStops.uget(index);   }
+        };
+    }
+}
+
+#endif /* LSP_PLUG_IN_WS_PROXYGRADIENT_H_ */
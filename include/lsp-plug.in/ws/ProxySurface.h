@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_WS_PROXYSURFACE_H_
+#define LSP_PLUG_IN_WS_PROXYSURFACE_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/ws/ISurface.h>
+#include <lsp-plug.in/ws/ProxyGradient.h>
+#include <lsp-plug.in/lltl/parray.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        /**
+         * Recording surface of ST_PROXY type. Serializes all drawing calls into the
+         * command buffer which can be replayed later onto any other surface.
+         * Surfaces passed to draw() methods and paths are stored by reference and should
+         * stay alive until the recorded commands are replayed or discarded. Gradients
+         * should be created by the proxy surface itself.
+         */
+        class ProxySurface: public ISurface
+        {
+            private:
+                ProxySurface & operator = (const ProxySurface &);
+                ProxySurface(const ProxySurface &);
+
+                friend class TiledRasterizer;
+
+            protected:
+                enum command_code_t
+                {
+                    CMD_DRAW,
+                    CMD_DRAW_SCALED,
+                    CMD_DRAW_FILTERED,
+                    CMD_DRAW_ALPHA,
+                    CMD_DRAW_ROTATE_ALPHA,
+                    CMD_DRAW_CLIPPED,
+                    CMD_DRAW_MASK,
+                    CMD_FILL_RECT,
+                    CMD_FILL_RECT_GRADIENT,
+                    CMD_WIRE_RECT,
+                    CMD_WIRE_RECT_GRADIENT,
+                    CMD_WIRE_ROUND_RECT,
+                    CMD_WIRE_ROUND_RECT_GRADIENT,
+                    CMD_WIRE_ROUND_RECT_INSIDE,
+                    CMD_WIRE_ROUND_RECT_INSIDE_GRADIENT,
+                    CMD_FILL_ROUND_RECT,
+                    CMD_FILL_ROUND_RECT_AREA,
+                    CMD_FILL_ROUND_RECT_GRADIENT,
+                    CMD_FILL_ROUND_RECT_AREA_GRADIENT,
+                    CMD_FULL_RECT,
+                    CMD_FILL_SECTOR,
+                    CMD_FILL_TRIANGLE,
+                    CMD_FILL_TRIANGLE_GRADIENT,
+                    CMD_CLEAR,
+                    CMD_CLEAR_RGB,
+                    CMD_CLEAR_RGBA,
+                    CMD_OUT_TEXT,
+                    CMD_OUT_TEXT_RELATIVE,
+                    CMD_SQUARE_DOT,
+                    CMD_SQUARE_DOT_RGBA,
+                    CMD_LINE,
+                    CMD_LINE_GRADIENT,
+                    CMD_DRAW_LINES,
+                    CMD_DRAW_POLYLINES,
+                    CMD_PARAMETRIC_LINE,
+                    CMD_PARAMETRIC_LINE_CLIPPED,
+                    CMD_PARAMETRIC_BAR,
+                    CMD_WIRE_ARC,
+                    CMD_FILL_FRAME,
+                    CMD_FILL_ROUND_FRAME,
+                    CMD_FILL_POLY,
+                    CMD_FILL_POLY_GRADIENT,
+                    CMD_WIRE_POLY,
+                    CMD_DRAW_POLY,
+                    CMD_FILL_PATH,
+                    CMD_FILL_PATH_GRADIENT,
+                    CMD_WIRE_PATH,
+                    CMD_FILL_CIRCLE,
+                    CMD_FILL_CIRCLE_GRADIENT,
+                    CMD_CLIP_BEGIN,
+                    CMD_CLIP_END,
+                    CMD_SET_ANTIALIASING,
+                    CMD_SET_LINE_CAP,
+                    CMD_SET_DECIMATION
+                };
+
+                /**
+                 * Command header, followed by float arguments and the payload
+                 */
+                typedef struct command_t
+                {
+                    uint16_t            nCode;          // Command code
+                    uint16_t            nArgs;          // Number of float arguments
+                    uint32_t            nSize;          // Overall size of the command in bytes
+                    uint32_t            nParam;         // Integer parameter: mask, flags, number of points
+                    uint32_t            nPayload;       // Offset of the payload from the beginning of the command
+                    float               fLeft;          // Conservative bounds of the affected area
+                    float               fTop;
+                    float               fRight;
+                    float               fBottom;
+                } command_t;
+
+                /**
+                 * Memory chunk of the command buffer
+                 */
+                typedef struct chunk_t
+                {
+                    chunk_t            *pNext;          // Next chunk
+                    size_t              nSize;          // Number of used bytes
+                    size_t              nCapacity;      // Overall capacity of the chunk
+                } chunk_t;
+
+                /**
+                 * Drawing state of the target surface saved for replay
+                 */
+                typedef struct replay_t
+                {
+                    bool                bAntiAliasing;  // Anti-aliasing state
+                    surf_line_cap_t     enLineCap;      // Line cap
+                    bool                bDecimation;    // Decimation state
+                    size_t              nClips;         // Number of active clipping regions
+                } replay_t;
+
+                /**
+                 * Serialized gradient, followed by color stops
+                 */
+                typedef struct gradient_t
+                {
+                    uint32_t            nType;          // Gradient type
+                    uint32_t            nStops;         // Number of color stops
+                    float               vParams[6];     // Gradient parameters
+                } gradient_t;
+
+            protected:
+                ISurface               *pRef;           // Reference surface for font metrics
+                chunk_t                *pFirst;         // First chunk of the command buffer
+                chunk_t                *pCurr;          // Current chunk of the command buffer
+                size_t                  nCommands;      // Number of recorded commands
+                lltl::parray<Font>      vFonts;         // Fonts used by recorded commands
+                bool                    bAntiAliasing;  // Current anti-aliasing state
+                surf_line_cap_t         enLineCap;      // Current line cap
+                bool                    bDecimation;    // Current decimation state
+
+            protected:
+                static inline float    *cmd_args(command_t *cmd)        { return reinterpret_cast<float *>(&cmd[1]);                                }
+                static inline uint8_t  *cmd_payload(command_t *cmd)     { return &reinterpret_cast<uint8_t *>(cmd)[cmd->nPayload];                  }
+                static inline const float *cmd_args(const command_t *cmd)       { return reinterpret_cast<const float *>(&cmd[1]);                  }
+                static inline const uint8_t *cmd_payload(const command_t *cmd)  { return &reinterpret_cast<const uint8_t *>(cmd)[cmd->nPayload];    }
+
+                void                    do_destroy();
+                void                    reset();
+                void                   *alloc(size_t bytes);
+                command_t              *add_command(size_t code, size_t args, size_t payload);
+                float                  *add_args(size_t code, size_t args);
+                ssize_t                 add_font(const Font &f);
+
+                static float           *put_color(float *dst, const Color &c);
+                static size_t           gradient_size(IGradient *g);
+                static void             put_gradient(uint8_t *dst, IGradient *g);
+                static void             put_surface(uint8_t *dst, ISurface *s);
+                static void             put_path(uint8_t *dst, IPath *path);
+                static void             set_bounds(command_t *cmd, float left, float top, float right, float bottom);
+                static void             set_rect_bounds(command_t *cmd, const float *rect, float border);
+                static void             update_bounds(command_t *cmd);
+
+                void                    record_text(size_t code, const Font &f, const Color &color, float x, float y, float dx, float dy, const char *text);
+                void                    record_poly(size_t code, const Color *c1, const Color *c2, IGradient *g, float width, const float *x, const float *y, size_t n);
+                void                    record_draw(size_t code, ISurface *s, const float *args, size_t n);
+                void                    record_path(size_t code, const Color *c, IGradient *g, float width, IPath *path, float x, float y);
+                void                    record_gradient(size_t code, IGradient *g, size_t param, const float *args, size_t n);
+                void                    record_color(size_t code, const Color &c, size_t param, const float *args, size_t n);
+
+                static Color            get_color(const float *src);
+                static IGradient       *get_gradient(ISurface *dst, const uint8_t *src);
+                static ISurface        *get_surface(const uint8_t *src);
+                static IPath           *get_path(const uint8_t *src);
+                static void             start_replay(ISurface *dst, replay_t *state);
+                static void             finish_replay(ISurface *dst, replay_t *state);
+                void                    replay_command(ISurface *dst, replay_t *state, const command_t *cmd);
+                void                    replay(ISurface *dst, const command_t * const *list, size_t count);
+                bool                    list_commands(lltl::parray<command_t> *list);
+
+            public:
+                /**
+                 * Create recording surface
+                 *
+                 * @param ref reference surface used for computing font and text parameters, may be NULL
+                 * @param width surface width
+                 * @param height surface height
+                 */
+                explicit ProxySurface(ISurface *ref, size_t width, size_t height);
+                virtual ~ProxySurface();
+
+            public:
+                /**
+                 * Get number of recorded commands
+                 * @return number of recorded commands
+                 */
+                inline size_t           commands() const                { return nCommands;     }
+
+                /**
+                 * Replay all recorded commands onto the target surface. The target surface
+                 * should be prepared for drawing by the begin() call
+                 *
+                 * @param dst target surface
+                 */
+                void                    replay(ISurface *dst);
+
+                /**
+                 * Discard all recorded commands but keep the allocated memory for further use
+                 */
+                void                    clear_commands();
+
+            public:
+                virtual ISurface       *create(size_t width, size_t height);
+                virtual ISurface       *create(size_t width, size_t height, surface_format_t format);
+                virtual ISurface       *create_copy();
+
+                virtual IGradient      *linear_gradient(float x0, float y0, float x1, float y1);
+                virtual IGradient      *radial_gradient(float cx0, float cy0, float r0, float cx1, float cy1, float r1);
+                virtual IPath          *create_path();
+
+                virtual void            destroy();
+
+                virtual void            begin();
+                virtual void            end();
+
+                virtual void            draw(ISurface *s, float x, float y);
+                virtual void            draw(ISurface *s, float x, float y, float sx, float sy);
+                virtual void            draw(ISurface *s, float x, float y, float sx, float sy, surface_filter_t filter);
+                virtual void            draw_alpha(ISurface *s, float x, float y, float sx, float sy, float a);
+                virtual void            draw_rotate_alpha(ISurface *s, float x, float y, float sx, float sy, float ra, float a);
+                virtual void            draw_clipped(ISurface *s, float x, float y, float sx, float sy, float sw, float sh);
+                virtual void            draw_mask(const Color &color, ISurface *mask, float x, float y);
+
+                virtual void            fill_rect(const Color &color, float left, float top, float width, float height);
+                virtual void            fill_rect(IGradient *g, float left, float top, float width, float height);
+
+                virtual void            wire_rect(const Color &color, float left, float top, float width, float height, float line_width);
+                virtual void            wire_rect(IGradient *g, float left, float top, float width, float height, float line_width);
+
+                virtual void            wire_round_rect(const Color &c, size_t mask, float radius, float left, float top, float width, float height, float line_width);
+                virtual void            wire_round_rect(IGradient *g, size_t mask, float radius, float left, float top, float width, float height, float line_width);
+
+                virtual void            wire_round_rect_inside(const Color &c, size_t mask, float radius, float left, float top, float width, float height, float line_width);
+                virtual void            wire_round_rect_inside(IGradient *g, size_t mask, float radius, float left, float top, float width, float height, float line_width);
+
+                virtual void            fill_round_rect(const Color &color, size_t mask, float radius, float left, float top, float width, float height);
+                virtual void            fill_round_rect(const Color &color, size_t mask, float radius, const ws::rectangle_t *r);
+                virtual void            fill_round_rect(IGradient *g, size_t mask, float radius, float left, float top, float width, float height);
+                virtual void            fill_round_rect(IGradient *g, size_t mask, float radius, const ws::rectangle_t *r);
+
+                virtual void            full_rect(float left, float top, float width, float height, float line_width, const Color &color);
+
+                virtual void            fill_sector(float cx, float cy, float radius, float angle1, float angle2, const Color &color);
+
+                virtual void            fill_triangle(float x0, float y0, float x1, float y1, float x2, float y2, IGradient *g);
+                virtual void            fill_triangle(float x0, float y0, float x1, float y1, float x2, float y2, const Color &color);
+
+                virtual bool            get_font_parameters(const Font &f, font_parameters_t *fp);
+                virtual bool            get_text_parameters(const Font &f, text_parameters_t *tp, const char *text);
+                virtual bool            get_text_parameters(const Font &f, text_parameters_t *tp, const LSPString *text, ssize_t first, ssize_t last);
+
+                virtual void            clear(const Color &color);
+                virtual void            clear_rgb(uint32_t color);
+                virtual void            clear_rgba(uint32_t color);
+
+                virtual void            out_text(const Font &f, const Color &color, float x, float y, const char *text);
+                virtual void            out_text(const Font &f, const Color &color, float x, float y, const LSPString *text, ssize_t first, ssize_t last);
+                virtual void            out_text_relative(const Font &f, const Color &color, float x, float y, float dx, float dy, const char *text);
+                virtual void            out_text_relative(const Font &f, const Color &color, float x, float y, float dx, float dy, const LSPString *text, ssize_t first, ssize_t last);
+
+                virtual void            square_dot(float x, float y, float width, const Color &color);
+                virtual void            square_dot(float x, float y, float width, float r, float g, float b, float a);
+
+                virtual void            line(float x0, float y0, float x1, float y1, float width, const Color &color);
+                virtual void            line(float x0, float y0, float x1, float y1, float width, IGradient *g);
+                virtual void            draw_lines(const float *x0, const float *y0, const float *x1, const float *y1, size_t n, float width, const Color &color);
+                virtual void            draw_polylines(const float *x, const float *y, const size_t *count, size_t n, float width, const Color &color);
+
+                virtual void            parametric_line(float a, float b, float c, float width, const Color &color);
+                virtual void            parametric_line(float a, float b, float c, float left, float right, float top, float bottom, float width, const Color &color);
+                virtual void            parametric_bar(float a1, float b1, float c1, float a2, float b2, float c2,
+                                            float left, float right, float top, float bottom, IGradient *gr);
+
+                virtual void            wire_arc(float x, float y, float r, float a1, float a2, float width, const Color &color);
+
+                virtual void            fill_frame(const Color &color,
+                                            float fx, float fy, float fw, float fh,
+                                            float ix, float iy, float iw, float ih);
+                virtual void            fill_round_frame(const Color &color, float radius, size_t flags,
+                                            float fx, float fy, float fw, float fh,
+                                            float ix, float iy, float iw, float ih);
+
+                virtual void            fill_poly(const Color & color, const float *x, const float *y, size_t n);
+                virtual void            fill_poly(IGradient *gr, const float *x, const float *y, size_t n);
+                virtual void            wire_poly(const Color & color, float width, const float *x, const float *y, size_t n);
+                virtual void            draw_poly(const Color &fill, const Color &wire, float width, const float *x, const float *y, size_t n);
+                virtual void            fill_path(const Color &color, IPath *path, float x, float y);
+                virtual void            fill_path(IGradient *g, IPath *path, float x, float y);
+                virtual void            wire_path(const Color &color, float width, IPath *path, float x, float y);
+
+                virtual void            fill_circle(float x, float y, float r, const Color & color);
+                virtual void            fill_circle(float x, float y, float r, IGradient *g);
+
+                virtual void            clip_begin(float x, float y, float w, float h);
+                virtual void            clip_end();
+
+                virtual bool            get_antialiasing();
+                virtual bool            set_antialiasing(bool set);
+                virtual bool            get_decimation();
+                virtual bool            set_decimation(bool enable);
+                virtual surf_line_cap_t get_line_cap();
+                virtual surf_line_cap_t set_line_cap(surf_line_cap_t lc);
+        };
+    }
+}
+
+#endif /* LSP_PLUG_IN_WS_PROXYSURFACE_H_ */
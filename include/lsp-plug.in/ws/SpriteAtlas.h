@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_WS_SPRITEATLAS_H_
+#define LSP_PLUG_IN_WS_SPRITEATLAS_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/ws/ISurface.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/lltl/parray.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        class IDisplay;
+
+        /**
+         * Handle of the image packed into the sprite atlas
+         */
+        typedef struct sprite_t
+        {
+            size_t              nPage;          // Index of the atlas page
+            ssize_t             nLeft;          // Position of the image on the page
+            ssize_t             nTop;
+            ssize_t             nWidth;         // Size of the image
+            ssize_t             nHeight;
+        } sprite_t;
+
+        /**
+         * Sprite atlas packs small images like icons, knob frames and LEDs into large
+         * shared image surfaces (pages) with the skyline packer. Sprites placed on the
+         * same page are drawn from one source surface by the single draw_batch() call.
+         * The atlas should be destroyed before the display which created it
+         */
+        class SpriteAtlas
+        {
+            private:
+                SpriteAtlas & operator = (const SpriteAtlas &);
+                SpriteAtlas(const SpriteAtlas &);
+
+            protected:
+                typedef struct skyline_t
+                {
+                    ssize_t                     nLeft;          // Horizontal position of the segment
+                    ssize_t                     nTop;           // Height of the skyline
+                    ssize_t                     nWidth;         // Width of the segment
+                } skyline_t;
+
+                typedef struct page_t
+                {
+                    ISurface                   *pSurface;       // Image surface of the page
+                    lltl::darray<skyline_t>     vSkyline;       // Skyline of packed images
+                } page_t;
+
+            protected:
+                IDisplay                       *pDisplay;
+                size_t                          nPageWidth;
+                size_t                          nPageHeight;
+                size_t                          nPadding;
+                lltl::parray<page_t>            vPages;
+                lltl::darray<surface_blit_t>    vBatch;
+
+            protected:
+                bool                            pack(page_t *page, ssize_t width, ssize_t height, ssize_t *left, ssize_t *top);
+                page_t                         *create_page();
+
+            public:
+                explicit SpriteAtlas(IDisplay *dpy, size_t width, size_t height);
+                ~SpriteAtlas();
+
+            public:
+                /**
+                 * Get width of the atlas page
+                 * @return width of the atlas page
+                 */
+                inline size_t                   page_width() const  { return nPageWidth;    }
+
+                /**
+                 * Get height of the atlas page
+                 * @return height of the atlas page
+                 */
+                inline size_t                   page_height() const { return nPageHeight;   }
+
+                /**
+                 * Get number of atlas pages
+                 * @return number of atlas pages
+                 */
+                inline size_t                   pages() const       { return vPages.size(); }
+
+                /**
+                 * Get surface of the atlas page
+                 * @param index index of the page
+                 * @return surface of the page or NULL if index is invalid
+                 */
+                ISurface                       *page(size_t index);
+
+                /**
+                 * Copy the image into the atlas
+                 * @param image image to add, may be deleted by the caller after the call
+                 * @param sprite pointer to store the handle of the sprite
+                 * @return status of operation, STATUS_TOO_BIG if the image does not fit the page
+                 */
+                status_t                        add(ISurface *image, sprite_t *sprite);
+
+                /**
+                 * Draw the sprite
+                 * @param dst target surface
+                 * @param sprite sprite to draw
+                 * @param x position to draw at
+                 * @param y position to draw at
+                 */
+                void                            draw(ISurface *dst, const sprite_t *sprite, float x, float y);
+
+                /**
+                 * Draw multiple sprites, the sequences of sprites placed on the same page
+                 * are drawn by the single call
+                 * @param dst target surface
+                 * @param sprites list of sprites to draw
+                 * @param x list of horizontal positions
+                 * @param y list of vertical positions
+                 * @param n number of sprites
+                 */
+                void                            draw(ISurface *dst, const sprite_t *sprites, const float *x, const float *y, size_t n);
+
+                /**
+                 * Remove all sprites and destroy atlas pages
+                 */
+                void                            clear();
+        };
+    }
+}
+
+#endif /* LSP_PLUG_IN_WS_SPRITEATLAS_H_ */
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_WS_TILEDRASTERIZER_H_
+#define LSP_PLUG_IN_WS_TILEDRASTERIZER_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/ws/ProxySurface.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        /**
+         * Rasterizer which splits the target image surface into tiles and replays
+         * the recorded frame of the proxy surface on multiple threads, each tile
+         * is drawn on the view of the target surface and receives only commands
+         * which affect the tile
+         */
+        class TiledRasterizer
+        {
+            private:
+                TiledRasterizer & operator = (const TiledRasterizer &);
+                TiledRasterizer(const TiledRasterizer &);
+
+            protected:
+                typedef struct tile_t
+                {
+                    ISurface               *pView;          // View of the target surface
+                    ssize_t                 nLeft;          // Area of the tile
+                    ssize_t                 nTop;
+                    ssize_t                 nRight;
+                    ssize_t                 nBottom;
+                    size_t                  nFirst;         // Index of the first command in the bin list
+                    size_t                  nCount;         // Number of commands in the bin list
+                } tile_t;
+
+                class Worker: public ipc::Thread
+                {
+                    private:
+                        TiledRasterizer    *pRasterizer;
+
+                    public:
+                        explicit Worker(TiledRasterizer *rasterizer);
+                        virtual ~Worker();
+
+                    public:
+                        virtual status_t    run();
+                };
+
+                typedef ProxySurface::command_t     command_t;
+
+            protected:
+                size_t                      nThreads;       // Number of threads including the caller thread
+                size_t                      nTileSize;      // Size of the tile
+                size_t                      nCols;          // Number of tile columns
+                size_t                      nRows;          // Number of tile rows
+                ProxySurface               *pSource;        // Currently rendered frame
+                atomic_t                    nNextTile;      // Index of the next tile to process
+                lltl::darray<tile_t>        vTiles;         // List of tiles
+                lltl::darray<command_t *>   vBins;          // Commands binned by tiles
+
+            protected:
+                bool                        create_tiles(ISurface *dst);
+                bool                        bin_commands();
+                void                        destroy_tiles();
+                void                        process_tiles();
+
+            public:
+                explicit TiledRasterizer();
+                ~TiledRasterizer();
+
+            public:
+                /**
+                 * Get number of threads used for rendering
+                 * @return number of threads
+                 */
+                inline size_t               threads() const     { return nThreads;      }
+
+                /**
+                 * Get size of the tile
+                 * @return size of the tile in pixels
+                 */
+                inline size_t               tile_size() const   { return nTileSize;     }
+
+                /**
+                 * Set number of threads used for rendering, including the caller thread
+                 * @param threads number of threads, zero means number of CPU cores
+                 * @return status of operation
+                 */
+                status_t                    set_threads(size_t threads);
+
+                /**
+                 * Set size of the tile
+                 * @param size size of the tile in pixels
+                 * @return status of operation
+                 */
+                status_t                    set_tile_size(size_t size);
+
+                /**
+                 * Render recorded frame onto the target surface. The target surface should be
+                 * prepared for drawing by the begin() call. If the target surface does not
+                 * support views, the frame is replayed on the caller thread
+                 *
+                 * @param dst target surface
+                 * @param src recorded frame
+                 * @return status of operation
+                 */
+                status_t                    render(ISurface *dst, ProxySurface *src);
+        };
+    }
+}
+
+#endif /* LSP_PLUG_IN_WS_TILEDRASTERIZER_H_ */
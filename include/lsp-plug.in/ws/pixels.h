@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_WS_PIXELS_H_
+#define LSP_PLUG_IN_WS_PIXELS_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/runtime/Color.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        /**
+         * Pixel processing kernels for the buffers returned by ISurface::start_direct().
+         * All kernels operate on the rectangular region of 32-bit premultiplied ARGB pixels
+         * stored in the native byte order: the region is defined by the pointer to the
+         * top-left pixel, the stride between rows in bytes, the width and the height
+         */
+        namespace pixels
+        {
+            /** Compute premultiplied ARGB32 pixel for the color, the rounding matches the one
+             * of cairo for the solid source pattern
+             *
+             * @param c color, the alpha component of the color is transparency
+             * @return premultiplied pixel
+             */
+            uint32_t    pixel(const Color &c);
+
+            /** Compute premultiplied ARGB32 pixel for the color, the rounding matches the one
+             * of cairo for the solid source pattern
+             *
+             * @param r red component
+             * @param g green component
+             * @param b blue component
+             * @param a transparency, 0 means opaque color
+             * @return premultiplied pixel
+             */
+            uint32_t    pixel(float r, float g, float b, float a);
+
+            /** Fill the region with the pixel value
+             *
+             * @param dst pointer to the top-left pixel of the region
+             * @param stride stride between rows in bytes
+             * @param width width of the region
+             * @param height height of the region
+             * @param pixel premultiplied pixel value
+             */
+            void        fill(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel);
+
+            /** Blend the pixel value over the region using the OVER operator
+             *
+             * @param dst pointer to the top-left pixel of the region
+             * @param stride stride between rows in bytes
+             * @param width width of the region
+             * @param height height of the region
+             * @param pixel premultiplied pixel value
+             */
+            void        blend_fill(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel);
+
+            /** Copy the region of RGB24 pixels to the region of ARGB32 pixels, the alpha
+             * component of the destination pixels is set to 0xff
+             *
+             * @param dst pointer to the top-left pixel of the destination region
+             * @param stride stride between rows of the destination region in bytes
+             * @param src pointer to the top-left pixel of the source region
+             * @param src_stride stride between rows of the source region in bytes
+             * @param width width of the region
+             * @param height height of the region
+             */
+            void        copy_opaque(void *dst, size_t stride, const void *src, size_t src_stride,
+                            size_t width, size_t height);
+
+            /** Widen the region of ARGB32 pixels to the region of 'unsigned long' values, the
+             * layout used by 32-bit properties of the X Window System
+             *
+             * @param dst pointer to the top-left value of the destination region
+             * @param stride stride between rows of the destination region in bytes
+             * @param src pointer to the top-left pixel of the source region
+             * @param src_stride stride between rows of the source region in bytes
+             * @param width width of the region
+             * @param height height of the region
+             */
+            void        widen(void *dst, size_t stride, const void *src, size_t src_stride,
+                            size_t width, size_t height);
+
+            /** Convert straight ARGB32 pixels of the region to premultiplied form
+             *
+             * @param dst pointer to the top-left pixel of the region
+             * @param stride stride between rows in bytes
+             * @param width width of the region
+             * @param height height of the region
+             */
+            void        premultiply(void *dst, size_t stride, size_t width, size_t height);
+
+            /** Convert premultiplied ARGB32 pixels of the region to straight form
+             *
+             * @param dst pointer to the top-left pixel of the region
+             * @param stride stride between rows in bytes
+             * @param width width of the region
+             * @param height height of the region
+             */
+            void        unpremultiply(void *dst, size_t stride, size_t width, size_t height);
+
+            /** Map the values of the float buffer onto the region using the colormap: the range
+             * [min, max] is split into equal parts, one per each entry of the colormap. Values out
+             * of range are mapped to the first and last entries of the colormap, NaN values are
+             * mapped to the first entry
+             *
+             * @param dst pointer to the top-left pixel of the region
+             * @param stride stride between rows in bytes
+             * @param src pointer to the first value of the source buffer
+             * @param src_stride stride between rows of the source buffer in elements
+             * @param width width of the region
+             * @param height height of the region
+             * @param lut colormap of premultiplied pixels
+             * @param n number of entries in the colormap, should be positive
+             * @param min value mapped to the first entry of the colormap
+             * @param max value mapped to the last entry of the colormap
+             */
+            void        colormap(void *dst, size_t stride, const float *src, size_t src_stride,
+                            size_t width, size_t height, const uint32_t *lut, size_t n, float min, float max);
+
+            /** Blend the source region over the destination region using the OVER operator,
+             * the rounding matches the one of pixman
+             *
+             * @param dst pointer to the top-left pixel of the destination region
+             * @param stride stride between rows of the destination region in bytes
+             * @param src pointer to the top-left pixel of the source region
+             * @param src_stride stride between rows of the source region in bytes
+             * @param width width of the region
+             * @param height height of the region
+             * @param a additional transparency of the source, 0 means unchanged source
+             */
+            void        blend(void *dst, size_t stride, const void *src, size_t src_stride,
+                            size_t width, size_t height, float a = 0.0f);
+
+            /** Apply box blur to the region, pixels beyond edges of the region are considered
+             * to be equal to the edge pixels. Zero radius disables blurring in the direction,
+             * so the 1D blur is performed if one of the radii is zero
+             *
+             * @param dst pointer to the top-left pixel of the region
+             * @param stride stride between rows in bytes
+             * @param width width of the region
+             * @param height height of the region
+             * @param rx horizontal radius in pixels
+             * @param ry vertical radius in pixels
+             * @return status of operation
+             */
+            status_t    blur(void *dst, size_t stride, size_t width, size_t height, size_t rx, size_t ry);
+
+            /**
+             * Scalar implementations of the kernels, the reference for the vectorized ones
+             */
+            namespace generic
+            {
+                void        fill(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel);
+                void        blend_fill(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel);
+                void        copy_opaque(void *dst, size_t stride, const void *src, size_t src_stride,
+                                size_t width, size_t height);
+                void        widen(void *dst, size_t stride, const void *src, size_t src_stride,
+                                size_t width, size_t height);
+                void        premultiply(void *dst, size_t stride, size_t width, size_t height);
+                void        unpremultiply(void *dst, size_t stride, size_t width, size_t height);
+                void        colormap(void *dst, size_t stride, const float *src, size_t src_stride,
+                                size_t width, size_t height, const uint32_t *lut, size_t n, float min, float max);
+                void        blend(void *dst, size_t stride, const void *src, size_t src_stride,
+                                size_t width, size_t height, float a = 0.0f);
+                status_t    blur(void *dst, size_t stride, size_t width, size_t height, size_t rx, size_t ry);
+            }
+        }
+    }
+}
+
+#endif /* LSP_PLUG_IN_WS_PIXELS_H_ */
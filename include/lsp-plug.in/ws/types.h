@@ -76,6 +76,7 @@ namespace lsp
             MCF_HYPER           = 1 << 16,
             MCF_META            = 1 << 17,
             MCF_RELEASE         = 1 << 18,
+            MCF_REPEAT          = 1 << 19,
 
             MCF_BTN_MASK        = MCF_LEFT | MCF_MIDDLE | MCF_RIGHT | MCF_BUTTON4 | MCF_BUTTON5 | MCF_BUTTON6 | MCF_BUTTON7
         };
@@ -318,6 +319,26 @@ namespace lsp
             ssize_t             nHeight;
         } rectangle_t;
 
+        typedef struct surface_pool_stats_t
+        {
+            size_t              nHits;          // Number of surface requests satisfied by the pool
+            size_t              nMisses;        // Number of surface requests that caused new allocation
+            size_t              nEvictions;     // Number of pooled surfaces destroyed to fit the memory limit
+            size_t              nSurfaces;      // Number of surfaces currently kept by the pool
+            size_t              nBytes;         // Amount of memory currently kept by the pool
+            size_t              nLimit;         // Maximum amount of memory kept by the pool
+        } surface_pool_stats_t;
+
+        typedef struct surface_blit_t
+        {
+            float               fX;             // Destination position
+            float               fY;
+            ssize_t             nLeft;          // Source rectangle
+            ssize_t             nTop;
+            ssize_t             nWidth;
+            ssize_t             nHeight;
+        } surface_blit_t;
+
         enum surface_type_t
         {
             ST_UNKNOWN,
@@ -326,6 +347,37 @@ namespace lsp
             ST_PROXY
         };
 
+        /**
+         * Buffering mode of the window drawing surface
+         */
+        enum buffering_t
+        {
+            BUF_NONE,               // Draw directly on the window
+            BUF_IMAGE,              // Draw into the client-side image, present damaged area at end()
+            BUF_PIXMAP              // Draw into the server-side pixmap, present damaged area at end()
+        };
+
+        /**
+         * Pixel format of the image surface
+         */
+        enum surface_format_t
+        {
+            SFMT_ARGB32,            // 32-bit pixels with premultiplied alpha
+            SFMT_RGB24,             // 32-bit opaque pixels, the upper byte is unused
+            SFMT_A8                 // 8-bit alpha mask
+        };
+
+        /**
+         * Filter hint for drawing of the scaled surface
+         */
+        enum surface_filter_t
+        {
+            SFLT_NEAREST,           // Nearest pixel, no interpolation
+            SFLT_FAST,              // Fast filter with quality similar to nearest
+            SFLT_GOOD,              // Reasonable quality, the default filter
+            SFLT_BEST               // The highest quality, may be slow
+        };
+
         typedef struct font_parameters_t
         {
             float Ascent;       // The distance that the font extends above the baseline
@@ -25,14 +25,21 @@
 #include <lsp-plug.in/ws/version.h>
 #include <lsp-plug.in/ws/types.h>
 #include <lsp-plug.in/ws/keycodes.h>
+#include <lsp-plug.in/ws/pixels.h>
 
 #include <lsp-plug.in/ws/Font.h>
 #include <lsp-plug.in/ws/IGradient.h>
+#include <lsp-plug.in/ws/IIconSet.h>
+#include <lsp-plug.in/ws/IPath.h>
 #include <lsp-plug.in/ws/IDataSink.h>
 #include <lsp-plug.in/ws/IDataSource.h>
 #include <lsp-plug.in/ws/IEventHandler.h>
 
 #include <lsp-plug.in/ws/ISurface.h>
+#include <lsp-plug.in/ws/ProxyGradient.h>
+#include <lsp-plug.in/ws/ProxySurface.h>
+#include <lsp-plug.in/ws/SpriteAtlas.h>
+#include <lsp-plug.in/ws/TiledRasterizer.h>
 #include <lsp-plug.in/ws/IDisplay.h>
 #include <lsp-plug.in/ws/IWindow.h>
 #include <lsp-plug.in/ws/IR3DBackend.h>
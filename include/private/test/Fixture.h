@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_TEST_FIXTURE_H_
+#define PRIVATE_TEST_FIXTURE_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/ws/IDisplay.h>
+#include <lsp-plug.in/ws/ISurface.h>
+#include <lsp-plug.in/ws/IWindow.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/lltl/parray.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace test
+        {
+            /** Get current time in milliseconds
+             *
+             * @return current time in milliseconds
+             */
+            double time_ms();
+
+            /** Compare pixels of two image surfaces of the same size
+             *
+             * @param a first surface
+             * @param b second surface
+             * @return true if both surfaces contain the same pixels
+             */
+            bool same_pixels(ISurface *a, ISurface *b);
+
+            /**
+             * Display with the set of surfaces and windows used by manual tests,
+             * all objects are destroyed together with the fixture
+             */
+            class Fixture
+            {
+                private:
+                    Fixture & operator = (const Fixture &);
+                    Fixture(const Fixture &);
+
+                private:
+                    IDisplay                   *pDisplay;
+                    lltl::parray<ISurface>      vSurfaces;
+                    lltl::parray<IWindow>       vWindows;
+
+                public:
+                    Fixture();
+                    ~Fixture();
+
+                    /** Create the display
+                     *
+                     * @return status of operation
+                     */
+                    status_t            init();
+
+                    /** Destroy all windows, surfaces and the display
+                     *
+                     */
+                    void                destroy();
+
+                public:
+                    /** Get the display
+                     *
+                     * @return the display
+                     */
+                    inline IDisplay    *display()           { return pDisplay; }
+
+                    /** Create image surface owned by the fixture
+                     *
+                     * @param width width of the surface
+                     * @param height height of the surface
+                     * @return pointer to surface or NULL on error
+                     */
+                    ISurface           *create_surface(size_t width, size_t height);
+
+                    /** Create image surface of specified format owned by the fixture
+                     *
+                     * @param width width of the surface
+                     * @param height height of the surface
+                     * @param format pixel format of the surface
+                     * @return pointer to surface or NULL on error
+                     */
+                    ISurface           *create_surface(size_t width, size_t height, surface_format_t format);
+
+                    /** Create and initialize window owned by the fixture
+                     *
+                     * @return pointer to window or NULL on error
+                     */
+                    IWindow            *create_window();
+
+                    /** Create and initialize window of specified border style owned by the fixture
+                     *
+                     * @param style border style of the window
+                     * @return pointer to window or NULL on error
+                     */
+                    IWindow            *create_window(border_style_t style);
+
+                private:
+                    ISurface           *add_surface(ISurface *s);
+                    IWindow            *add_window(IWindow *wnd);
+            };
+        }
+    }
+}
+
+#endif /* PRIVATE_TEST_FIXTURE_H_ */
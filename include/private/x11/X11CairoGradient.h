@@ -28,6 +28,8 @@
 #ifdef USE_LIBCAIRO
 
 #include <lsp-plug.in/ws/IGradient.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <private/x11/X11GradientCache.h>
 #include <cairo/cairo.h>
 
 namespace lsp
@@ -36,13 +38,22 @@ namespace lsp
     {
         namespace x11
         {
+            /**
+             * Gradient records the geometry and the list of color stops, the cairo
+             * pattern is built on the first use and is taken from the gradient cache
+             * of the display if it is available
+             */
             class X11CairoGradient: public IGradient
             {
                 protected:
-                    cairo_pattern_t *pCP;
+                    cairo_pattern_t                *pCP;
+                    X11GradientCache               *pCache;
+                    gradient_type_t                 enType;
+                    float                           vParams[6];
+                    lltl::darray<gradient_stop_t>   vStops;
 
                 public:
-                    explicit X11CairoGradient();
+                    explicit X11CairoGradient(X11GradientCache *cache, gradient_type_t type);
                     virtual ~X11CairoGradient();
 
                 public:
@@ -55,22 +66,14 @@ namespace lsp
             class X11CairoLinearGradient: public X11CairoGradient
             {
                 public:
-                    explicit inline X11CairoLinearGradient(float x0, float y0, float x1, float y1)
-                    {
-                        pCP = ::cairo_pattern_create_linear(x0, y0, x1, y1);
-                    };
-
+                    explicit X11CairoLinearGradient(X11GradientCache *cache, float x0, float y0, float x1, float y1);
                     virtual ~X11CairoLinearGradient();
             };
 
             class X11CairoRadialGradient: public X11CairoGradient
             {
                 public:
-                    explicit inline X11CairoRadialGradient(float cx0, float cy0, float r0, float cx1, float cy1, float r1)
-                    {
-                        pCP = ::cairo_pattern_create_radial(cx0, cy0, r0, cx1, cy1, r1);
-                    };
-
+                    explicit X11CairoRadialGradient(X11GradientCache *cache, float cx0, float cy0, float r0, float cx1, float cy1, float r1);
                     virtual ~X11CairoRadialGradient();
             };
         }
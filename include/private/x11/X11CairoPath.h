@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UI_X11_X11CAIROPATH_H_
+#define UI_X11_X11CAIROPATH_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/common/types.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+
+#include <lsp-plug.in/ws/IPath.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+#include <cairo/cairo.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            /**
+             * Path which records elements as operations and replays them on the cairo
+             * context. Arcs are replayed with cairo_arc(), so the path produces the same
+             * output as the equivalent sequence of calls drawn directly
+             */
+            class X11CairoPath: public IPath
+            {
+                protected:
+                    enum op_type_t
+                    {
+                        OP_MOVE_TO,
+                        OP_LINE_TO,
+                        OP_CURVE_TO,
+                        OP_ARC,
+                        OP_CLOSE
+                    };
+
+                    typedef struct op_t
+                    {
+                        op_type_t               enType;     // Type of operation
+                        float                   vArgs[6];   // Arguments of operation
+                    } op_t;
+
+                protected:
+                    lltl::darray<op_t>      vOps;               // Recorded operations
+                    float                   fStartX;            // Start point of the current sub-path
+                    float                   fStartY;
+                    float                   fLastX;             // Current point
+                    float                   fLastY;
+                    bool                    bCurrent;           // The path has current point
+                    bool                    bBounds;            // The bounding box is initialized
+                    float                   vBounds[4];         // Bounding box: left, top, right, bottom
+
+                protected:
+                    op_t                   *add_op(op_type_t type);
+                    void                    add_bounds(float x, float y);
+
+                public:
+                    explicit X11CairoPath();
+                    virtual ~X11CairoPath();
+
+                public:
+                    virtual status_t        move_to(float x, float y);
+                    virtual status_t        line_to(float x, float y);
+                    virtual status_t        curve_to(float x1, float y1, float x2, float y2, float x3, float y3);
+                    virtual status_t        arc(float cx, float cy, float r, float a1, float a2);
+                    virtual status_t        close();
+                    virtual bool            get_bounds(float *bounds) const;
+                    virtual void            clear();
+
+                public:
+                    /** Check that the path is empty
+                     *
+                     * @return true if the path is empty
+                     */
+                    inline bool             is_empty() const    { return vOps.size() <= 0; }
+
+                    /** Append the path to the current path of the cairo context
+                     *
+                     * @param cr cairo context
+                     * @param x horizontal offset of the path
+                     * @param y vertical offset of the path
+                     */
+                    void                    append(cairo_t *cr, float x, float y);
+            };
+        }
+    }
+}
+
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
+
+#endif /* UI_X11_X11CAIROPATH_H_ */
@@ -24,6 +24,7 @@
 
 #include <lsp-plug.in/ws/version.h>
 #include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/lltl/darray.h>
 
 #include <private/x11/X11Display.h>
 
@@ -32,6 +33,8 @@
 #include <lsp-plug.in/runtime/Color.h>
 #include <lsp-plug.in/ws/IGradient.h>
 #include <lsp-plug.in/ws/ISurface.h>
+#include <private/x11/X11CairoGradient.h>
+#include <private/x11/X11CairoPath.h>
 
 #include <cairo/cairo.h>
 #include <X11/Xlib.h>
@@ -45,10 +48,93 @@ namespace lsp
             class X11CairoSurface: public ISurface
             {
                 protected:
-                    cairo_surface_t        *pSurface;
+                    struct shm_buffer_t;
+
+                    enum damage_t
+                    {
+                        DAMAGE_RECTS    = 16        // Maximum number of rectangles in the damaged region
+                    };
+
+                    enum decimation_t
+                    {
+                        DECIMATION_THRESHOLD    = 64    // Minimum number of points in the decimated polygon
+                    };
+
+                    enum path_cache_t
+                    {
+                        PATH_CACHE_SIZE         = 32    // Maximum number of cached round rectangle paths
+                    };
+
+                    enum capacity_t
+                    {
+                        CAPACITY_GROW_NUM       = 3,    // Numerator of the image capacity growth factor
+                        CAPACITY_GROW_DEN       = 2,    // Denominator of the image capacity growth factor
+                        CAPACITY_SHRINK_RATIO   = 4     // Reallocate the image if it uses less than 1/4 of capacity
+                    };
+
+                    typedef struct cairo_state_t
+                    {
+                        float                   vSource[4]; // Components of the solid source color
+                        bool                    bSource;    // The source is the solid color stored in vSource
+                        double                  fLineWidth; // Line width
+                        cairo_line_cap_t        enLineCap;  // Line cap
+                        cairo_antialias_t       enAntialias;// Antialiasing mode
+                        cairo_operator_t        enOperator; // Compositing operator
+                    } cairo_state_t;
+
+                    typedef struct clip_t
+                    {
+                        ssize_t                 nLeft;      // Left coordinate of the clip in device space
+                        ssize_t                 nTop;       // Top coordinate of the clip in device space
+                        ssize_t                 nRight;     // Right coordinate of the clip in device space
+                        ssize_t                 nBottom;    // Bottom coordinate of the clip in device space
+                        bool                    bAligned;   // The clip is a pixel-aligned rectangle
+                        cairo_state_t           sState;     // Graphics state saved by clip_begin()
+                        cairo_line_cap_t        enLineCap;  // Line cap saved by clip_begin()
+                    } clip_t;
+
+                    typedef struct round_rect_t
+                    {
+                        float                   fWidth;     // Width of the rectangle
+                        float                   fHeight;    // Height of the rectangle
+                        float                   fRadius;    // Corner radius
+                        size_t                  nMask;      // Corner mask
+                        size_t                  nStamp;     // Last use stamp for LRU ordering
+                        X11CairoPath           *pPath;      // Path built at the origin
+                    } round_rect_t;
+
+                    typedef struct direct_fill_t
+                    {
+                        uint8_t                *pData;      // Pixel data, NULL until the first span is drawn
+                        size_t                  nStride;    // Stride of the pixel data
+                        uint32_t                nPixel;     // Premultiplied pixel value
+                        ssize_t                 vClip[4];   // Clip rectangle: left, top, right, bottom
+                        ssize_t                 vDirty[4];  // Modified area: left, top, right, bottom
+                    } direct_fill_t;
+
+                protected:
+                    cairo_surface_t        *pSurface;       // Surface for drawing
+                    cairo_surface_t        *pFront;         // Window surface if drawing into the back buffer
+                    shm_buffer_t           *pShm;           // Shared memory segment of the back buffer
                     cairo_t                *pCR;
                     cairo_font_options_t   *pFO;
                     X11Display             *pDisplay;
+                    buffering_t             enBuffering;    // Buffering mode
+                    ssize_t                 nViewLeft;      // Left coordinate of the view in the parent surface
+                    ssize_t                 nViewTop;       // Top coordinate of the view in the parent surface
+                    bool                    bView;          // The surface is a view of another surface
+                    bool                    bPooled;        // The image is returned to the surface pool on destroy
+                    rectangle_t             vDamage[DAMAGE_RECTS];  // Damaged region of the current frame
+                    size_t                  nDamage;        // Number of rectangles in the damaged region
+                    lltl::darray<clip_t>    vClips;         // Stack of clipping rectangles
+                    cairo_state_t           sState;         // Shadow copy of the cairo graphics state
+                    cairo_line_cap_t        enLineCap;      // Line cap for strokes set by set_line_cap()
+                    bool                    bDecimation;    // Decimation of dense polygons is enabled
+                    lltl::darray<float>     vDecimated;     // Buffer for decimated polygons
+                    lltl::darray<round_rect_t>  vRoundRects;    // Cache of round rectangle paths
+                    size_t                  nPathStamp;     // Current stamp of the path cache
+                    size_t                  nStateCalls;    // Number of issued state changes
+                    size_t                  nStateSkips;    // Number of skipped redundant state changes
 
                 protected:
                     typedef struct font_context_t
@@ -61,12 +147,48 @@ namespace lsp
                 protected:
                     void                destroy_context();
 
+                    void                reset_state();
                     inline void         setSourceRGB(const Color &col);
                     inline void         setSourceRGBA(const Color &col);
+                    void                setSourceRGBA(float r, float g, float b, float a);
+                    void                setSourceGradient(X11CairoGradient *g);
+                    void                setLineWidth(double width);
+                    void                setLineCap(cairo_line_cap_t cap);
+                    void                setAntialias(cairo_antialias_t aa);
+                    void                setOperator(cairo_operator_t op);
                     void                drawRoundRect(float left, float top, float width, float height, float radius, size_t mask);
+                    X11CairoPath       *cached_round_rect(float width, float height, float radius, size_t mask);
+                    void                drop_path_cache();
                     void                set_current_font(font_context_t *ctx, const Font &f);
                     void                unset_current_font(font_context_t *ctx);
 
+                    cairo_surface_t    *create_back_buffer(buffering_t mode, size_t width, size_t height);
+                    void                drop_back_buffer();
+                    bool                resize_image(size_t width, size_t height, bool copy);
+                    cairo_surface_t    *create_shm_buffer(size_t width, size_t height);
+                    void                free_shm_buffer(shm_buffer_t *shm);
+                    bool                present_shm();
+                    void                wait_shm();
+                    void                reset_damage();
+                    void                damage_all();
+                    inline bool         track_damage() const    { return pFront != NULL; }
+                    void                add_stroke_damage();
+                    void                add_damage(double x1, double y1, double x2, double y2);
+                    void                add_device_damage(ssize_t l, ssize_t t, ssize_t r, ssize_t b);
+                    void                add_damage_rect(double x, double y, double w, double h);
+                    bool                direct_fill_begin(direct_fill_t *df, float r, float g, float b, float a);
+                    void                direct_fill_rect(direct_fill_t *df, ssize_t left, ssize_t top, ssize_t width, ssize_t height);
+                    void                direct_fill_end(direct_fill_t *df);
+                    bool                direct_draw(X11CairoSurface *cs, ssize_t x, ssize_t y, ssize_t sx, ssize_t sy, ssize_t sw, ssize_t sh);
+                    void                poly_path(const float *x, const float *y, size_t n);
+                    void                do_fill();
+                    void                do_fill_preserve();
+                    void                do_stroke();
+                    void                do_stroke(cairo_line_cap_t cap);
+                    void                do_stroke_preserve();
+                    void                do_paint();
+                    void                do_show_text(const char *text);
+
                 public:
                     /** Create XLib surface
                      *
@@ -82,8 +204,18 @@ namespace lsp
                      *
                      * @param width surface width
                      * @param height surface height
+                     * @param format pixel format
+                     */
+                    explicit X11CairoSurface(X11Display *dpy, size_t width, size_t height, surface_format_t format);
+
+                    /** Create view of the image surface
+                     *
+                     * @param dpy display
+                     * @param surface image surface which refers the pixel data of the parent surface
+                     * @param left left coordinate of the view in the parent surface
+                     * @param top top coordinate of the view in the parent surface
                      */
-                    explicit X11CairoSurface(X11Display *dpy, size_t width, size_t height);
+                    explicit X11CairoSurface(X11Display *dpy, cairo_surface_t *surface, ssize_t left, ssize_t top);
 
                     /** Destructor
                      *
@@ -91,7 +223,7 @@ namespace lsp
                     virtual ~X11CairoSurface();
 
                 public:
-                    /** resize cairo surface if possible
+                    /** resize cairo surface if possible, the contents of the image surface are kept
                      *
                      * @param width new width
                      * @param height new height
@@ -99,7 +231,51 @@ namespace lsp
                      */
                     bool resize(size_t width, size_t height);
 
+                    /** Resize cairo surface if possible. The image surface is over-allocated by the
+                     * growth factor and becomes the view of the top-left area of the allocated image,
+                     * so shrinking and moderate growth do not cause reallocation and keep the contents
+                     * in place. The area outside of the previous size is cleared. The drawing session
+                     * is ended if active
+                     *
+                     * @param width new width
+                     * @param height new height
+                     * @param copy copy the contents if the image has been reallocated
+                     * @return true on success
+                     */
+                    bool resize(size_t width, size_t height, bool copy);
+
+                    /** Set buffering mode of the XLib surface. In BUF_IMAGE and BUF_PIXMAP modes
+                     * drawing is performed into the back buffer, and the damaged region is presented
+                     * on the window at the end() call
+                     *
+                     * @param mode buffering mode
+                     * @return true on success
+                     */
+                    bool set_buffering(buffering_t mode);
+
+                    /** Get buffering mode of the surface
+                     *
+                     * @return buffering mode
+                     */
+                    inline buffering_t get_buffering() const       { return enBuffering; }
+
+                    /** Get number of cairo graphics state changes issued since the last begin()
+                     *
+                     * @return number of issued state changes
+                     */
+                    inline size_t state_calls() const               { return nStateCalls; }
+
+                    /** Get number of redundant cairo graphics state changes skipped since the last begin()
+                     *
+                     * @return number of skipped state changes
+                     */
+                    inline size_t state_skips() const               { return nStateSkips; }
+
                     virtual ISurface *create(size_t width, size_t height);
+                    virtual ISurface *create(size_t width, size_t height, surface_format_t format);
+                    virtual surface_format_t format() const;
+
+                    virtual ISurface *create_view(ssize_t left, ssize_t top, size_t width, size_t height);
 
                     virtual ISurface *create_copy();
 
@@ -119,16 +295,22 @@ namespace lsp
 
                     virtual void draw(ISurface *s, float x, float y, float sx, float sy);
 
+                    virtual void draw(ISurface *s, float x, float y, float sx, float sy, surface_filter_t filter);
+
                     virtual void draw_alpha(ISurface *s, float x, float y, float sx, float sy, float a);
 
                     virtual void draw_rotate_alpha(ISurface *s, float x, float y, float sx, float sy, float ra, float a);
 
                     virtual void draw_clipped(ISurface *s, float x, float y, float sx, float sy, float sw, float sh);
+                    virtual void draw_batch(ISurface *s, const surface_blit_t *list, size_t count);
+                    virtual void draw_mask(const Color &color, ISurface *mask, float x, float y);
 
                     virtual void begin();
 
                     virtual void end();
 
+                    virtual size_t get_damage(rectangle_t *rects, size_t count);
+
                     virtual void clear_rgb(uint32_t color);
 
                     virtual void clear_rgba(uint32_t color);
@@ -189,6 +371,10 @@ namespace lsp
 
                     virtual void line(float x0, float y0, float x1, float y1, float width, IGradient *g);
 
+                    virtual void draw_lines(const float *x0, const float *y0, const float *x1, const float *y1, size_t n, float width, const Color &color);
+
+                    virtual void draw_polylines(const float *x, const float *y, const size_t *count, size_t n, float width, const Color &color);
+
                     virtual void parametric_line(float a, float b, float c, float width, const Color &color);
 
                     virtual void parametric_line(float a, float b, float c, float left, float right, float top, float bottom, float width, const Color &color);
@@ -204,6 +390,11 @@ namespace lsp
 
                     virtual void wire_poly(const Color & color, float width, const float *x, const float *y, size_t n);
 
+                    virtual IPath *create_path();
+                    virtual void fill_path(const Color &color, IPath *path, float x, float y);
+                    virtual void fill_path(IGradient *g, IPath *path, float x, float y);
+                    virtual void wire_path(const Color &color, float width, IPath *path, float x, float y);
+
                     virtual void draw_poly(const Color &fill, const Color &wire, float width, const float *x, const float *y, size_t n);
 
                     virtual void fill_circle(float x, float y, float r, const Color & color);
@@ -231,6 +422,10 @@ namespace lsp
 
                     virtual bool set_antialiasing(bool set);
 
+                    virtual bool get_decimation();
+
+                    virtual bool set_decimation(bool enable);
+
                     virtual surf_line_cap_t get_line_cap();
 
                     virtual surf_line_cap_t set_line_cap(surf_line_cap_t lc);
@@ -238,6 +433,8 @@ namespace lsp
                     virtual void *start_direct();
 
                     virtual void end_direct();
+
+                    virtual void end_direct(const rectangle_t *dirty);
             };
         }
     }
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UI_X11_X11DECIMATION_H_
+#define UI_X11_X11DECIMATION_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/common/types.h>
+
+#ifdef USE_LIBX11
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            /**
+             * Reference implementations of the decimation routines
+             */
+            namespace generic
+            {
+                size_t      find_run_end(const float *x, size_t i, size_t n, float lo, float hi);
+                void        find_extremes(const float *y, size_t n, size_t *imin, size_t *imax);
+                size_t      decimate_polyline(float *dx, float *dy, const float *x, const float *y, size_t n);
+            }
+
+            /** Find the end of the run of points which fall into the same pixel column
+             *
+             * @param x array of x coordinates
+             * @param i index of the first point to check
+             * @param n number of points
+             * @param lo left boundary of the column, inclusive
+             * @param hi right boundary of the column, exclusive
+             * @return index of the first point outside of the column or n
+             */
+            size_t      find_run_end(const float *x, size_t i, size_t n, float lo, float hi);
+
+            /** Find the first occurrences of the lowest and the highest values
+             *
+             * @param y array of values, should contain at least one element
+             * @param n number of values
+             * @param imin index of the lowest value
+             * @param imax index of the highest value
+             */
+            void        find_extremes(const float *y, size_t n, size_t *imin, size_t *imax);
+
+            /** Decimate the polyline: each run of consecutive points that fall into the same
+             * pixel column is reduced to the first, the lowest, the highest and the last point
+             * of the run, the order of points is preserved
+             *
+             * @param dx destination array of x coordinates, should hold at least n elements
+             * @param dy destination array of y coordinates, should hold at least n elements
+             * @param x source array of x coordinates
+             * @param y source array of y coordinates
+             * @param n number of source points
+             * @return number of points stored in the destination arrays
+             */
+            size_t      decimate_polyline(float *dx, float *dy, const float *x, const float *y, size_t n);
+        }
+    }
+}
+
+#endif /* USE_LIBX11 */
+
+#endif /* UI_X11_X11DECIMATION_H_ */
@@ -34,10 +34,17 @@
 
 #include <private/x11/X11Atoms.h>
 #include <private/x11/X11Window.h>
+#include <private/x11/X11GradientCache.h>
+#include <private/x11/X11SurfacePool.h>
 
 #include <time.h>
 #include <X11/Xlib.h>
 
+// MIT-SHM extension headers
+#ifdef USE_LIBXEXT
+    #include <X11/extensions/XShm.h>
+#endif /* USE_LIBXEXT */
+
 // Freetype headers
 #ifdef USE_LIBFREETYPE
     #include <ft2build.h>
@@ -64,6 +71,7 @@ namespace lsp
 
         #ifdef USE_LIBCAIRO
             class X11CairoSurface;
+            class X11IconSet;
         #endif /* USE_LIBCAIRO */
 
             class X11Display: public IDisplay
@@ -151,6 +159,20 @@ namespace lsp
                         bool                bSuccess;       // Success flag
                     } xtranslate_t;
 
+                    typedef struct x11_pointer_t
+                    {
+                        bool                bValid;         // Pointer is located inside one of our windows
+                        size_t              nScreen;        // Screen the pointer is located at
+                        ssize_t             nLeft;          // Horizontal position relative to the root window
+                        ssize_t             nTop;           // Vertical position relative to the root window
+                    } x11_pointer_t;
+
+                    typedef struct x11_destroyed_t
+                    {
+                        Window              hWindow;        // Handle of the destroyed window
+                        unsigned long       nSerial;        // Serial of the XDestroyWindow request
+                    } x11_destroyed_t;
+
                     typedef struct dnd_proxy_t: public cb_common_t
                     {
                         Window              hTarget;        // The target window which has XDndProxy attribute
@@ -212,6 +234,12 @@ namespace lsp
                     X11Window                  *pFocusWindow;       // Focus window after show
                     int                         nBlackColor;
                     int                         nWhiteColor;
+                    bool                        bXkbRepeat;         // XKB detectable auto-repeat is enabled
+                    uint8_t                     vKeyState[32];      // Bitmap of currently pressed key codes
+                    bool                        bShm;               // MIT-SHM extension is available
+                    volatile bool               bShmError;          // Error on MIT-SHM request has been reported
+                    int                         nShmOpcode;         // Major opcode of the MIT-SHM extension
+                    volatile atomic_t           hFontLock;          // Lock for font faces shared between drawing threads
                     x11_atoms_t                 sAtoms;
                     Cursor                      vCursors[__MP_COUNT];
                     size_t                      nIOBufSize;
@@ -220,11 +248,14 @@ namespace lsp
                     IDataSource                *pCbOwner[_CBUF_TOTAL];
                 #ifdef USE_LIBCAIRO
                     cairo_user_data_key_t       sCairoUserDataKey;
+                    X11SurfacePool              sSurfacePool;       // Pool of released image surfaces
+                    X11GradientCache            sGradientCache;     // Cache of gradient patterns
                 #endif /* USE_LIBCAIRO */
 
                     lltl::darray<dtask_t>       sPending;
                     lltl::darray<x11_screen_t>  vScreens;
                     lltl::parray<X11Window>     vWindows;
+                    lltl::parray<X11IconSet>    vIconSets;
                     lltl::parray<X11Window>     vGrab[__GRAB_TOTAL];
                     lltl::parray<X11Window>     sTargets;
                     lltl::darray<wnd_lock_t>    sLocks;
@@ -232,6 +263,10 @@ namespace lsp
                     lltl::parray<char>          vDndMimeTypes;
                     lltl::pphash<char, font_t>  vCustomFonts;
                     xtranslate_t                sTranslateReq;
+                    x11_pointer_t               sPointer;
+                    size_t                      nPoolSize;          // Number of pooled windows of each style
+                    lltl::parray<X11Window>     vWndPool;           // Pool of pre-initialized unmapped windows
+                    lltl::darray<x11_destroyed_t> vDestroyed;       // Windows destroyed without synchronization
 
                 protected:
                     void            handle_event(XEvent *ev);
@@ -249,6 +284,18 @@ namespace lsp
                     static void     compress_long_data(void *data, size_t nitems);
                     Atom            gen_selection_id();
                     X11Window      *find_window(Window wnd);
+                    bool            is_autorepeat_release(XKeyEvent *ev);
+                    void            track_pointer(Window root, int x, int y, Bool same_screen);
+                    inline void     invalidate_pointer()    { sPointer.bValid = false; }
+
+                    static bool     is_pooled_style(border_style_t style);
+                    size_t          pooled_windows(size_t screen, border_style_t style);
+                    X11Window      *take_pooled_window(size_t screen, border_style_t style);
+                    void            fill_window_pool();
+                    void            trim_window_pool();
+                    bool            is_destroyed(XEvent *ev);
+                    bool            has_ancestor(X11Window *wnd, const Window *list, size_t count);
+                    void            drop_destroyed(unsigned long serial);
                     status_t        bufid_to_atom(size_t bufid, Atom *atom);
                     status_t        atom_to_bufid(Atom x, size_t *bufid);
 
@@ -307,14 +354,24 @@ namespace lsp
                     virtual IWindow            *create_window();
                     virtual IWindow            *create_window(size_t screen);
                     virtual IWindow            *create_window(void *handle);
+                    virtual IWindow            *create_window(border_style_t style);
                     virtual IWindow            *wrap_window(void *handle);
                     virtual ISurface           *create_surface(size_t width, size_t height);
+                    virtual ISurface           *create_surface(size_t width, size_t height, surface_format_t format);
 
                     virtual status_t            main();
                     virtual status_t            main_iteration();
                     virtual void                quit_main();
                     virtual status_t            wait_events(wssize_t millis);
 
+                    virtual status_t            set_window_pool_size(size_t count);
+                    virtual size_t              window_pool_size();
+                    virtual status_t            set_surface_pool_limit(size_t bytes);
+                    virtual size_t              surface_pool_limit();
+                    virtual status_t            get_surface_pool_stats(surface_pool_stats_t *stats);
+                    virtual void                destroy_windows(IWindow * const *list, size_t count);
+                    virtual IIconSet           *create_icon_set();
+
                     virtual size_t              screens();
                     virtual size_t              default_screen();
                     virtual status_t            screen_size(size_t screen, ssize_t *w, ssize_t *h);
@@ -341,6 +398,16 @@ namespace lsp
                 public:
                     bool                        add_window(X11Window *wnd);
                     bool                        remove_window(X11Window *wnd);
+                    void                        watch_ancestors(X11Window *wnd);
+                    void                        invalidate_origins(Window wnd);
+                    bool                        reclaim_window(X11Window *wnd);
+                    void                        destroy_window(Window wnd, bool request);
+                    void                        remove_icon_set(X11IconSet *icon);
+                    bool                        owns_icon_set(const IIconSet *icon) const;
+                    inline bool                 shm_supported() const       { return bShm; }
+                #ifdef USE_LIBXEXT
+                    bool                        shm_attach(XShmSegmentInfo *info);
+                #endif /* USE_LIBXEXT */
 
                     inline Display             *x11display() const  { return pDisplay; }
                     inline Window               x11root() const     { return hRootWnd; }
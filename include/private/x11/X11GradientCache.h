@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UI_X11_X11GRADIENTCACHE_H_
+#define UI_X11_X11GRADIENTCACHE_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/common/types.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+#include <cairo/cairo.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            enum gradient_type_t
+            {
+                GRADIENT_LINEAR,
+                GRADIENT_RADIAL
+            };
+
+            typedef struct gradient_stop_t
+            {
+                float               offset;
+                float               r, g, b, a;     // Color components, alpha is opacity
+            } gradient_stop_t;
+
+            /**
+             * Cache of gradient patterns shared between all surfaces of the display.
+             * Patterns are looked up by the gradient type, geometry and list of color stops,
+             * so equivalent gradients created by different widgets refer the same pattern.
+             * Linear gradients are rasterized once into the 1D ramp image which is
+             * applied as a surface pattern with the pad extend mode.
+             */
+            class X11GradientCache
+            {
+                private:
+                    X11GradientCache & operator = (const X11GradientCache &);
+                    X11GradientCache(const X11GradientCache &);
+
+                protected:
+                    typedef struct entry_t
+                    {
+                        size_t              nHash;          // Hash of the key
+                        gradient_type_t     enType;         // Type of gradient
+                        float               vParams[6];     // Geometry of gradient
+                        gradient_stop_t    *vStops;         // List of color stops
+                        size_t              nStops;         // Number of color stops
+                        cairo_pattern_t    *pPattern;       // Cached pattern
+                        size_t              nStamp;         // Access stamp for LRU ordering
+                    } entry_t;
+
+                protected:
+                    volatile atomic_t       hLock;          // Lock, gradients are applied by drawing threads
+                    size_t                  nStamp;         // Current access stamp
+                    lltl::darray<entry_t>   vEntries;       // Cached patterns
+
+                protected:
+                    static size_t           hash(gradient_type_t type, const float *params, const gradient_stop_t *stops, size_t n);
+                    static void             destroy_entry(entry_t *e);
+                    static cairo_pattern_t *create_ramp(const float *params, const gradient_stop_t *stops, size_t n);
+                    void                    trim(size_t limit);
+                    inline void             lock()      { while (!atomic_cas(&hLock, 0, 1)) { /* Wait */ } }
+                    inline void             unlock()    { hLock = 0; }
+
+                public:
+                    explicit X11GradientCache();
+                    ~X11GradientCache();
+
+                public:
+                    /** Get the pattern for the gradient from the cache or create new one
+                     *
+                     * @param type type of gradient
+                     * @param params geometry of gradient: x0, y0, x1, y1 for linear gradient,
+                     *   cx0, cy0, r0, cx1, cy1, r1 for radial gradient
+                     * @param stops list of color stops sorted by offset
+                     * @param n number of color stops
+                     * @return new reference to the pattern or NULL on error
+                     */
+                    cairo_pattern_t        *acquire(gradient_type_t type, const float *params, const gradient_stop_t *stops, size_t n);
+
+                    /** Destroy all cached patterns
+                     */
+                    void                    clear();
+
+                public:
+                    /** Create the pattern for the gradient without caching
+                     *
+                     * @param type type of gradient
+                     * @param params geometry of gradient
+                     * @param stops list of color stops sorted by offset
+                     * @param n number of color stops
+                     * @return pattern or NULL on error
+                     */
+                    static cairo_pattern_t *create_pattern(gradient_type_t type, const float *params, const gradient_stop_t *stops, size_t n);
+            };
+        }
+    }
+}
+
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
+
+#endif /* UI_X11_X11GRADIENTCACHE_H_ */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UI_X11_X11ICONSET_H_
+#define UI_X11_X11ICONSET_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/common/types.h>
+
+#ifdef USE_LIBX11
+
+#include <lsp-plug.in/ws/IIconSet.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            class X11Display;
+
+            /**
+             * Icon set which keeps images already converted into the
+             * layout of the _NET_WM_ICON property: width, height and
+             * width*height ARGB pixels stored as 'long' values for each image.
+             * Icon sets created by the display are registered in it, so windows
+             * can check that the set has been created by the same display
+             */
+            class X11IconSet: public IIconSet
+            {
+                protected:
+                    X11Display     *pDisplay;       // Display that owns the icon set
+                    unsigned long  *vData;          // Contents of the _NET_WM_ICON property
+                    size_t          nSize;          // Number of used elements
+                    size_t          nCapacity;      // Capacity of the buffer
+                    size_t          nIcons;         // Number of images
+
+                public:
+                    explicit X11IconSet(X11Display *dpy);
+                    virtual ~X11IconSet();
+
+                public:
+                    virtual status_t add(const void *bgra, size_t width, size_t height);
+
+                    virtual size_t size() const;
+
+                    virtual void clear();
+
+                public:
+                    /** Get contents of the _NET_WM_ICON property
+                     *
+                     * @return pointer to the property data
+                     */
+                    inline const unsigned long *data() const    { return vData; }
+
+                    /** Get number of elements of the _NET_WM_ICON property
+                     *
+                     * @return number of elements
+                     */
+                    inline size_t length() const                { return nSize; }
+
+                    /** Detach the icon set from the display which is being destroyed
+                     *
+                     */
+                    inline void detach()                        { pDisplay = NULL; }
+            };
+        }
+    }
+}
+
+#endif /* USE_LIBX11 */
+
+#endif /* UI_X11_X11ICONSET_H_ */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UI_X11_X11SURFACEPOOL_H_
+#define UI_X11_X11SURFACEPOOL_H_
+
+#include <lsp-plug.in/ws/version.h>
+#include <lsp-plug.in/common/types.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/ws/types.h>
+
+#include <cairo/cairo.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            /**
+             * Pool of released cairo image surfaces. Surfaces are matched by the pixel format
+             * and the size bucket: the request can be satisfied by the pooled surface of the
+             * same format if each dimension of the pooled surface is not less than requested
+             * and rounds up to the same power of two. Larger surfaces are returned as views
+             * which refer the pixel data of the pooled surface. The least recently released
+             * surfaces are destroyed when the amount of pooled memory exceeds the limit.
+             */
+            class X11SurfacePool
+            {
+                private:
+                    X11SurfacePool & operator = (const X11SurfacePool &);
+                    X11SurfacePool(const X11SurfacePool &);
+
+                protected:
+                    typedef struct entry_t
+                    {
+                        cairo_surface_t    *pSurface;       // Pooled surface
+                        cairo_format_t      enFormat;       // Pixel format
+                        size_t              nWidth;         // Width of the surface
+                        size_t              nHeight;        // Height of the surface
+                        size_t              nBucket;        // Size bucket of the surface
+                        size_t              nBytes;         // Amount of memory used by pixel data
+                        size_t              nStamp;         // Release stamp for LRU ordering
+                    } entry_t;
+
+                protected:
+                    volatile atomic_t       hLock;          // Lock, surfaces may be released by drawing threads
+                    size_t                  nStamp;         // Current release stamp
+                    surface_pool_stats_t    sStats;         // Pool statistics
+                    lltl::darray<entry_t>   vEntries;       // Pooled surfaces
+
+                    static cairo_user_data_key_t    sBackingKey;
+
+                protected:
+                    static size_t           bucket(size_t width, size_t height);
+                    static void             release_backing(void *ptr);
+                    static void             clear_surface(cairo_surface_t *s);
+                    void                    trim(size_t limit);
+                    inline void             lock()      { while (!atomic_cas(&hLock, 0, 1)) { /* Wait */ } }
+                    inline void             unlock()    { hLock = 0; }
+
+                public:
+                    explicit X11SurfacePool();
+                    ~X11SurfacePool();
+
+                public:
+                    /** Get image surface from the pool or create new one if there is no
+                     * matching surface
+                     *
+                     * @param format pixel format
+                     * @param width width of the surface
+                     * @param height height of the surface
+                     * @param clear clear contents of the recycled surface
+                     * @return image surface or NULL on error
+                     */
+                    cairo_surface_t        *acquire(cairo_format_t format, size_t width, size_t height, bool clear);
+
+                    /** Return the image surface to the pool, the reference to the surface is
+                     * taken by the pool. The surface is destroyed if it can not be reused
+                     *
+                     * @param s surface to release
+                     */
+                    void                    release(cairo_surface_t *s);
+
+                    /** Set the maximum amount of memory kept by the pool
+                     *
+                     * @param bytes number of bytes, zero value disables the pool
+                     */
+                    void                    set_limit(size_t bytes);
+
+                    /** Get the maximum amount of memory kept by the pool
+                     *
+                     * @return number of bytes
+                     */
+                    size_t                  limit();
+
+                    /** Get the pool statistics
+                     *
+                     * @param stats pointer to store statistics
+                     */
+                    void                    get_stats(surface_pool_stats_t *stats);
+
+                    /** Destroy all pooled surfaces
+                     */
+                    void                    clear();
+
+                public:
+                    /** Create the image surface of the specified size which refers the pixel data of
+                     * the backing surface starting at the top-left corner. The view takes the reference
+                     * to the backing surface and releases it on destroy
+                     *
+                     * @param backing backing image surface, the reference is taken even on error
+                     * @param width width of the view, should not exceed the width of the backing surface
+                     * @param height height of the view, should not exceed the height of the backing surface
+                     * @return image surface or NULL on error
+                     */
+                    static cairo_surface_t *create_view(cairo_surface_t *backing, size_t width, size_t height);
+
+                    /** Get the backing surface which holds the pixel data of the image surface
+                     *
+                     * @param s image surface
+                     * @return backing surface of the view or the surface itself
+                     */
+                    static cairo_surface_t *backing(cairo_surface_t *s);
+            };
+        }
+    }
+}
+
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
+
+#endif /* UI_X11_X11SURFACEPOOL_H_ */
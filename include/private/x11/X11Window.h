@@ -25,6 +25,7 @@
 #include <lsp-plug.in/ws/version.h>
 #include <lsp-plug.in/common/types.h>
 #include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/lltl/darray.h>
 #include <lsp-plug.in/ws/IEventHandler.h>
 #include <lsp-plug.in/ws/IWindow.h>
 
@@ -35,6 +36,7 @@ namespace lsp
         namespace x11
         {
             class X11Display;
+            class X11IconSet;
 
             class X11Window: public IWindow, public IEventHandler
             {
@@ -42,9 +44,31 @@ namespace lsp
                     enum flags_t
                     {
                         F_GRABBING      = 1 << 0,
-                        F_LOCKING       = 1 << 1
+                        F_LOCKING       = 1 << 1,
+                        F_POOLED        = 1 << 2
                     };
 
+                    enum update_flags_t
+                    {
+                        UF_CAPTION      = 1 << 0,
+                        UF_CLASS        = 1 << 1,
+                        UF_ROLE         = 1 << 2,
+                        UF_BORDER       = 1 << 3,
+                        UF_ACTIONS      = 1 << 4,
+                        UF_GEOMETRY     = 1 << 5
+                    };
+
+                    typedef struct update_t
+                    {
+                        ssize_t         nLock;          // Nesting level of begin_update()
+                        size_t          nDirty;         // Set of update_flags_t
+                        char           *sCaption;       // Staged ASCII caption
+                        char           *sCaptionUtf8;   // Staged UTF-8 caption
+                        char           *sClass;         // Staged instance and class, both zero-terminated
+                        size_t          nClassLen;      // Length of staged class data
+                        char           *sRole;          // Staged window role
+                    } update_t;
+
                     typedef struct btn_event_t
                     {
                         event_t         sDown;
@@ -63,12 +87,18 @@ namespace lsp
                     size_t              nScreen;
                     size_t              nFlags;
                     mouse_pointer_t     enPointer;
+                    buffering_t         enBuffering;
                     bool                bWrapper;
                     bool                bVisible;
+                    bool                bAbsValid;
+                    ssize_t             nAbsLeft;
+                    ssize_t             nAbsTop;
+                    lltl::darray< ::Window > vAncestors;    // Watched ancestors up to the root window
 
                     rectangle_t         sSize;
                     size_limit_t        sConstraints;
                     btn_event_t         vBtnEvent[3];
+                    update_t            sUpdate;
 
                 protected:
                     void                drop_surface();
@@ -77,6 +107,16 @@ namespace lsp
                     static bool         check_double_click(const btn_event_t *pe, const btn_event_t *ce);
                     void                send_focus_event();
                     status_t            commit_size();
+                    void                drop_update();
+                    void                drop_state();
+
+                    void                send_caption(const char *ascii, const char *utf8);
+                    void                send_class(const char *data, size_t len);
+                    void                send_role(const char *wrole);
+                    void                send_border_style();
+                    void                send_window_actions();
+                    void                send_motif_hints();
+                    status_t            apply_icon(const X11IconSet *xicon);
 
                 protected:
 
@@ -99,6 +139,35 @@ namespace lsp
                      */
                     virtual void        destroy();
 
+                    /** Hand over the X11 window and the drawing surface to the window object
+                     * which will be kept in the window pool of the display. After that, the
+                     * destination object becomes pre-initialized and this object loses the handle
+                     *
+                     * @param dst destination window object
+                     */
+                    void                hand_over(X11Window *dst);
+
+                    /** Check that the absolute origin of the window depends on the position of other window
+                     *
+                     * @param wnd the other window
+                     * @return true if the other window is the window itself or one of its watched ancestors
+                     */
+                    bool                origin_depends(::Window wnd);
+
+                    /** Window finalization routine
+                     *
+                     * @param request issue XDestroyWindow request, false if the window
+                     *   is destroyed by the server together with its parent
+                     * @return true if the X11 window has been destroyed, false if the window
+                     *   is a wrapper or the X11 window has been returned to the window pool
+                     */
+                    bool                do_destroy(bool request);
+
+                    /** Mark the initialized window as owned by the window pool of the display
+                     *
+                     */
+                    inline void         mark_pooled()           { nFlags |= F_POOLED; }
+
                 public:
                     /** Get event handler
                      *
@@ -326,6 +395,8 @@ namespace lsp
                      */
                     virtual status_t set_icon(const void *bgra, size_t width, size_t height);
 
+                    virtual status_t set_icon(const IIconSet *icon);
+
                     /** Get bitmask of allowed window actions
                      *
                      * @param actions pointer to store action mask
@@ -367,6 +438,16 @@ namespace lsp
                      * @return status of operation
                      */
                     virtual status_t set_role(const char *wrole);
+
+                    virtual status_t release_surface();
+
+                    virtual status_t set_buffering(buffering_t mode);
+
+                    virtual buffering_t get_buffering();
+
+                    virtual status_t begin_update();
+
+                    virtual status_t commit_update();
             };
         }
     
@@ -99,6 +99,10 @@ LIBX11_VERSION             := system
 LIBX11_NAME                := x11
 LIBX11_TYPE                := pkg
 
+LIBXEXT_VERSION            := system
+LIBXEXT_NAME               := xext
+LIBXEXT_TYPE               := pkg
+
 LIBGL_VERSION              := system
 LIBGL_NAME                 := gl
 LIBGL_TYPE                 := pkg
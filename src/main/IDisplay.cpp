@@ -697,6 +697,57 @@ namespace lsp
             return NULL;
         }
 
+        IWindow *IDisplay::create_window(border_style_t style)
+        {
+            return create_window();
+        }
+
+        status_t IDisplay::set_window_pool_size(size_t count)
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        size_t IDisplay::window_pool_size()
+        {
+            return 0;
+        }
+
+        status_t IDisplay::set_surface_pool_limit(size_t bytes)
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        size_t IDisplay::surface_pool_limit()
+        {
+            return 0;
+        }
+
+        status_t IDisplay::get_surface_pool_stats(surface_pool_stats_t *stats)
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        IIconSet *IDisplay::create_icon_set()
+        {
+            return NULL;
+        }
+
+        SpriteAtlas *IDisplay::create_sprite_atlas(size_t width, size_t height)
+        {
+            if ((width <= 0) || (height <= 0))
+                return NULL;
+            return new SpriteAtlas(this, width, height);
+        }
+
+        void IDisplay::destroy_windows(IWindow * const *list, size_t count)
+        {
+            for (size_t i=0; i<count; ++i)
+            {
+                if (list[i] != NULL)
+                    list[i]->destroy();
+            }
+        }
+
         IWindow *IDisplay::wrap_window(void *handle)
         {
             return NULL;
@@ -707,6 +758,11 @@ namespace lsp
             return NULL;
         }
 
+        ISurface *IDisplay::create_surface(size_t width, size_t height, surface_format_t format)
+        {
+            return (format == SFMT_ARGB32) ? create_surface(width, height) : NULL;
+        }
+
         ISurface *IDisplay::estimation_surface()
         {
             if (pEstimation != NULL)
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/IIconSet.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        IIconSet::IIconSet()
+        {
+        }
+
+        IIconSet::~IIconSet()
+        {
+        }
+
+        status_t IIconSet::add(const void *bgra, size_t width, size_t height)
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        size_t IIconSet::size() const
+        {
+            return 0;
+        }
+
+        void IIconSet::clear()
+        {
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/IPath.h>
+#include <lsp-plug.in/ws/ISurface.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        IPath::IPath()
+        {
+        }
+
+        IPath::~IPath()
+        {
+        }
+
+        status_t IPath::move_to(float x, float y)
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        status_t IPath::line_to(float x, float y)
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        status_t IPath::curve_to(float x1, float y1, float x2, float y2, float x3, float y3)
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        status_t IPath::arc(float cx, float cy, float r, float a1, float a2)
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        status_t IPath::close()
+        {
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
+        status_t IPath::round_rect(size_t mask, float radius, float left, float top, float width, float height)
+        {
+            status_t res;
+            radius              = lsp_max(0.0f, radius);
+            const float right   = left + width;
+            const float bottom  = top + height;
+
+            if (mask & SURFMASK_LT_CORNER)
+            {
+                if ((res = move_to(left, top + radius)) != STATUS_OK)
+                    return res;
+                res = arc(left + radius, top + radius, radius, M_PI, 1.5f * M_PI);
+            }
+            else
+                res = move_to(left, top);
+            if (res != STATUS_OK)
+                return res;
+
+            res = (mask & SURFMASK_RT_CORNER) ?
+                    arc(right - radius, top + radius, radius, 1.5f * M_PI, 2.0f * M_PI) :
+                    line_to(right, top);
+            if (res != STATUS_OK)
+                return res;
+
+            res = (mask & SURFMASK_RB_CORNER) ?
+                    arc(right - radius, bottom - radius, radius, 0.0f, 0.5f * M_PI) :
+                    line_to(right, bottom);
+            if (res != STATUS_OK)
+                return res;
+
+            res = (mask & SURFMASK_LB_CORNER) ?
+                    arc(left + radius, bottom - radius, radius, 0.5f * M_PI, M_PI) :
+                    line_to(left, bottom);
+            if (res != STATUS_OK)
+                return res;
+
+            return close();
+        }
+
+        status_t IPath::sector(float cx, float cy, float r, float a1, float a2)
+        {
+            status_t res = move_to(cx, cy);
+            if (res == STATUS_OK)
+                res = arc(cx, cy, r, a1, a2);
+            return (res == STATUS_OK) ? close() : res;
+        }
+
+        bool IPath::get_bounds(float *bounds) const
+        {
+            return false;
+        }
+
+        void IPath::clear()
+        {
+        }
+    }
+}
@@ -58,11 +58,26 @@ namespace lsp
             return new ISurface(width, height, ST_UNKNOWN);
         }
 
+        ISurface *ISurface::create(size_t width, size_t height, surface_format_t format)
+        {
+            return (format == SFMT_ARGB32) ? create(width, height) : NULL;
+        }
+
+        surface_format_t ISurface::format() const
+        {
+            return SFMT_ARGB32;
+        }
+
         ISurface *ISurface::create_copy()
         {
             return new ISurface(nWidth, nHeight, ST_UNKNOWN);
         }
 
+        ISurface *ISurface::create_view(ssize_t left, ssize_t top, size_t width, size_t height)
+        {
+            return NULL;
+        }
+
         void ISurface::destroy()
         {
         }
@@ -77,6 +92,11 @@ namespace lsp
             return new IGradient();
         }
 
+        IPath *ISurface::create_path()
+        {
+            return NULL;
+        }
+
         void ISurface::draw(ISurface *s, float x, float y)
         {
         }
@@ -85,6 +105,11 @@ namespace lsp
         {
         }
 
+        void ISurface::draw(ISurface *s, float x, float y, float sx, float sy, surface_filter_t filter)
+        {
+            draw(s, x, y, sx, sy);
+        }
+
         void ISurface::draw(ISurface *s, const ws::rectangle_t *r)
         {
             float sx = (s->width()  > 0) ? float(r->nWidth ) / float(s->width())  : 0.0f;
@@ -106,6 +131,19 @@ namespace lsp
         {
         }
 
+        void ISurface::draw_batch(ISurface *s, const surface_blit_t *list, size_t count)
+        {
+            for (size_t i=0; i<count; ++i)
+            {
+                const surface_blit_t *b = &list[i];
+                draw_clipped(s, b->fX, b->fY, b->nLeft, b->nTop, b->nWidth, b->nHeight);
+            }
+        }
+
+        void ISurface::draw_mask(const Color &color, ISurface *mask, float x, float y)
+        {
+        }
+
         void ISurface::fill_rect(const Color &color, float left, float top, float width, float height)
         {
         }
@@ -243,6 +281,11 @@ namespace lsp
         {
         }
 
+        size_t ISurface::get_damage(ws::rectangle_t *rects, size_t count)
+        {
+            return 0;
+        }
+
         void ISurface::clear_rgb(uint32_t color)
         {
         }
@@ -311,6 +354,22 @@ namespace lsp
         {
         }
 
+        void ISurface::draw_lines(const float *x0, const float *y0, const float *x1, const float *y1, size_t n, float width, const Color &color)
+        {
+            for (size_t i=0; i<n; ++i)
+                line(x0[i], y0[i], x1[i], y1[i], width, color);
+        }
+
+        void ISurface::draw_polylines(const float *x, const float *y, const size_t *count, size_t n, float width, const Color &color)
+        {
+            for (size_t i=0; i<n; ++i)
+            {
+                wire_poly(color, width, x, y, count[i]);
+                x  += count[i];
+                y  += count[i];
+            }
+        }
+
         void ISurface::parametric_line(float a, float b, float c, float width, const Color &color)
         {
         }
@@ -379,6 +438,18 @@ namespace lsp
         {
         }
 
+        void ISurface::fill_path(const Color &color, IPath *path, float x, float y)
+        {
+        }
+
+        void ISurface::fill_path(IGradient *g, IPath *path, float x, float y)
+        {
+        }
+
+        void ISurface::wire_path(const Color &color, float width, IPath *path, float x, float y)
+        {
+        }
+
         void ISurface::fill_circle(float x, float y, float r, const Color & color)
         {
         }
@@ -410,6 +481,16 @@ namespace lsp
             return false;
         }
 
+        bool ISurface::get_decimation()
+        {
+            return false;
+        }
+
+        bool ISurface::set_decimation(bool enable)
+        {
+            return false;
+        }
+
         surf_line_cap_t ISurface::get_line_cap()
         {
             return SURFLCAP_BUTT;
@@ -445,6 +526,11 @@ namespace lsp
         void ISurface::end_direct()
         {
         }
+
+        void ISurface::end_direct(const rectangle_t *dirty)
+        {
+            end_direct();
+        }
     }
 
 } /* namespace lsp */
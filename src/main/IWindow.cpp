@@ -354,6 +354,12 @@ namespace lsp
             return STATUS_NOT_IMPLEMENTED;
         }
 
+        status_t IWindow::set_icon(const IIconSet *icon)
+        {
+            lsp_error("not implemented");
+            return STATUS_NOT_IMPLEMENTED;
+        }
+
         status_t IWindow::get_window_actions(size_t *actions)
         {
             if (actions != NULL)
@@ -396,5 +402,30 @@ namespace lsp
         {
             return STATUS_OK;
         }
+
+        status_t IWindow::release_surface()
+        {
+            return STATUS_OK;
+        }
+
+        status_t IWindow::set_buffering(buffering_t mode)
+        {
+            return (mode == BUF_NONE) ? STATUS_OK : STATUS_NOT_IMPLEMENTED;
+        }
+
+        buffering_t IWindow::get_buffering()
+        {
+            return BUF_NONE;
+        }
+
+        status_t IWindow::begin_update()
+        {
+            return STATUS_OK;
+        }
+
+        status_t IWindow::commit_update()
+        {
+            return STATUS_OK;
+        }
     } /* namespace ws */
 } /* namespace lsp */
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/ProxyGradient.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        ProxyGradient::ProxyGradient(float x0, float y0, float x1, float y1)
+        {
+            enType      = GR_LINEAR;
+            vParams[0]  = x0;
+            vParams[1]  = y0;
+            vParams[2]  = x1;
+            vParams[3]  = y1;
+            vParams[4]  = 0.0f;
+            vParams[5]  = 0.0f;
+        }
+
+        ProxyGradient::ProxyGradient(float cx0, float cy0, float r0, float cx1, float cy1, float r1)
+        {
+            enType      = GR_RADIAL;
+            vParams[0]  = cx0;
+            vParams[1]  = cy0;
+            vParams[2]  = r0;
+            vParams[3]  = cx1;
+            vParams[4]  = cy1;
+            vParams[5]  = r1;
+        }
+
+        ProxyGradient::~ProxyGradient()
+        {
+            vStops.flush();
+        }
+
+        void ProxyGradient::add_color(float offset, float r, float g, float b, float a)
+        {
+            stop_t *s   = vStops.add();
+            if (s == NULL)
+                return;
+
+            s->fOffset  = offset;
+            s->fRed     = r;
+            s->fGreen   = g;
+            s->fBlue    = b;
+            s->fAlpha   = a;
+        }
+    }
+}
@@ -0,0 +1,1482 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/ProxySurface.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROXY_CHUNK_SIZE        0x10000
+#define PROXY_ALIGN             8
+
+namespace lsp
+{
+    namespace ws
+    {
+        static inline size_t proxy_align(size_t bytes)
+        {
+            return (bytes + PROXY_ALIGN - 1) & ~size_t(PROXY_ALIGN - 1);
+        }
+
+        ProxySurface::ProxySurface(ISurface *ref, size_t width, size_t height):
+            ISurface(width, height, ST_PROXY)
+        {
+            pRef            = ref;
+            pFirst          = NULL;
+            pCurr           = NULL;
+            nCommands       = 0;
+            bAntiAliasing   = true;
+            enLineCap       = SURFLCAP_BUTT;
+            bDecimation     = false;
+        }
+
+        ProxySurface::~ProxySurface()
+        {
+            do_destroy();
+        }
+
+        void ProxySurface::do_destroy()
+        {
+            reset();
+
+            for (chunk_t *c = pFirst; c != NULL; )
+            {
+                chunk_t *next   = c->pNext;
+                ::free(c);
+                c               = next;
+            }
+
+            pFirst          = NULL;
+            pCurr           = NULL;
+            vFonts.flush();
+        }
+
+        void ProxySurface::destroy()
+        {
+            do_destroy();
+        }
+
+        void ProxySurface::reset()
+        {
+            for (chunk_t *c = pFirst; c != NULL; c = c->pNext)
+                c->nSize        = 0;
+            pCurr           = pFirst;
+            nCommands       = 0;
+
+            for (size_t i=0, n=vFonts.size(); i<n; ++i)
+            {
+                Font *f         = vFonts.uget(i);
+                if (f != NULL)
+                    delete f;
+            }
+            vFonts.clear();
+        }
+
+        void ProxySurface::clear_commands()
+        {
+            reset();
+        }
+
+        void *ProxySurface::alloc(size_t bytes)
+        {
+            const size_t hdr    = proxy_align(sizeof(chunk_t));
+
+            // Allocate space in the current chunk if possible
+            if ((pCurr != NULL) && (pCurr->nSize + bytes <= pCurr->nCapacity))
+            {
+                uint8_t *ptr        = reinterpret_cast<uint8_t *>(pCurr) + hdr + pCurr->nSize;
+                pCurr->nSize       += bytes;
+                return ptr;
+            }
+
+            // Re-use the next chunk which has been allocated by previous recordings
+            chunk_t *next       = (pCurr != NULL) ? pCurr->pNext : pFirst;
+            if ((next == NULL) || (next->nCapacity < bytes))
+            {
+                size_t capacity     = lsp_max(bytes, size_t(PROXY_CHUNK_SIZE));
+                chunk_t *c          = static_cast<chunk_t *>(::malloc(hdr + capacity));
+                if (c == NULL)
+                    return NULL;
+
+                c->pNext            = next;
+                c->nSize            = 0;
+                c->nCapacity        = capacity;
+                if (pCurr != NULL)
+                    pCurr->pNext        = c;
+                else
+                    pFirst              = c;
+                next                = c;
+            }
+
+            pCurr               = next;
+            pCurr->nSize        = bytes;
+            return reinterpret_cast<uint8_t *>(pCurr) + hdr;
+        }
+
+        ProxySurface::command_t *ProxySurface::add_command(size_t code, size_t args, size_t payload)
+        {
+            size_t offset       = proxy_align(sizeof(command_t) + args * sizeof(float));
+            size_t size         = proxy_align(offset + payload);
+            command_t *cmd      = static_cast<command_t *>(alloc(size));
+            if (cmd == NULL)
+                return NULL;
+
+            cmd->nCode          = code;
+            cmd->nArgs          = args;
+            cmd->nSize          = size;
+            cmd->nParam         = 0;
+            cmd->nPayload       = offset;
+            set_bounds(cmd, -FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX);
+            ++nCommands;
+
+            return cmd;
+        }
+
+        float *ProxySurface::add_args(size_t code, size_t args)
+        {
+            command_t *cmd      = add_command(code, args, 0);
+            return (cmd != NULL) ? cmd_args(cmd) : NULL;
+        }
+
+        ssize_t ProxySurface::add_font(const Font &f)
+        {
+            // Consequent text commands usually use the same font
+            size_t n            = vFonts.size();
+            if (n > 0)
+            {
+                Font *last          = vFonts.uget(n - 1);
+                const char *a       = last->name();
+                const char *b       = f.name();
+
+                if ((last->size() == f.size()) &&
+                    (last->flags() == f.flags()) &&
+                    (last->antialias() == f.antialias()) &&
+                    ((a == b) || ((a != NULL) && (b != NULL) && (!::strcmp(a, b)))))
+                    return n - 1;
+            }
+
+            Font *copy          = new Font(&f);
+            if (copy == NULL)
+                return -1;
+            if (!vFonts.add(copy))
+            {
+                delete copy;
+                return -1;
+            }
+
+            return n;
+        }
+
+        float *ProxySurface::put_color(float *dst, const Color &c)
+        {
+            dst[0]              = c.red();
+            dst[1]              = c.green();
+            dst[2]              = c.blue();
+            dst[3]              = c.alpha();
+            return &dst[4];
+        }
+
+        Color ProxySurface::get_color(const float *src)
+        {
+            return Color(src[0], src[1], src[2], src[3]);
+        }
+
+        size_t ProxySurface::gradient_size(IGradient *g)
+        {
+            ProxyGradient *pg   = static_cast<ProxyGradient *>(g);
+            return sizeof(gradient_t) + pg->stops() * sizeof(ProxyGradient::stop_t);
+        }
+
+        void ProxySurface::put_gradient(uint8_t *dst, IGradient *g)
+        {
+            ProxyGradient *pg   = static_cast<ProxyGradient *>(g);
+            gradient_t *gr      = reinterpret_cast<gradient_t *>(dst);
+            size_t n            = pg->stops();
+
+            gr->nType           = pg->type();
+            gr->nStops          = n;
+            ::memcpy(gr->vParams, pg->params(), sizeof(gr->vParams));
+
+            ProxyGradient::stop_t *stops = reinterpret_cast<ProxyGradient::stop_t *>(&gr[1]);
+            for (size_t i=0; i<n; ++i)
+                stops[i]            = *(pg->stop(i));
+        }
+
+        IGradient *ProxySurface::get_gradient(ISurface *dst, const uint8_t *src)
+        {
+            const gradient_t *gr    = reinterpret_cast<const gradient_t *>(src);
+            const float *p          = gr->vParams;
+
+            IGradient *g            = (gr->nType == ProxyGradient::GR_LINEAR) ?
+                                        dst->linear_gradient(p[0], p[1], p[2], p[3]) :
+                                        dst->radial_gradient(p[0], p[1], p[2], p[3], p[4], p[5]);
+            if (g == NULL)
+                return NULL;
+
+            const ProxyGradient::stop_t *stops = reinterpret_cast<const ProxyGradient::stop_t *>(&gr[1]);
+            for (size_t i=0; i<gr->nStops; ++i)
+            {
+                const ProxyGradient::stop_t *s = &stops[i];
+                g->add_color(s->fOffset, s->fRed, s->fGreen, s->fBlue, s->fAlpha);
+            }
+
+            return g;
+        }
+
+        void ProxySurface::put_surface(uint8_t *dst, ISurface *s)
+        {
+            ::memcpy(dst, &s, sizeof(ISurface *));
+        }
+
+        ISurface *ProxySurface::get_surface(const uint8_t *src)
+        {
+            ISurface *s;
+            ::memcpy(&s, src, sizeof(ISurface *));
+            return s;
+        }
+
+        void ProxySurface::put_path(uint8_t *dst, IPath *path)
+        {
+            ::memcpy(dst, &path, sizeof(IPath *));
+        }
+
+        IPath *ProxySurface::get_path(const uint8_t *src)
+        {
+            IPath *path;
+            ::memcpy(&path, src, sizeof(IPath *));
+            return path;
+        }
+
+        void ProxySurface::record_color(size_t code, const Color &c, size_t param, const float *args, size_t n)
+        {
+            command_t *cmd      = add_command(code, n + 4, 0);
+            if (cmd == NULL)
+                return;
+
+            cmd->nParam         = param;
+            float *dst          = put_color(cmd_args(cmd), c);
+            for (size_t i=0; i<n; ++i)
+                dst[i]              = args[i];
+            update_bounds(cmd);
+        }
+
+        void ProxySurface::record_gradient(size_t code, IGradient *g, size_t param, const float *args, size_t n)
+        {
+            if (g == NULL)
+                return;
+
+            command_t *cmd      = add_command(code, n, gradient_size(g));
+            if (cmd == NULL)
+                return;
+
+            cmd->nParam         = param;
+            float *dst          = cmd_args(cmd);
+            for (size_t i=0; i<n; ++i)
+                dst[i]              = args[i];
+            put_gradient(cmd_payload(cmd), g);
+            update_bounds(cmd);
+        }
+
+        void ProxySurface::record_draw(size_t code, ISurface *s, const float *args, size_t n)
+        {
+            if (s == NULL)
+                return;
+
+            command_t *cmd      = add_command(code, n, sizeof(ISurface *));
+            if (cmd == NULL)
+                return;
+
+            float *dst          = cmd_args(cmd);
+            for (size_t i=0; i<n; ++i)
+                dst[i]              = args[i];
+            put_surface(cmd_payload(cmd), s);
+            update_bounds(cmd);
+        }
+
+        void ProxySurface::record_text(size_t code, const Font &f, const Color &color, float x, float y, float dx, float dy, const char *text)
+        {
+            if (text == NULL)
+                return;
+
+            ssize_t font        = add_font(f);
+            if (font < 0)
+                return;
+
+            size_t len          = ::strlen(text) + 1;
+            command_t *cmd      = add_command(code, 8, len);
+            if (cmd == NULL)
+                return;
+
+            cmd->nParam         = font;
+            float *dst          = put_color(cmd_args(cmd), color);
+            dst[0]              = x;
+            dst[1]              = y;
+            dst[2]              = dx;
+            dst[3]              = dy;
+            ::memcpy(cmd_payload(cmd), text, len);
+
+            // Estimate bounds of the text if the reference surface is present
+            text_parameters_t tp;
+            if ((pRef == NULL) || (!pRef->get_text_parameters(f, &tp, text)))
+                return;
+
+            if (code == CMD_OUT_TEXT_RELATIVE)
+            {
+                // Text origin depends on the text size
+                float r_w           = tp.XAdvance - tp.XBearing;
+                float r_h           = tp.YAdvance - tp.YBearing;
+                x                   = x - tp.XBearing + (r_w + 4) * 0.5f * dx - r_w * 0.5f;
+                y                   = y - tp.YAdvance + (r_h + 4) * 0.5f * (1.0f - dy) - r_h * 0.5f + 1.0f;
+            }
+
+            // Glyphs may exceed the ink rectangle due to hinting and antialiasing
+            float border        = f.size() * 0.25f + 2.0f;
+            x                  += tp.XBearing;
+            y                  += tp.YBearing;
+            set_bounds(cmd, x - border, y - border, x + tp.Width + border, y + tp.Height + border);
+        }
+
+        void ProxySurface::set_bounds(command_t *cmd, float left, float top, float right, float bottom)
+        {
+            cmd->fLeft          = left;
+            cmd->fTop           = top;
+            cmd->fRight         = right;
+            cmd->fBottom        = bottom;
+        }
+
+        void ProxySurface::set_rect_bounds(command_t *cmd, const float *rect, float border)
+        {
+            // Width and height of the rectangle may be negative
+            float x1            = rect[0];
+            float y1            = rect[1];
+            float x2            = rect[0] + rect[2];
+            float y2            = rect[1] + rect[3];
+
+            set_bounds(cmd,
+                lsp_min(x1, x2) - border, lsp_min(y1, y2) - border,
+                lsp_max(x1, x2) + border, lsp_max(y1, y2) + border);
+        }
+
+        void ProxySurface::update_bounds(command_t *cmd)
+        {
+            const float *a      = cmd_args(cmd);
+
+            switch (cmd->nCode)
+            {
+                case CMD_DRAW:
+                case CMD_DRAW_SCALED:
+                case CMD_DRAW_FILTERED:
+                case CMD_DRAW_ALPHA:
+                {
+                    ISurface *s         = get_surface(cmd_payload(cmd));
+                    float sx            = (cmd->nCode == CMD_DRAW) ? 1.0f : a[2];
+                    float sy            = (cmd->nCode == CMD_DRAW) ? 1.0f : a[3];
+                    // Flipped surface is shifted by its size and still starts at the origin point
+                    float r[4]          = { a[0], a[1], s->width() * fabsf(sx), s->height() * fabsf(sy) };
+                    set_rect_bounds(cmd, r, 1.0f);
+                    break;
+                }
+                case CMD_DRAW_ROTATE_ALPHA:
+                {
+                    // The surface is rotated around the origin point
+                    ISurface *s         = get_surface(cmd_payload(cmd));
+                    float w             = s->width() * a[2];
+                    float h             = s->height() * a[3];
+                    float r             = sqrtf(w*w + h*h) + 1.0f;
+                    set_bounds(cmd, a[0] - r, a[1] - r, a[0] + r, a[1] + r);
+                    break;
+                }
+                case CMD_DRAW_CLIPPED:
+                {
+                    float r[4]          = { a[0], a[1], a[4], a[5] };
+                    set_rect_bounds(cmd, r, 1.0f);
+                    break;
+                }
+                case CMD_DRAW_MASK:
+                {
+                    ISurface *s         = get_surface(cmd_payload(cmd));
+                    float r[4]          = { a[4], a[5], float(s->width()), float(s->height()) };
+                    set_rect_bounds(cmd, r, 1.0f);
+                    break;
+                }
+
+                case CMD_FILL_RECT:
+                    set_rect_bounds(cmd, &a[4], 1.0f);
+                    break;
+                case CMD_FILL_RECT_GRADIENT:
+                    set_rect_bounds(cmd, &a[0], 1.0f);
+                    break;
+                case CMD_WIRE_RECT:
+                case CMD_FULL_RECT:
+                    set_rect_bounds(cmd, &a[4], a[8] * 0.5f + 1.0f);
+                    break;
+                case CMD_WIRE_RECT_GRADIENT:
+                    set_rect_bounds(cmd, &a[0], a[4] * 0.5f + 1.0f);
+                    break;
+                case CMD_WIRE_ROUND_RECT:
+                case CMD_WIRE_ROUND_RECT_INSIDE:
+                    set_rect_bounds(cmd, &a[5], a[9] * 0.5f + 1.0f);
+                    break;
+                case CMD_WIRE_ROUND_RECT_GRADIENT:
+                case CMD_WIRE_ROUND_RECT_INSIDE_GRADIENT:
+                    set_rect_bounds(cmd, &a[1], a[5] * 0.5f + 1.0f);
+                    break;
+                case CMD_FILL_ROUND_RECT:
+                case CMD_FILL_ROUND_RECT_AREA:
+                case CMD_FILL_ROUND_FRAME:
+                    set_rect_bounds(cmd, &a[5], 1.0f);
+                    break;
+                case CMD_FILL_ROUND_RECT_GRADIENT:
+                case CMD_FILL_ROUND_RECT_AREA_GRADIENT:
+                    set_rect_bounds(cmd, &a[1], 1.0f);
+                    break;
+                case CMD_FILL_FRAME:
+                    set_rect_bounds(cmd, &a[4], 1.0f);
+                    break;
+
+                case CMD_FILL_SECTOR:
+                case CMD_FILL_CIRCLE:
+                    set_bounds(cmd, a[4] - a[6] - 1.0f, a[5] - a[6] - 1.0f, a[4] + a[6] + 1.0f, a[5] + a[6] + 1.0f);
+                    break;
+                case CMD_FILL_CIRCLE_GRADIENT:
+                    set_bounds(cmd, a[0] - a[2] - 1.0f, a[1] - a[2] - 1.0f, a[0] + a[2] + 1.0f, a[1] + a[2] + 1.0f);
+                    break;
+                case CMD_WIRE_ARC:
+                {
+                    float r             = a[6] + a[9] * 0.5f + 1.0f;
+                    set_bounds(cmd, a[4] - r, a[5] - r, a[4] + r, a[5] + r);
+                    break;
+                }
+
+                case CMD_FILL_TRIANGLE:
+                case CMD_FILL_TRIANGLE_GRADIENT:
+                {
+                    const float *p      = (cmd->nCode == CMD_FILL_TRIANGLE) ? &a[4] : &a[0];
+                    set_bounds(cmd,
+                        lsp_min(p[0], lsp_min(p[2], p[4])) - 1.0f,
+                        lsp_min(p[1], lsp_min(p[3], p[5])) - 1.0f,
+                        lsp_max(p[0], lsp_max(p[2], p[4])) + 1.0f,
+                        lsp_max(p[1], lsp_max(p[3], p[5])) + 1.0f);
+                    break;
+                }
+
+                case CMD_SQUARE_DOT:
+                case CMD_SQUARE_DOT_RGBA:
+                {
+                    const float *p      = (cmd->nCode == CMD_SQUARE_DOT) ? &a[4] : &a[0];
+                    float r             = p[2] + 2.0f;
+                    set_bounds(cmd, p[0] - r, p[1] - r, p[0] + r, p[1] + r);
+                    break;
+                }
+
+                case CMD_LINE:
+                case CMD_LINE_GRADIENT:
+                {
+                    const float *p      = (cmd->nCode == CMD_LINE) ? &a[4] : &a[0];
+                    float border        = p[4] * 0.5f + 1.0f;
+                    set_bounds(cmd,
+                        lsp_min(p[0], p[2]) - border, lsp_min(p[1], p[3]) - border,
+                        lsp_max(p[0], p[2]) + border, lsp_max(p[1], p[3]) + border);
+                    break;
+                }
+
+                case CMD_PARAMETRIC_LINE_CLIPPED:
+                {
+                    float border        = a[11] * 0.5f + 1.0f;
+                    set_bounds(cmd,
+                        lsp_min(a[7], a[8]) - border, lsp_min(a[9], a[10]) - border,
+                        lsp_max(a[7], a[8]) + border, lsp_max(a[9], a[10]) + border);
+                    break;
+                }
+                case CMD_PARAMETRIC_BAR:
+                    set_bounds(cmd,
+                        lsp_min(a[6], a[7]) - 1.0f, lsp_min(a[8], a[9]) - 1.0f,
+                        lsp_max(a[6], a[7]) + 1.0f, lsp_max(a[8], a[9]) + 1.0f);
+                    break;
+
+                default:
+                    // Commands that affect the whole surface or the drawing state
+                    break;
+            }
+        }
+
+        void ProxySurface::record_poly(size_t code, const Color *c1, const Color *c2, IGradient *g, float width, const float *x, const float *y, size_t n)
+        {
+            if ((x == NULL) || (y == NULL) || (n <= 0))
+                return;
+
+            size_t gsize        = (g != NULL) ? gradient_size(g) : 0;
+            command_t *cmd      = add_command(code, 9, gsize + n * 2 * sizeof(float));
+            if (cmd == NULL)
+                return;
+
+            cmd->nParam         = n;
+            float *dst          = cmd_args(cmd);
+            for (size_t i=0; i<9; ++i)
+                dst[i]              = 0.0f;
+            if (c1 != NULL)
+                put_color(&dst[0], *c1);
+            if (c2 != NULL)
+                put_color(&dst[4], *c2);
+            dst[8]              = width;
+
+            uint8_t *payload    = cmd_payload(cmd);
+            if (g != NULL)
+                put_gradient(payload, g);
+
+            float *points       = reinterpret_cast<float *>(&payload[gsize]);
+            ::memcpy(&points[0], x, n * sizeof(float));
+            ::memcpy(&points[n], y, n * sizeof(float));
+
+            // Compute bounds of the polygon
+            float l = x[0], r = x[0], t = y[0], b = y[0];
+            for (size_t i=1; i<n; ++i)
+            {
+                l                   = lsp_min(l, x[i]);
+                r                   = lsp_max(r, x[i]);
+                t                   = lsp_min(t, y[i]);
+                b                   = lsp_max(b, y[i]);
+            }
+            float border        = width * 0.5f + 1.0f;
+            set_bounds(cmd, l - border, t - border, r + border, b + border);
+        }
+
+        void ProxySurface::record_path(size_t code, const Color *c, IGradient *g, float width, IPath *path, float x, float y)
+        {
+            float b[4];
+            if ((path == NULL) || (!path->get_bounds(b)))
+                return;
+
+            size_t gsize        = (g != NULL) ? gradient_size(g) : 0;
+            command_t *cmd      = add_command(code, 7, gsize + sizeof(IPath *));
+            if (cmd == NULL)
+                return;
+
+            float *dst          = cmd_args(cmd);
+            for (size_t i=0; i<4; ++i)
+                dst[i]              = 0.0f;
+            if (c != NULL)
+                put_color(&dst[0], *c);
+            dst[4]              = x;
+            dst[5]              = y;
+            dst[6]              = width;
+
+            uint8_t *payload    = cmd_payload(cmd);
+            if (g != NULL)
+                put_gradient(payload, g);
+            put_path(&payload[gsize], path);
+
+            // Bounds of the path include control points of splines
+            float border        = width * 0.5f + 1.0f;
+            set_bounds(cmd, x + b[0] - border, y + b[1] - border, x + b[2] + border, y + b[3] + border);
+        }
+
+        void ProxySurface::start_replay(ISurface *dst, replay_t *state)
+        {
+            state->bAntiAliasing    = dst->get_antialiasing();
+            state->enLineCap        = dst->get_line_cap();
+            state->bDecimation      = dst->get_decimation();
+            state->nClips           = 0;
+        }
+
+        void ProxySurface::finish_replay(ISurface *dst, replay_t *state)
+        {
+            // Restore the drawing state of the target surface
+            for ( ; state->nClips > 0; --state->nClips)
+                dst->clip_end();
+            dst->set_antialiasing(state->bAntiAliasing);
+            dst->set_line_cap(state->enLineCap);
+            dst->set_decimation(state->bDecimation);
+        }
+
+        void ProxySurface::replay(ISurface *dst)
+        {
+            if (dst == NULL)
+                return;
+
+            replay_t state;
+            start_replay(dst, &state);
+
+            for (chunk_t *c = pFirst; c != NULL; c = c->pNext)
+            {
+                const uint8_t *ptr  = reinterpret_cast<const uint8_t *>(c) + proxy_align(sizeof(chunk_t));
+                const uint8_t *end  = &ptr[c->nSize];
+
+                while (ptr < end)
+                {
+                    const command_t *cmd    = reinterpret_cast<const command_t *>(ptr);
+                    ptr                    += cmd->nSize;
+                    replay_command(dst, &state, cmd);
+                }
+            }
+
+            finish_replay(dst, &state);
+        }
+
+        bool ProxySurface::list_commands(lltl::parray<command_t> *list)
+        {
+            for (chunk_t *c = pFirst; c != NULL; c = c->pNext)
+            {
+                uint8_t *ptr        = reinterpret_cast<uint8_t *>(c) + proxy_align(sizeof(chunk_t));
+                uint8_t *end        = &ptr[c->nSize];
+
+                while (ptr < end)
+                {
+                    command_t *cmd      = reinterpret_cast<command_t *>(ptr);
+                    ptr                += cmd->nSize;
+                    if (!list->add(cmd))
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        void ProxySurface::replay(ISurface *dst, const command_t * const *list, size_t count)
+        {
+            replay_t state;
+            start_replay(dst, &state);
+
+            for (size_t i=0; i<count; ++i)
+                replay_command(dst, &state, list[i]);
+
+            finish_replay(dst, &state);
+        }
+
+        void ProxySurface::replay_command(ISurface *dst, replay_t *state, const command_t *cmd)
+        {
+            // Keep the clipping stack balanced
+            if (cmd->nCode == CMD_CLIP_BEGIN)
+                ++state->nClips;
+            else if (cmd->nCode == CMD_CLIP_END)
+            {
+                if (state->nClips <= 0)
+                    return;
+                --state->nClips;
+            }
+
+            const float *a          = cmd_args(cmd);
+            const uint8_t *payload  = cmd_payload(cmd);
+            ISurface *s             = NULL;
+            ISurface *tmp           = NULL;
+            IGradient *g            = NULL;
+
+            switch (cmd->nCode)
+            {
+                case CMD_DRAW:
+                case CMD_DRAW_SCALED:
+                case CMD_DRAW_FILTERED:
+                case CMD_DRAW_ALPHA:
+                case CMD_DRAW_ROTATE_ALPHA:
+                case CMD_DRAW_CLIPPED:
+                case CMD_DRAW_MASK:
+                    s                       = get_surface(payload);
+
+                    // Recorded surface should be rasterized first
+                    if (s->type() == ST_PROXY)
+                    {
+                        if ((tmp = dst->create(s->width(), s->height())) == NULL)
+                            return;
+                        tmp->begin();
+                        static_cast<ProxySurface *>(s)->replay(tmp);
+                        tmp->end();
+                        s                       = tmp;
+                    }
+                    break;
+
+                case CMD_FILL_RECT_GRADIENT:
+                case CMD_WIRE_RECT_GRADIENT:
+                case CMD_WIRE_ROUND_RECT_GRADIENT:
+                case CMD_WIRE_ROUND_RECT_INSIDE_GRADIENT:
+                case CMD_FILL_ROUND_RECT_GRADIENT:
+                case CMD_FILL_ROUND_RECT_AREA_GRADIENT:
+                case CMD_FILL_TRIANGLE_GRADIENT:
+                case CMD_LINE_GRADIENT:
+                case CMD_PARAMETRIC_BAR:
+                case CMD_FILL_POLY_GRADIENT:
+                case CMD_FILL_CIRCLE_GRADIENT:
+                case CMD_FILL_PATH_GRADIENT:
+                    if ((g = get_gradient(dst, payload)) == NULL)
+                        return;
+                    break;
+
+                default:
+                    break;
+            }
+
+            switch (cmd->nCode)
+            {
+                case CMD_DRAW:
+                    dst->draw(s, a[0], a[1]);
+                    break;
+                case CMD_DRAW_SCALED:
+                    dst->draw(s, a[0], a[1], a[2], a[3]);
+                    break;
+                case CMD_DRAW_FILTERED:
+                    dst->draw(s, a[0], a[1], a[2], a[3], surface_filter_t(cmd->nParam));
+                    break;
+                case CMD_DRAW_ALPHA:
+                    dst->draw_alpha(s, a[0], a[1], a[2], a[3], a[4]);
+                    break;
+                case CMD_DRAW_ROTATE_ALPHA:
+                    dst->draw_rotate_alpha(s, a[0], a[1], a[2], a[3], a[4], a[5]);
+                    break;
+                case CMD_DRAW_CLIPPED:
+                    dst->draw_clipped(s, a[0], a[1], a[2], a[3], a[4], a[5]);
+                    break;
+                case CMD_DRAW_MASK:
+                    dst->draw_mask(get_color(a), s, a[4], a[5]);
+                    break;
+
+                case CMD_FILL_RECT:
+                    dst->fill_rect(get_color(a), a[4], a[5], a[6], a[7]);
+                    break;
+                case CMD_FILL_RECT_GRADIENT:
+                    dst->fill_rect(g, a[0], a[1], a[2], a[3]);
+                    break;
+                case CMD_WIRE_RECT:
+                    dst->wire_rect(get_color(a), a[4], a[5], a[6], a[7], a[8]);
+                    break;
+                case CMD_WIRE_RECT_GRADIENT:
+                    dst->wire_rect(g, a[0], a[1], a[2], a[3], a[4]);
+                    break;
+                case CMD_WIRE_ROUND_RECT:
+                    dst->wire_round_rect(get_color(a), cmd->nParam, a[4], a[5], a[6], a[7], a[8], a[9]);
+                    break;
+                case CMD_WIRE_ROUND_RECT_GRADIENT:
+                    dst->wire_round_rect(g, cmd->nParam, a[0], a[1], a[2], a[3], a[4], a[5]);
+                    break;
+                case CMD_WIRE_ROUND_RECT_INSIDE:
+                    dst->wire_round_rect_inside(get_color(a), cmd->nParam, a[4], a[5], a[6], a[7], a[8], a[9]);
+                    break;
+                case CMD_WIRE_ROUND_RECT_INSIDE_GRADIENT:
+                    dst->wire_round_rect_inside(g, cmd->nParam, a[0], a[1], a[2], a[3], a[4], a[5]);
+                    break;
+                case CMD_FILL_ROUND_RECT:
+                    dst->fill_round_rect(get_color(a), cmd->nParam, a[4], a[5], a[6], a[7], a[8]);
+                    break;
+                case CMD_FILL_ROUND_RECT_AREA:
+                {
+                    rectangle_t r;
+                    r.nLeft                 = a[5];
+                    r.nTop                  = a[6];
+                    r.nWidth                = a[7];
+                    r.nHeight               = a[8];
+                    dst->fill_round_rect(get_color(a), cmd->nParam, a[4], &r);
+                    break;
+                }
+                case CMD_FILL_ROUND_RECT_GRADIENT:
+                    dst->fill_round_rect(g, cmd->nParam, a[0], a[1], a[2], a[3], a[4]);
+                    break;
+                case CMD_FILL_ROUND_RECT_AREA_GRADIENT:
+                {
+                    rectangle_t r;
+                    r.nLeft                 = a[1];
+                    r.nTop                  = a[2];
+                    r.nWidth                = a[3];
+                    r.nHeight               = a[4];
+                    dst->fill_round_rect(g, cmd->nParam, a[0], &r);
+                    break;
+                }
+                case CMD_FULL_RECT:
+                    dst->full_rect(a[4], a[5], a[6], a[7], a[8], get_color(a));
+                    break;
+                case CMD_FILL_SECTOR:
+                    dst->fill_sector(a[4], a[5], a[6], a[7], a[8], get_color(a));
+                    break;
+                case CMD_FILL_TRIANGLE:
+                    dst->fill_triangle(a[4], a[5], a[6], a[7], a[8], a[9], get_color(a));
+                    break;
+                case CMD_FILL_TRIANGLE_GRADIENT:
+                    dst->fill_triangle(a[0], a[1], a[2], a[3], a[4], a[5], g);
+                    break;
+
+                case CMD_CLEAR:
+                    dst->clear(get_color(a));
+                    break;
+                case CMD_CLEAR_RGB:
+                    dst->clear_rgb(cmd->nParam);
+                    break;
+                case CMD_CLEAR_RGBA:
+                    dst->clear_rgba(cmd->nParam);
+                    break;
+
+                case CMD_OUT_TEXT:
+                    dst->out_text(*vFonts.uget(cmd->nParam), get_color(a), a[4], a[5],
+                        reinterpret_cast<const char *>(payload));
+                    break;
+                case CMD_OUT_TEXT_RELATIVE:
+                    dst->out_text_relative(*vFonts.uget(cmd->nParam), get_color(a), a[4], a[5], a[6], a[7],
+                        reinterpret_cast<const char *>(payload));
+                    break;
+
+                case CMD_SQUARE_DOT:
+                    dst->square_dot(a[4], a[5], a[6], get_color(a));
+                    break;
+                case CMD_SQUARE_DOT_RGBA:
+                    dst->square_dot(a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+                    break;
+                case CMD_LINE:
+                    dst->line(a[4], a[5], a[6], a[7], a[8], get_color(a));
+                    break;
+                case CMD_LINE_GRADIENT:
+                    dst->line(a[0], a[1], a[2], a[3], a[4], g);
+                    break;
+                case CMD_DRAW_LINES:
+                {
+                    size_t n                = cmd->nParam;
+                    const float *p          = reinterpret_cast<const float *>(payload);
+                    dst->draw_lines(&p[0], &p[n], &p[n*2], &p[n*3], n, a[4], get_color(a));
+                    break;
+                }
+                case CMD_DRAW_POLYLINES:
+                {
+                    size_t n                = cmd->nParam;
+                    const size_t *count     = reinterpret_cast<const size_t *>(payload);
+                    const float *x          = reinterpret_cast<const float *>(&payload[proxy_align(n * sizeof(size_t))]);
+                    size_t points           = 0;
+                    for (size_t i=0; i<n; ++i)
+                        points                 += count[i];
+                    dst->draw_polylines(x, &x[points], count, n, a[4], get_color(a));
+                    break;
+                }
+                case CMD_PARAMETRIC_LINE:
+                    dst->parametric_line(a[4], a[5], a[6], a[7], get_color(a));
+                    break;
+                case CMD_PARAMETRIC_LINE_CLIPPED:
+                    dst->parametric_line(a[4], a[5], a[6], a[7], a[8], a[9], a[10], a[11], get_color(a));
+                    break;
+                case CMD_PARAMETRIC_BAR:
+                    dst->parametric_bar(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9], g);
+                    break;
+                case CMD_WIRE_ARC:
+                    dst->wire_arc(a[4], a[5], a[6], a[7], a[8], a[9], get_color(a));
+                    break;
+                case CMD_FILL_FRAME:
+                    dst->fill_frame(get_color(a), a[4], a[5], a[6], a[7], a[8], a[9], a[10], a[11]);
+                    break;
+                case CMD_FILL_ROUND_FRAME:
+                    dst->fill_round_frame(get_color(a), a[4], cmd->nParam, a[5], a[6], a[7], a[8], a[9], a[10], a[11], a[12]);
+                    break;
+
+                case CMD_FILL_POLY:
+                case CMD_FILL_POLY_GRADIENT:
+                case CMD_WIRE_POLY:
+                case CMD_DRAW_POLY:
+                {
+                    size_t n                = cmd->nParam;
+                    size_t gsize            = (g != NULL) ? sizeof(gradient_t) + reinterpret_cast<const gradient_t *>(payload)->nStops * sizeof(ProxyGradient::stop_t) : 0;
+                    const float *x          = reinterpret_cast<const float *>(&payload[gsize]);
+                    const float *y          = &x[n];
+
+                    if (cmd->nCode == CMD_FILL_POLY)
+                        dst->fill_poly(get_color(&a[0]), x, y, n);
+                    else if (cmd->nCode == CMD_FILL_POLY_GRADIENT)
+                        dst->fill_poly(g, x, y, n);
+                    else if (cmd->nCode == CMD_WIRE_POLY)
+                        dst->wire_poly(get_color(&a[4]), a[8], x, y, n);
+                    else
+                        dst->draw_poly(get_color(&a[0]), get_color(&a[4]), a[8], x, y, n);
+                    break;
+                }
+
+                case CMD_FILL_PATH:
+                case CMD_FILL_PATH_GRADIENT:
+                case CMD_WIRE_PATH:
+                {
+                    size_t gsize            = (g != NULL) ? sizeof(gradient_t) + reinterpret_cast<const gradient_t *>(payload)->nStops * sizeof(ProxyGradient::stop_t) : 0;
+                    IPath *path             = get_path(&payload[gsize]);
+
+                    if (cmd->nCode == CMD_FILL_PATH)
+                        dst->fill_path(get_color(a), path, a[4], a[5]);
+                    else if (cmd->nCode == CMD_FILL_PATH_GRADIENT)
+                        dst->fill_path(g, path, a[4], a[5]);
+                    else
+                        dst->wire_path(get_color(a), a[6], path, a[4], a[5]);
+                    break;
+                }
+
+                case CMD_FILL_CIRCLE:
+                    dst->fill_circle(a[4], a[5], a[6], get_color(a));
+                    break;
+                case CMD_FILL_CIRCLE_GRADIENT:
+                    dst->fill_circle(a[0], a[1], a[2], g);
+                    break;
+
+                case CMD_CLIP_BEGIN:
+                    dst->clip_begin(a[0], a[1], a[2], a[3]);
+                    break;
+                case CMD_CLIP_END:
+                    dst->clip_end();
+                    break;
+                case CMD_SET_ANTIALIASING:
+                    dst->set_antialiasing(cmd->nParam);
+                    break;
+                case CMD_SET_LINE_CAP:
+                    dst->set_line_cap(surf_line_cap_t(cmd->nParam));
+                    break;
+                case CMD_SET_DECIMATION:
+                    dst->set_decimation(cmd->nParam);
+                    break;
+
+                default:
+                    break;
+            }
+
+            if (g != NULL)
+                delete g;
+            if (tmp != NULL)
+            {
+                tmp->destroy();
+                delete tmp;
+            }
+        }
+
+        ISurface *ProxySurface::create(size_t width, size_t height)
+        {
+            return new ProxySurface(pRef, width, height);
+        }
+
+        ISurface *ProxySurface::create(size_t width, size_t height, surface_format_t format)
+        {
+            // Recorded commands do not depend on the pixel format
+            return new ProxySurface(pRef, width, height);
+        }
+
+        ISurface *ProxySurface::create_copy()
+        {
+            ProxySurface *s = new ProxySurface(pRef, nWidth, nHeight);
+            if (s != NULL)
+                replay(s);
+            return s;
+        }
+
+        IGradient *ProxySurface::linear_gradient(float x0, float y0, float x1, float y1)
+        {
+            return new ProxyGradient(x0, y0, x1, y1);
+        }
+
+        IGradient *ProxySurface::radial_gradient(float cx0, float cy0, float r0, float cx1, float cy1, float r1)
+        {
+            return new ProxyGradient(cx0, cy0, r0, cx1, cy1, r1);
+        }
+
+        IPath *ProxySurface::create_path()
+        {
+            // Paths are replayed as is, so they should be native for the target surface
+            return (pRef != NULL) ? pRef->create_path() : NULL;
+        }
+
+        void ProxySurface::begin()
+        {
+            // Start recording of the new frame
+            reset();
+            bAntiAliasing   = true;
+            enLineCap       = SURFLCAP_BUTT;
+            bDecimation     = false;
+        }
+
+        void ProxySurface::end()
+        {
+        }
+
+        void ProxySurface::draw(ISurface *s, float x, float y)
+        {
+            float args[] = { x, y };
+            record_draw(CMD_DRAW, s, args, 2);
+        }
+
+        void ProxySurface::draw(ISurface *s, float x, float y, float sx, float sy)
+        {
+            float args[] = { x, y, sx, sy };
+            record_draw(CMD_DRAW_SCALED, s, args, 4);
+        }
+
+        void ProxySurface::draw(ISurface *s, float x, float y, float sx, float sy, surface_filter_t filter)
+        {
+            if (s == NULL)
+                return;
+
+            command_t *cmd      = add_command(CMD_DRAW_FILTERED, 4, sizeof(ISurface *));
+            if (cmd == NULL)
+                return;
+
+            float *dst          = cmd_args(cmd);
+            dst[0]              = x;
+            dst[1]              = y;
+            dst[2]              = sx;
+            dst[3]              = sy;
+            cmd->nParam         = filter;
+            put_surface(cmd_payload(cmd), s);
+            update_bounds(cmd);
+        }
+
+        void ProxySurface::draw_alpha(ISurface *s, float x, float y, float sx, float sy, float a)
+        {
+            float args[] = { x, y, sx, sy, a };
+            record_draw(CMD_DRAW_ALPHA, s, args, 5);
+        }
+
+        void ProxySurface::draw_rotate_alpha(ISurface *s, float x, float y, float sx, float sy, float ra, float a)
+        {
+            float args[] = { x, y, sx, sy, ra, a };
+            record_draw(CMD_DRAW_ROTATE_ALPHA, s, args, 6);
+        }
+
+        void ProxySurface::draw_clipped(ISurface *s, float x, float y, float sx, float sy, float sw, float sh)
+        {
+            float args[] = { x, y, sx, sy, sw, sh };
+            record_draw(CMD_DRAW_CLIPPED, s, args, 6);
+        }
+
+        void ProxySurface::draw_mask(const Color &color, ISurface *mask, float x, float y)
+        {
+            if (mask == NULL)
+                return;
+
+            command_t *cmd      = add_command(CMD_DRAW_MASK, 6, sizeof(ISurface *));
+            if (cmd == NULL)
+                return;
+
+            float *dst          = put_color(cmd_args(cmd), color);
+            dst[0]              = x;
+            dst[1]              = y;
+            put_surface(cmd_payload(cmd), mask);
+            update_bounds(cmd);
+        }
+
+        void ProxySurface::fill_rect(const Color &color, float left, float top, float width, float height)
+        {
+            float args[] = { left, top, width, height };
+            record_color(CMD_FILL_RECT, color, 0, args, 4);
+        }
+
+        void ProxySurface::fill_rect(IGradient *g, float left, float top, float width, float height)
+        {
+            float args[] = { left, top, width, height };
+            record_gradient(CMD_FILL_RECT_GRADIENT, g, 0, args, 4);
+        }
+
+        void ProxySurface::wire_rect(const Color &color, float left, float top, float width, float height, float line_width)
+        {
+            float args[] = { left, top, width, height, line_width };
+            record_color(CMD_WIRE_RECT, color, 0, args, 5);
+        }
+
+        void ProxySurface::wire_rect(IGradient *g, float left, float top, float width, float height, float line_width)
+        {
+            float args[] = { left, top, width, height, line_width };
+            record_gradient(CMD_WIRE_RECT_GRADIENT, g, 0, args, 5);
+        }
+
+        void ProxySurface::wire_round_rect(const Color &c, size_t mask, float radius, float left, float top, float width, float height, float line_width)
+        {
+            float args[] = { radius, left, top, width, height, line_width };
+            record_color(CMD_WIRE_ROUND_RECT, c, mask, args, 6);
+        }
+
+        void ProxySurface::wire_round_rect(IGradient *g, size_t mask, float radius, float left, float top, float width, float height, float line_width)
+        {
+            float args[] = { radius, left, top, width, height, line_width };
+            record_gradient(CMD_WIRE_ROUND_RECT_GRADIENT, g, mask, args, 6);
+        }
+
+        void ProxySurface::wire_round_rect_inside(const Color &c, size_t mask, float radius, float left, float top, float width, float height, float line_width)
+        {
+            float args[] = { radius, left, top, width, height, line_width };
+            record_color(CMD_WIRE_ROUND_RECT_INSIDE, c, mask, args, 6);
+        }
+
+        void ProxySurface::wire_round_rect_inside(IGradient *g, size_t mask, float radius, float left, float top, float width, float height, float line_width)
+        {
+            float args[] = { radius, left, top, width, height, line_width };
+            record_gradient(CMD_WIRE_ROUND_RECT_INSIDE_GRADIENT, g, mask, args, 6);
+        }
+
+        void ProxySurface::fill_round_rect(const Color &color, size_t mask, float radius, float left, float top, float width, float height)
+        {
+            float args[] = { radius, left, top, width, height };
+            record_color(CMD_FILL_ROUND_RECT, color, mask, args, 5);
+        }
+
+        void ProxySurface::fill_round_rect(const Color &color, size_t mask, float radius, const ws::rectangle_t *r)
+        {
+            float args[] = { radius, float(r->nLeft), float(r->nTop), float(r->nWidth), float(r->nHeight) };
+            record_color(CMD_FILL_ROUND_RECT_AREA, color, mask, args, 5);
+        }
+
+        void ProxySurface::fill_round_rect(IGradient *g, size_t mask, float radius, float left, float top, float width, float height)
+        {
+            float args[] = { radius, left, top, width, height };
+            record_gradient(CMD_FILL_ROUND_RECT_GRADIENT, g, mask, args, 5);
+        }
+
+        void ProxySurface::fill_round_rect(IGradient *g, size_t mask, float radius, const ws::rectangle_t *r)
+        {
+            float args[] = { radius, float(r->nLeft), float(r->nTop), float(r->nWidth), float(r->nHeight) };
+            record_gradient(CMD_FILL_ROUND_RECT_AREA_GRADIENT, g, mask, args, 5);
+        }
+
+        void ProxySurface::full_rect(float left, float top, float width, float height, float line_width, const Color &color)
+        {
+            float args[] = { left, top, width, height, line_width };
+            record_color(CMD_FULL_RECT, color, 0, args, 5);
+        }
+
+        void ProxySurface::fill_sector(float cx, float cy, float radius, float angle1, float angle2, const Color &color)
+        {
+            float args[] = { cx, cy, radius, angle1, angle2 };
+            record_color(CMD_FILL_SECTOR, color, 0, args, 5);
+        }
+
+        void ProxySurface::fill_triangle(float x0, float y0, float x1, float y1, float x2, float y2, IGradient *g)
+        {
+            float args[] = { x0, y0, x1, y1, x2, y2 };
+            record_gradient(CMD_FILL_TRIANGLE_GRADIENT, g, 0, args, 6);
+        }
+
+        void ProxySurface::fill_triangle(float x0, float y0, float x1, float y1, float x2, float y2, const Color &color)
+        {
+            float args[] = { x0, y0, x1, y1, x2, y2 };
+            record_color(CMD_FILL_TRIANGLE, color, 0, args, 6);
+        }
+
+        bool ProxySurface::get_font_parameters(const Font &f, font_parameters_t *fp)
+        {
+            return (pRef != NULL) ? pRef->get_font_parameters(f, fp) : false;
+        }
+
+        bool ProxySurface::get_text_parameters(const Font &f, text_parameters_t *tp, const char *text)
+        {
+            return (pRef != NULL) ? pRef->get_text_parameters(f, tp, text) : false;
+        }
+
+        bool ProxySurface::get_text_parameters(const Font &f, text_parameters_t *tp, const LSPString *text, ssize_t first, ssize_t last)
+        {
+            return (pRef != NULL) ? pRef->get_text_parameters(f, tp, text, first, last) : false;
+        }
+
+        void ProxySurface::clear(const Color &color)
+        {
+            record_color(CMD_CLEAR, color, 0, NULL, 0);
+        }
+
+        void ProxySurface::clear_rgb(uint32_t color)
+        {
+            command_t *cmd      = add_command(CMD_CLEAR_RGB, 0, 0);
+            if (cmd != NULL)
+                cmd->nParam         = color;
+        }
+
+        void ProxySurface::clear_rgba(uint32_t color)
+        {
+            command_t *cmd      = add_command(CMD_CLEAR_RGBA, 0, 0);
+            if (cmd != NULL)
+                cmd->nParam         = color;
+        }
+
+        void ProxySurface::out_text(const Font &f, const Color &color, float x, float y, const char *text)
+        {
+            record_text(CMD_OUT_TEXT, f, color, x, y, 0.0f, 0.0f, text);
+        }
+
+        void ProxySurface::out_text(const Font &f, const Color &color, float x, float y, const LSPString *text, ssize_t first, ssize_t last)
+        {
+            if (text == NULL)
+                return;
+            record_text(CMD_OUT_TEXT, f, color, x, y, 0.0f, 0.0f, text->get_utf8(first, last));
+        }
+
+        void ProxySurface::out_text_relative(const Font &f, const Color &color, float x, float y, float dx, float dy, const char *text)
+        {
+            record_text(CMD_OUT_TEXT_RELATIVE, f, color, x, y, dx, dy, text);
+        }
+
+        void ProxySurface::out_text_relative(const Font &f, const Color &color, float x, float y, float dx, float dy, const LSPString *text, ssize_t first, ssize_t last)
+        {
+            if (text == NULL)
+                return;
+            record_text(CMD_OUT_TEXT_RELATIVE, f, color, x, y, dx, dy, text->get_utf8(first, last));
+        }
+
+        void ProxySurface::square_dot(float x, float y, float width, const Color &color)
+        {
+            float args[] = { x, y, width };
+            record_color(CMD_SQUARE_DOT, color, 0, args, 3);
+        }
+
+        void ProxySurface::square_dot(float x, float y, float width, float r, float g, float b, float a)
+        {
+            float *dst = add_args(CMD_SQUARE_DOT_RGBA, 7);
+            if (dst == NULL)
+                return;
+
+            dst[0]  = x;
+            dst[1]  = y;
+            dst[2]  = width;
+            dst[3]  = r;
+            dst[4]  = g;
+            dst[5]  = b;
+            dst[6]  = a;
+        }
+
+        void ProxySurface::line(float x0, float y0, float x1, float y1, float width, const Color &color)
+        {
+            float args[] = { x0, y0, x1, y1, width };
+            record_color(CMD_LINE, color, 0, args, 5);
+        }
+
+        void ProxySurface::line(float x0, float y0, float x1, float y1, float width, IGradient *g)
+        {
+            float args[] = { x0, y0, x1, y1, width };
+            record_gradient(CMD_LINE_GRADIENT, g, 0, args, 5);
+        }
+
+        void ProxySurface::draw_lines(const float *x0, const float *y0, const float *x1, const float *y1, size_t n, float width, const Color &color)
+        {
+            if ((x0 == NULL) || (y0 == NULL) || (x1 == NULL) || (y1 == NULL) || (n <= 0))
+                return;
+
+            command_t *cmd      = add_command(CMD_DRAW_LINES, 5, n * 4 * sizeof(float));
+            if (cmd == NULL)
+                return;
+
+            cmd->nParam         = n;
+            float *dst          = cmd_args(cmd);
+            put_color(dst, color);
+            dst[4]              = width;
+
+            float *points       = reinterpret_cast<float *>(cmd_payload(cmd));
+            ::memcpy(&points[0], x0, n * sizeof(float));
+            ::memcpy(&points[n], y0, n * sizeof(float));
+            ::memcpy(&points[n*2], x1, n * sizeof(float));
+            ::memcpy(&points[n*3], y1, n * sizeof(float));
+
+            // Compute bounds of all segments
+            float l = x0[0], r = x0[0], t = y0[0], b = y0[0];
+            for (size_t i=0; i<n; ++i)
+            {
+                l                   = lsp_min(l, lsp_min(x0[i], x1[i]));
+                r                   = lsp_max(r, lsp_max(x0[i], x1[i]));
+                t                   = lsp_min(t, lsp_min(y0[i], y1[i]));
+                b                   = lsp_max(b, lsp_max(y0[i], y1[i]));
+            }
+            float border        = width * 0.5f + 1.0f;
+            set_bounds(cmd, l - border, t - border, r + border, b + border);
+        }
+
+        void ProxySurface::draw_polylines(const float *x, const float *y, const size_t *count, size_t n, float width, const Color &color)
+        {
+            if ((x == NULL) || (y == NULL) || (count == NULL) || (n <= 0))
+                return;
+
+            size_t points       = 0;
+            for (size_t i=0; i<n; ++i)
+                points             += count[i];
+            if (points <= 0)
+                return;
+
+            size_t csize        = proxy_align(n * sizeof(size_t));
+            command_t *cmd      = add_command(CMD_DRAW_POLYLINES, 5, csize + points * 2 * sizeof(float));
+            if (cmd == NULL)
+                return;
+
+            cmd->nParam         = n;
+            float *dst          = cmd_args(cmd);
+            put_color(dst, color);
+            dst[4]              = width;
+
+            uint8_t *payload    = cmd_payload(cmd);
+            float *px           = reinterpret_cast<float *>(&payload[csize]);
+            ::memcpy(payload, count, n * sizeof(size_t));
+            ::memcpy(&px[0], x, points * sizeof(float));
+            ::memcpy(&px[points], y, points * sizeof(float));
+
+            // Compute bounds of all polylines
+            float l = x[0], r = x[0], t = y[0], b = y[0];
+            for (size_t i=1; i<points; ++i)
+            {
+                l                   = lsp_min(l, x[i]);
+                r                   = lsp_max(r, x[i]);
+                t                   = lsp_min(t, y[i]);
+                b                   = lsp_max(b, y[i]);
+            }
+            float border        = width * 0.5f + 1.0f;
+            set_bounds(cmd, l - border, t - border, r + border, b + border);
+        }
+
+        void ProxySurface::parametric_line(float a, float b, float c, float width, const Color &color)
+        {
+            float args[] = { a, b, c, width };
+            record_color(CMD_PARAMETRIC_LINE, color, 0, args, 4);
+        }
+
+        void ProxySurface::parametric_line(float a, float b, float c, float left, float right, float top, float bottom, float width, const Color &color)
+        {
+            float args[] = { a, b, c, left, right, top, bottom, width };
+            record_color(CMD_PARAMETRIC_LINE_CLIPPED, color, 0, args, 8);
+        }
+
+        void ProxySurface::parametric_bar(float a1, float b1, float c1, float a2, float b2, float c2,
+                float left, float right, float top, float bottom, IGradient *gr)
+        {
+            float args[] = { a1, b1, c1, a2, b2, c2, left, right, top, bottom };
+            record_gradient(CMD_PARAMETRIC_BAR, gr, 0, args, 10);
+        }
+
+        void ProxySurface::wire_arc(float x, float y, float r, float a1, float a2, float width, const Color &color)
+        {
+            float args[] = { x, y, r, a1, a2, width };
+            record_color(CMD_WIRE_ARC, color, 0, args, 6);
+        }
+
+        void ProxySurface::fill_frame(const Color &color,
+                float fx, float fy, float fw, float fh,
+                float ix, float iy, float iw, float ih)
+        {
+            float args[] = { fx, fy, fw, fh, ix, iy, iw, ih };
+            record_color(CMD_FILL_FRAME, color, 0, args, 8);
+        }
+
+        void ProxySurface::fill_round_frame(const Color &color, float radius, size_t flags,
+                float fx, float fy, float fw, float fh,
+                float ix, float iy, float iw, float ih)
+        {
+            float args[] = { radius, fx, fy, fw, fh, ix, iy, iw, ih };
+            record_color(CMD_FILL_ROUND_FRAME, color, flags, args, 9);
+        }
+
+        void ProxySurface::fill_path(const Color &color, IPath *path, float x, float y)
+        {
+            record_path(CMD_FILL_PATH, &color, NULL, 0.0f, path, x, y);
+        }
+
+        void ProxySurface::fill_path(IGradient *g, IPath *path, float x, float y)
+        {
+            if (g != NULL)
+                record_path(CMD_FILL_PATH_GRADIENT, NULL, g, 0.0f, path, x, y);
+        }
+
+        void ProxySurface::wire_path(const Color &color, float width, IPath *path, float x, float y)
+        {
+            record_path(CMD_WIRE_PATH, &color, NULL, width, path, x, y);
+        }
+
+        void ProxySurface::fill_poly(const Color & color, const float *x, const float *y, size_t n)
+        {
+            record_poly(CMD_FILL_POLY, &color, NULL, NULL, 0.0f, x, y, n);
+        }
+
+        void ProxySurface::fill_poly(IGradient *gr, const float *x, const float *y, size_t n)
+        {
+            if (gr != NULL)
+                record_poly(CMD_FILL_POLY_GRADIENT, NULL, NULL, gr, 0.0f, x, y, n);
+        }
+
+        void ProxySurface::wire_poly(const Color & color, float width, const float *x, const float *y, size_t n)
+        {
+            record_poly(CMD_WIRE_POLY, NULL, &color, NULL, width, x, y, n);
+        }
+
+        void ProxySurface::draw_poly(const Color &fill, const Color &wire, float width, const float *x, const float *y, size_t n)
+        {
+            record_poly(CMD_DRAW_POLY, &fill, &wire, NULL, width, x, y, n);
+        }
+
+        void ProxySurface::fill_circle(float x, float y, float r, const Color & color)
+        {
+            float args[] = { x, y, r };
+            record_color(CMD_FILL_CIRCLE, color, 0, args, 3);
+        }
+
+        void ProxySurface::fill_circle(float x, float y, float r, IGradient *g)
+        {
+            float args[] = { x, y, r };
+            record_gradient(CMD_FILL_CIRCLE_GRADIENT, g, 0, args, 3);
+        }
+
+        void ProxySurface::clip_begin(float x, float y, float w, float h)
+        {
+            float *dst = add_args(CMD_CLIP_BEGIN, 4);
+            if (dst == NULL)
+                return;
+
+            dst[0]  = x;
+            dst[1]  = y;
+            dst[2]  = w;
+            dst[3]  = h;
+        }
+
+        void ProxySurface::clip_end()
+        {
+            add_args(CMD_CLIP_END, 0);
+        }
+
+        bool ProxySurface::get_antialiasing()
+        {
+            return bAntiAliasing;
+        }
+
+        bool ProxySurface::set_antialiasing(bool set)
+        {
+            command_t *cmd      = add_command(CMD_SET_ANTIALIASING, 0, 0);
+            if (cmd != NULL)
+                cmd->nParam         = set;
+
+            bool old            = bAntiAliasing;
+            bAntiAliasing       = set;
+            return old;
+        }
+
+        bool ProxySurface::get_decimation()
+        {
+            return bDecimation;
+        }
+
+        bool ProxySurface::set_decimation(bool enable)
+        {
+            command_t *cmd      = add_command(CMD_SET_DECIMATION, 0, 0);
+            if (cmd != NULL)
+                cmd->nParam         = enable;
+
+            bool old            = bDecimation;
+            bDecimation         = enable;
+            return old;
+        }
+
+        surf_line_cap_t ProxySurface::get_line_cap()
+        {
+            return enLineCap;
+        }
+
+        surf_line_cap_t ProxySurface::set_line_cap(surf_line_cap_t lc)
+        {
+            command_t *cmd      = add_command(CMD_SET_LINE_CAP, 0, 0);
+            if (cmd != NULL)
+                cmd->nParam         = lc;
+
+            surf_line_cap_t old = enLineCap;
+            enLineCap           = lc;
+            return old;
+        }
+    }
+}
@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/ws/SpriteAtlas.h>
+#include <lsp-plug.in/ws/IDisplay.h>
+
+#define ATLAS_PADDING           1
+
+namespace lsp
+{
+    namespace ws
+    {
+        SpriteAtlas::SpriteAtlas(IDisplay *dpy, size_t width, size_t height)
+        {
+            pDisplay        = dpy;
+            nPageWidth      = width;
+            nPageHeight     = height;
+            nPadding        = ATLAS_PADDING;
+        }
+
+        SpriteAtlas::~SpriteAtlas()
+        {
+            clear();
+            pDisplay        = NULL;
+        }
+
+        void SpriteAtlas::clear()
+        {
+            for (size_t i=0, n=vPages.size(); i<n; ++i)
+            {
+                page_t *p = vPages.uget(i);
+                if (p == NULL)
+                    continue;
+
+                if (p->pSurface != NULL)
+                {
+                    p->pSurface->destroy();
+                    delete p->pSurface;
+                    p->pSurface     = NULL;
+                }
+                p->vSkyline.flush();
+                delete p;
+            }
+            vPages.flush();
+            vBatch.flush();
+        }
+
+        ISurface *SpriteAtlas::page(size_t index)
+        {
+            page_t *p = vPages.get(index);
+            return (p != NULL) ? p->pSurface : NULL;
+        }
+
+        SpriteAtlas::page_t *SpriteAtlas::create_page()
+        {
+            if (pDisplay == NULL)
+                return NULL;
+
+            page_t *p       = new page_t;
+            if (p == NULL)
+                return NULL;
+
+            p->pSurface     = pDisplay->create_surface(nPageWidth, nPageHeight);
+            skyline_t *s    = p->vSkyline.add();
+            if ((p->pSurface == NULL) || (s == NULL) || (!vPages.add(p)))
+            {
+                if (p->pSurface != NULL)
+                {
+                    p->pSurface->destroy();
+                    delete p->pSurface;
+                }
+                delete p;
+                return NULL;
+            }
+
+            s->nLeft        = 0;
+            s->nTop         = 0;
+            s->nWidth       = nPageWidth;
+
+            return p;
+        }
+
+        bool SpriteAtlas::pack(page_t *page, ssize_t width, ssize_t height, ssize_t *left, ssize_t *top)
+        {
+            lltl::darray<skyline_t> &sky = page->vSkyline;
+            ssize_t pw = nPageWidth, ph = nPageHeight;
+
+            // Lookup for the segment which gives the lowest top edge of the image,
+            // prefer the narrowest segment for equal heights
+            ssize_t index = -1, best_y = 0, best_w = 0;
+            for (size_t i=0, n=sky.size(); i<n; ++i)
+            {
+                skyline_t *s    = sky.uget(i);
+                if (s->nLeft + width > pw)
+                    break;
+
+                ssize_t y       = 0;
+                ssize_t rem     = width;
+                for (size_t j=i; (rem > 0) && (j < n); ++j)
+                {
+                    skyline_t *x    = sky.uget(j);
+                    y               = lsp_max(y, x->nTop);
+                    rem            -= x->nWidth;
+                }
+                if ((y + height > ph) || (rem > 0))
+                    continue;
+
+                if ((index < 0) || (y + height < best_y) || ((y + height == best_y) && (s->nWidth < best_w)))
+                {
+                    index           = i;
+                    best_y          = y + height;
+                    best_w          = s->nWidth;
+                }
+            }
+
+            if (index < 0)
+                return false;
+
+            // Insert new segment and cut off segments covered by the image
+            skyline_t *s    = sky.insert(index);
+            if (s == NULL)
+                return false;
+            s->nLeft        = sky.uget(index + 1)->nLeft;
+            s->nTop         = best_y;
+            s->nWidth       = width;
+
+            *left           = s->nLeft;
+            *top            = best_y - height;
+
+            ssize_t right   = s->nLeft + s->nWidth;
+            for (size_t i=index + 1; i < sky.size(); )
+            {
+                skyline_t *x    = sky.uget(i);
+                if (x->nLeft >= right)
+                    break;
+
+                ssize_t cut     = right - x->nLeft;
+                x->nLeft       += cut;
+                x->nWidth      -= cut;
+                if (x->nWidth > 0)
+                    break;
+                sky.remove(i);
+            }
+
+            // Merge segments of the same height
+            for (size_t i=1; i < sky.size(); )
+            {
+                skyline_t *p    = sky.uget(i - 1);
+                skyline_t *x    = sky.uget(i);
+                if (p->nTop == x->nTop)
+                {
+                    p->nWidth      += x->nWidth;
+                    sky.remove(i);
+                }
+                else
+                    ++i;
+            }
+
+            return true;
+        }
+
+        status_t SpriteAtlas::add(ISurface *image, sprite_t *sprite)
+        {
+            if ((image == NULL) || (sprite == NULL))
+                return STATUS_BAD_ARGUMENTS;
+
+            ssize_t w   = image->width();
+            ssize_t h   = image->height();
+            if ((w <= 0) || (h <= 0))
+                return STATUS_BAD_ARGUMENTS;
+            if ((w > ssize_t(nPageWidth)) || (h > ssize_t(nPageHeight)))
+                return STATUS_TOO_BIG;
+
+            // Images are separated by padding to prevent bleeding on filtering
+            ssize_t aw  = lsp_min(w + ssize_t(nPadding), ssize_t(nPageWidth));
+            ssize_t ah  = lsp_min(h + ssize_t(nPadding), ssize_t(nPageHeight));
+            ssize_t left = 0, top = 0;
+
+            // Try existing pages first
+            size_t index = 0, n = vPages.size();
+            for ( ; index < n; ++index)
+            {
+                if (pack(vPages.uget(index), aw, ah, &left, &top))
+                    break;
+            }
+            if (index >= n)
+            {
+                page_t *p   = create_page();
+                if (p == NULL)
+                    return STATUS_NO_MEM;
+                if (!pack(p, aw, ah, &left, &top))
+                    return STATUS_TOO_BIG;
+            }
+
+            // Copy the image to the page
+            ISurface *s     = vPages.uget(index)->pSurface;
+            s->begin();
+                s->draw(image, left, top);
+            s->end();
+
+            sprite->nPage   = index;
+            sprite->nLeft   = left;
+            sprite->nTop    = top;
+            sprite->nWidth  = w;
+            sprite->nHeight = h;
+
+            return STATUS_OK;
+        }
+
+        void SpriteAtlas::draw(ISurface *dst, const sprite_t *sprite, float x, float y)
+        {
+            page_t *p = vPages.get(sprite->nPage);
+            if (p == NULL)
+                return;
+
+            dst->draw_clipped(p->pSurface, x, y, sprite->nLeft, sprite->nTop, sprite->nWidth, sprite->nHeight);
+        }
+
+        void SpriteAtlas::draw(ISurface *dst, const sprite_t *sprites, const float *x, const float *y, size_t n)
+        {
+            for (size_t i=0; i<n; )
+            {
+                // Collect the sequence of sprites placed on the same page
+                size_t index    = sprites[i].nPage;
+                page_t *p       = vPages.get(index);
+                vBatch.clear();
+
+                for ( ; (i < n) && (sprites[i].nPage == index); ++i)
+                {
+                    surface_blit_t *b = vBatch.add();
+                    if (b == NULL)
+                        return;
+
+                    const sprite_t *s = &sprites[i];
+                    b->fX           = x[i];
+                    b->fY           = y[i];
+                    b->nLeft        = s->nLeft;
+                    b->nTop         = s->nTop;
+                    b->nWidth       = s->nWidth;
+                    b->nHeight      = s->nHeight;
+                }
+
+                if (p != NULL)
+                    dst->draw_batch(p->pSurface, vBatch.array(), vBatch.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/TiledRasterizer.h>
+#include <lsp-plug.in/lltl/parray.h>
+
+#define TILE_SIZE_DFL           256
+#define TILE_SIZE_MIN           16
+
+namespace lsp
+{
+    namespace ws
+    {
+        TiledRasterizer::Worker::Worker(TiledRasterizer *rasterizer)
+        {
+            pRasterizer     = rasterizer;
+        }
+
+        TiledRasterizer::Worker::~Worker()
+        {
+            pRasterizer     = NULL;
+        }
+
+        status_t TiledRasterizer::Worker::run()
+        {
+            pRasterizer->process_tiles();
+            return STATUS_OK;
+        }
+
+        TiledRasterizer::TiledRasterizer()
+        {
+            nThreads        = lsp_max(ipc::Thread::system_cores(), size_t(1));
+            nTileSize       = TILE_SIZE_DFL;
+            nCols           = 0;
+            nRows           = 0;
+            pSource         = NULL;
+            nNextTile       = 0;
+        }
+
+        TiledRasterizer::~TiledRasterizer()
+        {
+            destroy_tiles();
+            vTiles.flush();
+            vBins.flush();
+        }
+
+        status_t TiledRasterizer::set_threads(size_t threads)
+        {
+            nThreads        = (threads > 0) ? threads : lsp_max(ipc::Thread::system_cores(), size_t(1));
+            return STATUS_OK;
+        }
+
+        status_t TiledRasterizer::set_tile_size(size_t size)
+        {
+            if (size < TILE_SIZE_MIN)
+                return STATUS_INVALID_VALUE;
+            nTileSize       = size;
+            return STATUS_OK;
+        }
+
+        bool TiledRasterizer::create_tiles(ISurface *dst)
+        {
+            nCols           = (dst->width() + nTileSize - 1) / nTileSize;
+            nRows           = (dst->height() + nTileSize - 1) / nTileSize;
+
+            vTiles.clear();
+            tile_t *tiles   = vTiles.append_n(nCols * nRows);
+            if (tiles == NULL)
+                return false;
+            for (size_t i=0; i<nCols * nRows; ++i)
+                tiles[i].pView  = NULL;
+
+            for (size_t y=0; y<nRows; ++y)
+                for (size_t x=0; x<nCols; ++x)
+                {
+                    tile_t *t       = tiles++;
+                    t->nLeft        = x * nTileSize;
+                    t->nTop         = y * nTileSize;
+                    t->nRight       = lsp_min(t->nLeft + nTileSize, dst->width());
+                    t->nBottom      = lsp_min(t->nTop + nTileSize, dst->height());
+                    t->nFirst       = 0;
+                    t->nCount       = 0;
+                    t->pView        = dst->create_view(t->nLeft, t->nTop, t->nRight - t->nLeft, t->nBottom - t->nTop);
+                    if (t->pView == NULL)
+                        return false;
+                }
+
+            return true;
+        }
+
+        void TiledRasterizer::destroy_tiles()
+        {
+            for (size_t i=0, n=vTiles.size(); i<n; ++i)
+            {
+                tile_t *t       = vTiles.uget(i);
+                if (t->pView != NULL)
+                {
+                    t->pView->destroy();
+                    delete t->pView;
+                    t->pView        = NULL;
+                }
+            }
+            vTiles.clear();
+            vBins.clear();
+        }
+
+        bool TiledRasterizer::bin_commands()
+        {
+            lltl::parray<command_t> list;
+            if (!pSource->list_commands(&list))
+                return false;
+
+            const ssize_t ts    = nTileSize;
+            const float width   = nCols * nTileSize;
+            const float height  = nRows * nTileSize;
+
+            // Count commands for each tile, then fill the bins
+            for (size_t pass=0; pass<2; ++pass)
+            {
+                for (size_t i=0, n=list.size(); i<n; ++i)
+                {
+                    command_t *cmd  = list.uget(i);
+                    if ((cmd->fRight < 0.0f) || (cmd->fBottom < 0.0f) || (cmd->fLeft >= width) || (cmd->fTop >= height))
+                        continue;
+
+                    // Compute the range of affected tiles
+                    ssize_t x1      = (cmd->fLeft <= 0.0f) ? 0 : ssize_t(cmd->fLeft) / ts;
+                    ssize_t y1      = (cmd->fTop <= 0.0f) ? 0 : ssize_t(cmd->fTop) / ts;
+                    ssize_t x2      = (cmd->fRight >= width) ? nCols : ssize_t(cmd->fRight) / ts + 1;
+                    ssize_t y2      = (cmd->fBottom >= height) ? nRows : ssize_t(cmd->fBottom) / ts + 1;
+
+                    for (ssize_t y=y1; y<y2; ++y)
+                        for (ssize_t x=x1; x<x2; ++x)
+                        {
+                            tile_t *t       = vTiles.uget(y * nCols + x);
+                            if (pass > 0)
+                                *(vBins.uget(t->nFirst + t->nCount))    = cmd;
+                            ++t->nCount;
+                        }
+                }
+
+                if (pass > 0)
+                    break;
+
+                // Allocate bins
+                size_t total    = 0;
+                for (size_t i=0, n=vTiles.size(); i<n; ++i)
+                {
+                    tile_t *t       = vTiles.uget(i);
+                    t->nFirst       = total;
+                    total          += t->nCount;
+                    t->nCount       = 0;
+                }
+
+                vBins.clear();
+                if (vBins.append_n(total) == NULL)
+                    return false;
+            }
+
+            return true;
+        }
+
+        void TiledRasterizer::process_tiles()
+        {
+            while (true)
+            {
+                size_t index    = atomic_add(&nNextTile, atomic_t(1));
+                if (index >= vTiles.size())
+                    break;
+
+                tile_t *t       = vTiles.uget(index);
+                if (t->nCount <= 0)
+                    continue;
+
+                t->pView->begin();
+                pSource->replay(t->pView, vBins.uget(t->nFirst), t->nCount);
+                t->pView->end();
+            }
+        }
+
+        status_t TiledRasterizer::render(ISurface *dst, ProxySurface *src)
+        {
+            if ((dst == NULL) || (src == NULL))
+                return STATUS_BAD_ARGUMENTS;
+
+            // Replay on the caller thread if multi-threading is not possible
+            if ((nThreads <= 1) || (dst->type() != ST_IMAGE) || (dst->start_direct() == NULL))
+            {
+                src->replay(dst);
+                return STATUS_OK;
+            }
+
+            pSource         = src;
+            nNextTile       = 0;
+
+            if ((!create_tiles(dst)) || (!bin_commands()))
+            {
+                destroy_tiles();
+                dst->end_direct();
+                src->replay(dst);
+                pSource         = NULL;
+                return STATUS_OK;
+            }
+
+            // Launch worker threads, the caller thread also processes tiles
+            lltl::parray<Worker> workers;
+            size_t threads  = lsp_min(nThreads, vTiles.size());
+            for (size_t i=1; i<threads; ++i)
+            {
+                Worker *w       = new Worker(this);
+                if (w == NULL)
+                    break;
+                if ((!workers.add(w)) || (w->start() != STATUS_OK))
+                {
+                    workers.premove(w);
+                    delete w;
+                    break;
+                }
+            }
+
+            process_tiles();
+
+            for (size_t i=0, n=workers.size(); i<n; ++i)
+            {
+                Worker *w       = workers.uget(i);
+                w->join();
+                delete w;
+            }
+            workers.flush();
+
+            destroy_tiles();
+            dst->end_direct();
+            pSource         = NULL;
+
+            return STATUS_OK;
+        }
+    }
+}
@@ -0,0 +1,1049 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/ws/pixels.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <stdlib.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace pixels
+        {
+            static inline uint32_t mul_un8(uint32_t x, uint32_t a)
+            {
+                // x * a / 255 with rounding
+                uint32_t t      = x * a + 0x80;
+                return (t + (t >> 8)) >> 8;
+            }
+
+            static inline uint32_t scale_pixel(uint32_t p, uint32_t k)
+            {
+                return
+                    (mul_un8(p >> 24, k) << 24) |
+                    (mul_un8((p >> 16) & 0xff, k) << 16) |
+                    (mul_un8((p >> 8) & 0xff, k) << 8) |
+                    mul_un8(p & 0xff, k);
+            }
+
+            static inline uint32_t premultiply_pixel(uint32_t p)
+            {
+                uint32_t a      = p >> 24;
+                return
+                    (a << 24) |
+                    (mul_un8((p >> 16) & 0xff, a) << 16) |
+                    (mul_un8((p >> 8) & 0xff, a) << 8) |
+                    mul_un8(p & 0xff, a);
+            }
+
+            static inline uint32_t unpremultiply_channel(uint32_t c, float k)
+            {
+                return lsp_min(uint32_t(c * k + 0.5f), uint32_t(0xff));
+            }
+
+            static inline uint32_t unpremultiply_pixel(uint32_t p)
+            {
+                uint32_t a      = p >> 24;
+                if (a == 0)
+                    return 0;
+                if (a == 0xff)
+                    return p;
+
+                float k         = 255.0f / a;
+                return
+                    (a << 24) |
+                    (unpremultiply_channel((p >> 16) & 0xff, k) << 16) |
+                    (unpremultiply_channel((p >> 8) & 0xff, k) << 8) |
+                    unpremultiply_channel(p & 0xff, k);
+            }
+
+            static inline uint32_t over_pixel(uint32_t d, uint32_t s)
+            {
+                uint32_t ia     = 0xff - (s >> 24);
+                if (ia == 0)
+                    return s;
+                if (s == 0)
+                    return d;
+
+                uint32_t r      = 0;
+                for (size_t i=0; i<32; i += 8)
+                {
+                    uint32_t c      = mul_un8((d >> i) & 0xff, ia) + ((s >> i) & 0xff);
+                    r              |= lsp_min(c, uint32_t(0xff)) << i;
+                }
+                return r;
+            }
+
+            static inline size_t colormap_index(float v, float min, float k, size_t last)
+            {
+                // Negated comparison also maps NaN values to the first entry
+                float x         = (v - min) * k;
+                if (!(x > 0.0f))
+                    return 0;
+                return (x >= float(last)) ? last : size_t(x);
+            }
+
+            /**
+             * Scalar kernels, also used as the reference for the vectorized ones
+             */
+            struct scalar_kernels_t
+            {
+                typedef struct acc_t
+                {
+                    uint32_t        v[4];
+                } acc_t;
+
+                static void fill_row(uint32_t *dst, uint32_t pixel, size_t n)
+                {
+                    for ( ; n > 0; --n)
+                        *(dst++)        = pixel;
+                }
+
+                static void blend_fill_row(uint32_t *dst, uint32_t pixel, size_t n)
+                {
+                    for ( ; n > 0; --n, ++dst)
+                        *dst            = over_pixel(*dst, pixel);
+                }
+
+                static void copy_opaque_row(uint32_t *dst, const uint32_t *src, size_t n)
+                {
+                    for ( ; n > 0; --n)
+                        *(dst++)        = *(src++) | 0xff000000;
+                }
+
+                static void widen_row(unsigned long *dst, const uint32_t *src, size_t n)
+                {
+                    for ( ; n > 0; --n)
+                        *(dst++)        = *(src++);
+                }
+
+                static void premultiply_row(uint32_t *dst, size_t n)
+                {
+                    for ( ; n > 0; --n, ++dst)
+                        *dst            = premultiply_pixel(*dst);
+                }
+
+                static void unpremultiply_row(uint32_t *dst, size_t n)
+                {
+                    for ( ; n > 0; --n, ++dst)
+                        *dst            = unpremultiply_pixel(*dst);
+                }
+
+                static void colormap_row(uint32_t *dst, const float *src, size_t n, const uint32_t *lut, size_t last, float min, float k)
+                {
+                    for ( ; n > 0; --n)
+                        *(dst++)        = lut[colormap_index(*(src++), min, k, last)];
+                }
+
+                static void blend_row(uint32_t *dst, const uint32_t *src, size_t n, uint32_t k)
+                {
+                    for ( ; n > 0; --n, ++dst, ++src)
+                        *dst            = over_pixel(*dst, (k != 0xff) ? scale_pixel(*src, k) : *src);
+                }
+
+                static inline acc_t acc_zero()
+                {
+                    acc_t r;
+                    r.v[0] = 0; r.v[1] = 0; r.v[2] = 0; r.v[3] = 0;
+                    return r;
+                }
+
+                static inline acc_t acc_load(uint32_t p)
+                {
+                    acc_t r;
+                    r.v[0] = p & 0xff; r.v[1] = (p >> 8) & 0xff; r.v[2] = (p >> 16) & 0xff; r.v[3] = p >> 24;
+                    return r;
+                }
+
+                static inline acc_t acc_add(acc_t a, acc_t b)
+                {
+                    for (size_t i=0; i<4; ++i)
+                        a.v[i]         += b.v[i];
+                    return a;
+                }
+
+                static inline acc_t acc_sub(acc_t a, acc_t b)
+                {
+                    for (size_t i=0; i<4; ++i)
+                        a.v[i]         -= b.v[i];
+                    return a;
+                }
+
+                static inline uint32_t acc_store(acc_t a, float k)
+                {
+                    uint32_t r      = 0;
+                    for (size_t i=0; i<4; ++i)
+                        r              |= lsp_min(uint32_t(a.v[i] * k + 0.5f), uint32_t(0xff)) << (i * 8);
+                    return r;
+                }
+            };
+
+        #if defined(__SSE2__)
+            static inline __m128i mul_un8_x8(__m128i x, __m128i a, __m128i vh)
+            {
+                x               = _mm_add_epi16(_mm_mullo_epi16(x, a), vh);
+                return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+            }
+
+            static inline __m128i alpha_x8(__m128i x)
+            {
+                // Broadcast alpha component of each pixel unpacked to 16-bit lanes
+                return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xff), 0xff);
+            }
+
+            struct sse2_kernels_t
+            {
+                typedef __m128i         acc_t;
+
+                static void fill_row(uint32_t *dst, uint32_t pixel, size_t n)
+                {
+                    __m128i v       = _mm_set1_epi32(pixel);
+                    for ( ; n >= 4; n -= 4, dst += 4)
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), v);
+                    for ( ; n > 0; --n)
+                        *(dst++)        = pixel;
+                }
+
+                static void blend_fill_row(uint32_t *dst, uint32_t pixel, size_t n)
+                {
+                    __m128i vz      = _mm_setzero_si128();
+                    __m128i vh      = _mm_set1_epi16(0x80);
+                    __m128i vs      = _mm_set1_epi32(pixel);
+                    __m128i va      = _mm_set1_epi16(0xff - (pixel >> 24));
+
+                    for ( ; n >= 4; n -= 4, dst += 4)
+                    {
+                        __m128i d       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+                        __m128i lo      = mul_un8_x8(_mm_unpacklo_epi8(d, vz), va, vh);
+                        __m128i hi      = mul_un8_x8(_mm_unpackhi_epi8(d, vz), va, vh);
+                        d               = _mm_adds_epu8(_mm_packus_epi16(lo, hi), vs);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), d);
+                    }
+                    for ( ; n > 0; --n, ++dst)
+                        *dst            = over_pixel(*dst, pixel);
+                }
+
+                static void copy_opaque_row(uint32_t *dst, const uint32_t *src, size_t n)
+                {
+                    __m128i vm      = _mm_set1_epi32(0xff000000);
+                    for ( ; n >= 4; n -= 4, dst += 4, src += 4)
+                    {
+                        __m128i s       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(s, vm));
+                    }
+                    for ( ; n > 0; --n)
+                        *(dst++)        = *(src++) | 0xff000000;
+                }
+
+                static void widen_row(unsigned long *dst, const uint32_t *src, size_t n)
+                {
+                    // Only 64-bit values need the zero extension
+                    if (sizeof(unsigned long) != sizeof(uint64_t))
+                    {
+                        scalar_kernels_t::widen_row(dst, src, n);
+                        return;
+                    }
+
+                    __m128i vz      = _mm_setzero_si128();
+                    for ( ; n >= 4; n -= 4, dst += 4, src += 4)
+                    {
+                        __m128i s       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[0]), _mm_unpacklo_epi32(s, vz));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[2]), _mm_unpackhi_epi32(s, vz));
+                    }
+                    for ( ; n > 0; --n)
+                        *(dst++)        = *(src++);
+                }
+
+                static void premultiply_row(uint32_t *dst, size_t n)
+                {
+                    __m128i vz      = _mm_setzero_si128();
+                    __m128i vh      = _mm_set1_epi16(0x80);
+                    __m128i va      = _mm_set_epi16(0xff, 0, 0, 0, 0xff, 0, 0, 0);
+                    __m128i vm      = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+
+                    for ( ; n >= 4; n -= 4, dst += 4)
+                    {
+                        // Alpha component is multiplied by 0xff and stays unchanged
+                        __m128i s       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+                        __m128i lo      = _mm_unpacklo_epi8(s, vz);
+                        __m128i hi      = _mm_unpackhi_epi8(s, vz);
+                        __m128i alo     = _mm_or_si128(_mm_and_si128(alpha_x8(lo), vm), va);
+                        __m128i ahi     = _mm_or_si128(_mm_and_si128(alpha_x8(hi), vm), va);
+                        lo              = mul_un8_x8(lo, alo, vh);
+                        hi              = mul_un8_x8(hi, ahi, vh);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(lo, hi));
+                    }
+                    for ( ; n > 0; --n, ++dst)
+                        *dst            = premultiply_pixel(*dst);
+                }
+
+                static void unpremultiply_row(uint32_t *dst, size_t n)
+                {
+                    __m128i vz      = _mm_setzero_si128();
+                    __m128i vrgb    = _mm_set1_epi32(0x00ffffff);
+                    __m128i valpha  = _mm_set1_epi32(0xff000000);
+                    __m128 vfz      = _mm_setzero_ps();
+                    __m128 vmax     = _mm_set1_ps(255.0f);
+                    __m128 vhalf    = _mm_set1_ps(0.5f);
+
+                    for ( ; n >= 4; n -= 4, dst += 4)
+                    {
+                        __m128i s       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+
+                        // Compute 255/alpha for each pixel, zero alpha gives zero factor
+                        __m128 a        = _mm_cvtepi32_ps(_mm_srli_epi32(s, 24));
+                        __m128 k        = _mm_and_ps(_mm_div_ps(vmax, a), _mm_cmpneq_ps(a, vfz));
+
+                        __m128i lo      = _mm_unpacklo_epi8(s, vz);
+                        __m128i hi      = _mm_unpackhi_epi8(s, vz);
+                        __m128 c0       = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, vz));
+                        __m128 c1       = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, vz));
+                        __m128 c2       = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, vz));
+                        __m128 c3       = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, vz));
+                        c0              = _mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(k, k, 0x00)), vhalf);
+                        c1              = _mm_add_ps(_mm_mul_ps(c1, _mm_shuffle_ps(k, k, 0x55)), vhalf);
+                        c2              = _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(k, k, 0xaa)), vhalf);
+                        c3              = _mm_add_ps(_mm_mul_ps(c3, _mm_shuffle_ps(k, k, 0xff)), vhalf);
+
+                        lo              = _mm_packs_epi32(_mm_cvttps_epi32(c0), _mm_cvttps_epi32(c1));
+                        hi              = _mm_packs_epi32(_mm_cvttps_epi32(c2), _mm_cvttps_epi32(c3));
+                        __m128i r       = _mm_packus_epi16(lo, hi);
+                        r               = _mm_or_si128(_mm_and_si128(r, vrgb), _mm_and_si128(s, valpha));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), r);
+                    }
+                    for ( ; n > 0; --n, ++dst)
+                        *dst            = unpremultiply_pixel(*dst);
+                }
+
+                static void colormap_row(uint32_t *dst, const float *src, size_t n, const uint32_t *lut, size_t last, float min, float k)
+                {
+                    __m128 vmin     = _mm_set1_ps(min);
+                    __m128 vk       = _mm_set1_ps(k);
+                    __m128 vlast    = _mm_set1_ps(float(last));
+                    __m128 vz       = _mm_setzero_ps();
+                    int32_t idx[4];
+
+                    for ( ; n >= 4; n -= 4, dst += 4, src += 4)
+                    {
+                        // MAXPS returns the second operand for NaN values
+                        __m128 x        = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src), vmin), vk);
+                        x               = _mm_min_ps(_mm_max_ps(x, vz), vlast);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(idx), _mm_cvttps_epi32(x));
+
+                        dst[0]          = lut[idx[0]];
+                        dst[1]          = lut[idx[1]];
+                        dst[2]          = lut[idx[2]];
+                        dst[3]          = lut[idx[3]];
+                    }
+                    for ( ; n > 0; --n)
+                        *(dst++)        = lut[colormap_index(*(src++), min, k, last)];
+                }
+
+                static void blend_row(uint32_t *dst, const uint32_t *src, size_t n, uint32_t k)
+                {
+                    __m128i vz      = _mm_setzero_si128();
+                    __m128i vm      = _mm_set1_epi32(0xff000000);
+                    __m128i vf      = _mm_set1_epi16(0xff);
+                    __m128i vh      = _mm_set1_epi16(0x80);
+                    __m128i vk      = _mm_set1_epi16(k);
+
+                    for ( ; n >= 4; n -= 4, dst += 4, src += 4)
+                    {
+                        __m128i s       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                        if (k != 0xff)
+                            s               = _mm_packus_epi16(
+                                                mul_un8_x8(_mm_unpacklo_epi8(s, vz), vk, vh),
+                                                mul_un8_x8(_mm_unpackhi_epi8(s, vz), vk, vh));
+
+                        // Opaque and fully transparent sources do not need blending
+                        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, vm), vm)) == 0xffff)
+                        {
+                            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), s);
+                            continue;
+                        }
+                        if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, vz)) == 0xffff)
+                            continue;
+
+                        __m128i d       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+                        __m128i alo     = _mm_sub_epi16(vf, alpha_x8(_mm_unpacklo_epi8(s, vz)));
+                        __m128i ahi     = _mm_sub_epi16(vf, alpha_x8(_mm_unpackhi_epi8(s, vz)));
+                        __m128i lo      = mul_un8_x8(_mm_unpacklo_epi8(d, vz), alo, vh);
+                        __m128i hi      = mul_un8_x8(_mm_unpackhi_epi8(d, vz), ahi, vh);
+                        d               = _mm_adds_epu8(_mm_packus_epi16(lo, hi), s);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), d);
+                    }
+                    for ( ; n > 0; --n, ++dst, ++src)
+                        *dst            = over_pixel(*dst, (k != 0xff) ? scale_pixel(*src, k) : *src);
+                }
+
+                static inline acc_t acc_zero()
+                {
+                    return _mm_setzero_si128();
+                }
+
+                static inline acc_t acc_load(uint32_t p)
+                {
+                    __m128i vz      = _mm_setzero_si128();
+                    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p), vz), vz);
+                }
+
+                static inline acc_t acc_add(acc_t a, acc_t b)
+                {
+                    return _mm_add_epi32(a, b);
+                }
+
+                static inline acc_t acc_sub(acc_t a, acc_t b)
+                {
+                    return _mm_sub_epi32(a, b);
+                }
+
+                static inline uint32_t acc_store(acc_t a, float k)
+                {
+                    __m128 x        = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), _mm_set1_ps(k)), _mm_set1_ps(0.5f));
+                    __m128i r       = _mm_cvttps_epi32(x);
+                    r               = _mm_packs_epi32(r, r);
+                    return _mm_cvtsi128_si32(_mm_packus_epi16(r, r));
+                }
+            };
+
+        #if defined(__AVX2__)
+            static inline __m256i mul_un8_x16(__m256i x, __m256i a, __m256i vh)
+            {
+                x               = _mm256_add_epi16(_mm256_mullo_epi16(x, a), vh);
+                return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+            }
+
+            static inline __m256i alpha_x16(__m256i x)
+            {
+                return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, 0xff), 0xff);
+            }
+
+            /**
+             * AVX2 kernels process 8 pixels at once, the rest is inherited from SSE2 kernels.
+             * Unpacking and packing instructions operate on 128-bit lanes independently, so
+             * the order of pixels is preserved
+             */
+            struct avx2_kernels_t: public sse2_kernels_t
+            {
+                static void fill_row(uint32_t *dst, uint32_t pixel, size_t n)
+                {
+                    __m256i v       = _mm256_set1_epi32(pixel);
+                    for ( ; n >= 8; n -= 8, dst += 8)
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), v);
+                    sse2_kernels_t::fill_row(dst, pixel, n);
+                }
+
+                static void blend_fill_row(uint32_t *dst, uint32_t pixel, size_t n)
+                {
+                    __m256i vz      = _mm256_setzero_si256();
+                    __m256i vh      = _mm256_set1_epi16(0x80);
+                    __m256i vs      = _mm256_set1_epi32(pixel);
+                    __m256i va      = _mm256_set1_epi16(0xff - (pixel >> 24));
+
+                    for ( ; n >= 8; n -= 8, dst += 8)
+                    {
+                        __m256i d       = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst));
+                        __m256i lo      = mul_un8_x16(_mm256_unpacklo_epi8(d, vz), va, vh);
+                        __m256i hi      = mul_un8_x16(_mm256_unpackhi_epi8(d, vz), va, vh);
+                        d               = _mm256_adds_epu8(_mm256_packus_epi16(lo, hi), vs);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), d);
+                    }
+                    sse2_kernels_t::blend_fill_row(dst, pixel, n);
+                }
+
+                static void copy_opaque_row(uint32_t *dst, const uint32_t *src, size_t n)
+                {
+                    __m256i vm      = _mm256_set1_epi32(0xff000000);
+                    for ( ; n >= 8; n -= 8, dst += 8, src += 8)
+                    {
+                        __m256i s       = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_or_si256(s, vm));
+                    }
+                    sse2_kernels_t::copy_opaque_row(dst, src, n);
+                }
+
+                static void widen_row(unsigned long *dst, const uint32_t *src, size_t n)
+                {
+                    if (sizeof(unsigned long) == sizeof(uint64_t))
+                    {
+                        for ( ; n >= 4; n -= 4, dst += 4, src += 4)
+                        {
+                            __m128i s       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_cvtepu32_epi64(s));
+                        }
+                    }
+                    sse2_kernels_t::widen_row(dst, src, n);
+                }
+
+                static void premultiply_row(uint32_t *dst, size_t n)
+                {
+                    __m256i vz      = _mm256_setzero_si256();
+                    __m256i vh      = _mm256_set1_epi16(0x80);
+                    __m256i va      = _mm256_set_epi16(0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0);
+                    __m256i vm      = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+
+                    for ( ; n >= 8; n -= 8, dst += 8)
+                    {
+                        __m256i s       = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst));
+                        __m256i lo      = _mm256_unpacklo_epi8(s, vz);
+                        __m256i hi      = _mm256_unpackhi_epi8(s, vz);
+                        __m256i alo     = _mm256_or_si256(_mm256_and_si256(alpha_x16(lo), vm), va);
+                        __m256i ahi     = _mm256_or_si256(_mm256_and_si256(alpha_x16(hi), vm), va);
+                        lo              = mul_un8_x16(lo, alo, vh);
+                        hi              = mul_un8_x16(hi, ahi, vh);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_packus_epi16(lo, hi));
+                    }
+                    sse2_kernels_t::premultiply_row(dst, n);
+                }
+
+                static void blend_row(uint32_t *dst, const uint32_t *src, size_t n, uint32_t k)
+                {
+                    __m256i vz      = _mm256_setzero_si256();
+                    __m256i vm      = _mm256_set1_epi32(0xff000000);
+                    __m256i vf      = _mm256_set1_epi16(0xff);
+                    __m256i vh      = _mm256_set1_epi16(0x80);
+                    __m256i vk      = _mm256_set1_epi16(k);
+
+                    for ( ; n >= 8; n -= 8, dst += 8, src += 8)
+                    {
+                        __m256i s       = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+                        if (k != 0xff)
+                            s               = _mm256_packus_epi16(
+                                                mul_un8_x16(_mm256_unpacklo_epi8(s, vz), vk, vh),
+                                                mul_un8_x16(_mm256_unpackhi_epi8(s, vz), vk, vh));
+
+                        // Opaque and fully transparent sources do not need blending
+                        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(s, vm), vm)) == -1)
+                        {
+                            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), s);
+                            continue;
+                        }
+                        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(s, vz)) == -1)
+                            continue;
+
+                        __m256i d       = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst));
+                        __m256i alo     = _mm256_sub_epi16(vf, alpha_x16(_mm256_unpacklo_epi8(s, vz)));
+                        __m256i ahi     = _mm256_sub_epi16(vf, alpha_x16(_mm256_unpackhi_epi8(s, vz)));
+                        __m256i lo      = mul_un8_x16(_mm256_unpacklo_epi8(d, vz), alo, vh);
+                        __m256i hi      = mul_un8_x16(_mm256_unpackhi_epi8(d, vz), ahi, vh);
+                        d               = _mm256_adds_epu8(_mm256_packus_epi16(lo, hi), s);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), d);
+                    }
+                    sse2_kernels_t::blend_row(dst, src, n, k);
+                }
+            };
+
+            typedef avx2_kernels_t      vector_kernels_t;
+        #else
+            typedef sse2_kernels_t      vector_kernels_t;
+        #endif /* __AVX2__ */
+        #elif defined(__ARM_NEON)
+            static inline uint8x8_t mul_un8_x8(uint8x8_t x, uint8x8_t a, uint16x8_t vh)
+            {
+                uint16x8_t t    = vmlal_u8(vh, x, a);
+                return vshrn_n_u16(vaddq_u16(t, vshrq_n_u16(t, 8)), 8);
+            }
+
+            struct vector_kernels_t
+            {
+                typedef uint32x4_t      acc_t;
+
+                static void fill_row(uint32_t *dst, uint32_t pixel, size_t n)
+                {
+                    uint32x4_t v    = vdupq_n_u32(pixel);
+                    for ( ; n >= 4; n -= 4, dst += 4)
+                        vst1q_u32(dst, v);
+                    for ( ; n > 0; --n)
+                        *(dst++)        = pixel;
+                }
+
+                static void blend_fill_row(uint32_t *dst, uint32_t pixel, size_t n)
+                {
+                    uint16x8_t vh   = vdupq_n_u16(0x80);
+                    uint8x16_t vs   = vreinterpretq_u8_u32(vdupq_n_u32(pixel));
+                    uint8x8_t va    = vdup_n_u8(0xff - (pixel >> 24));
+
+                    for ( ; n >= 4; n -= 4, dst += 4)
+                    {
+                        uint8x16_t d    = vreinterpretq_u8_u32(vld1q_u32(dst));
+                        uint8x8_t lo    = mul_un8_x8(vget_low_u8(d), va, vh);
+                        uint8x8_t hi    = mul_un8_x8(vget_high_u8(d), va, vh);
+                        d               = vqaddq_u8(vcombine_u8(lo, hi), vs);
+                        vst1q_u32(dst, vreinterpretq_u32_u8(d));
+                    }
+                    for ( ; n > 0; --n, ++dst)
+                        *dst            = over_pixel(*dst, pixel);
+                }
+
+                static void copy_opaque_row(uint32_t *dst, const uint32_t *src, size_t n)
+                {
+                    uint32x4_t vm   = vdupq_n_u32(0xff000000);
+                    for ( ; n >= 4; n -= 4, dst += 4, src += 4)
+                        vst1q_u32(dst, vorrq_u32(vld1q_u32(src), vm));
+                    for ( ; n > 0; --n)
+                        *(dst++)        = *(src++) | 0xff000000;
+                }
+
+                static void widen_row(unsigned long *dst, const uint32_t *src, size_t n)
+                {
+                    // Only 64-bit values need the zero extension
+                    if (sizeof(unsigned long) != sizeof(uint64_t))
+                    {
+                        scalar_kernels_t::widen_row(dst, src, n);
+                        return;
+                    }
+
+                    for ( ; n >= 4; n -= 4, dst += 4, src += 4)
+                    {
+                        uint32x4_t s    = vld1q_u32(src);
+                        vst1q_u64(reinterpret_cast<uint64_t *>(&dst[0]), vmovl_u32(vget_low_u32(s)));
+                        vst1q_u64(reinterpret_cast<uint64_t *>(&dst[2]), vmovl_u32(vget_high_u32(s)));
+                    }
+                    for ( ; n > 0; --n)
+                        *(dst++)        = *(src++);
+                }
+
+                static void premultiply_row(uint32_t *dst, size_t n)
+                {
+                    uint16x8_t vh   = vdupq_n_u16(0x80);
+
+                    for ( ; n >= 8; n -= 8, dst += 8)
+                    {
+                        // Planar load: blue, green, red and alpha components of 8 pixels
+                        uint8x8x4_t s   = vld4_u8(reinterpret_cast<const uint8_t *>(dst));
+                        s.val[0]        = mul_un8_x8(s.val[0], s.val[3], vh);
+                        s.val[1]        = mul_un8_x8(s.val[1], s.val[3], vh);
+                        s.val[2]        = mul_un8_x8(s.val[2], s.val[3], vh);
+                        vst4_u8(reinterpret_cast<uint8_t *>(dst), s);
+                    }
+                    for ( ; n > 0; --n, ++dst)
+                        *dst            = premultiply_pixel(*dst);
+                }
+
+                static void unpremultiply_row(uint32_t *dst, size_t n)
+                {
+                    // 32-bit ARM does not provide vector division, the scalar code is used
+                    scalar_kernels_t::unpremultiply_row(dst, n);
+                }
+
+                static void colormap_row(uint32_t *dst, const float *src, size_t n, const uint32_t *lut, size_t last, float min, float k)
+                {
+                    float32x4_t vmin    = vdupq_n_f32(min);
+                    float32x4_t vk      = vdupq_n_f32(k);
+                    float32x4_t vlast   = vdupq_n_f32(float(last));
+                    float32x4_t vz      = vdupq_n_f32(0.0f);
+                    uint32_t idx[4];
+
+                    for ( ; n >= 4; n -= 4, dst += 4, src += 4)
+                    {
+                        // NaN values are converted to zero indices
+                        float32x4_t x   = vmulq_f32(vsubq_f32(vld1q_f32(src), vmin), vk);
+                        x               = vminq_f32(vmaxq_f32(x, vz), vlast);
+                        vst1q_u32(idx, vcvtq_u32_f32(x));
+
+                        dst[0]          = lut[idx[0]];
+                        dst[1]          = lut[idx[1]];
+                        dst[2]          = lut[idx[2]];
+                        dst[3]          = lut[idx[3]];
+                    }
+                    for ( ; n > 0; --n)
+                        *(dst++)        = lut[colormap_index(*(src++), min, k, last)];
+                }
+
+                static void blend_row(uint32_t *dst, const uint32_t *src, size_t n, uint32_t k)
+                {
+                    uint16x8_t vh   = vdupq_n_u16(0x80);
+                    uint8x8_t vk    = vdup_n_u8(k);
+
+                    for ( ; n >= 8; n -= 8, dst += 8, src += 8)
+                    {
+                        uint8x8x4_t s   = vld4_u8(reinterpret_cast<const uint8_t *>(src));
+                        uint8x8x4_t d   = vld4_u8(reinterpret_cast<const uint8_t *>(dst));
+                        if (k != 0xff)
+                        {
+                            for (size_t i=0; i<4; ++i)
+                                s.val[i]        = mul_un8_x8(s.val[i], vk, vh);
+                        }
+
+                        uint8x8_t ia    = vmvn_u8(s.val[3]);
+                        for (size_t i=0; i<4; ++i)
+                            d.val[i]        = vqadd_u8(mul_un8_x8(d.val[i], ia, vh), s.val[i]);
+
+                        vst4_u8(reinterpret_cast<uint8_t *>(dst), d);
+                    }
+                    for ( ; n > 0; --n, ++dst, ++src)
+                        *dst            = over_pixel(*dst, (k != 0xff) ? scale_pixel(*src, k) : *src);
+                }
+
+                static inline acc_t acc_zero()
+                {
+                    return vdupq_n_u32(0);
+                }
+
+                static inline acc_t acc_load(uint32_t p)
+                {
+                    return vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p)))));
+                }
+
+                static inline acc_t acc_add(acc_t a, acc_t b)
+                {
+                    return vaddq_u32(a, b);
+                }
+
+                static inline acc_t acc_sub(acc_t a, acc_t b)
+                {
+                    return vsubq_u32(a, b);
+                }
+
+                static inline uint32_t acc_store(acc_t a, float k)
+                {
+                    float32x4_t x   = vmlaq_n_f32(vdupq_n_f32(0.5f), vcvtq_f32_u32(a), k);
+                    uint16x4_t h    = vqmovn_u32(vcvtq_u32_f32(x));
+                    uint8x8_t b     = vqmovn_u16(vcombine_u16(h, h));
+                    return vget_lane_u32(vreinterpret_u32_u8(b), 0);
+                }
+            };
+        #else
+            typedef scalar_kernels_t    vector_kernels_t;
+        #endif /* __SSE2__, __ARM_NEON */
+
+            template <class K>
+                static void blur_row(uint32_t *dst, const uint32_t *src, size_t n, size_t r, float k)
+                {
+                    typedef typename K::acc_t acc_t;
+
+                    // Initialize the window for the first pixel, the edge pixel is repeated
+                    size_t last     = n - 1;
+                    acc_t first     = K::acc_load(src[0]);
+                    acc_t s         = K::acc_zero();
+                    for (size_t i=0; i<r; ++i)
+                        s               = K::acc_add(s, first);
+                    for (size_t i=0; i<=r; ++i)
+                        s               = K::acc_add(s, K::acc_load(src[lsp_min(i, last)]));
+
+                    // Slide the window
+                    for (size_t x=0; x<n; ++x)
+                    {
+                        dst[x]          = K::acc_store(s, k);
+                        s               = K::acc_add(s, K::acc_load(src[lsp_min(x + r + 1, last)]));
+                        s               = K::acc_sub(s, K::acc_load(src[(x >= r) ? x - r : 0]));
+                    }
+                }
+
+            template <class K>
+                static void blur_cols(uint8_t *dst, size_t stride, const uint32_t *src, size_t width, size_t height,
+                    size_t r, float k, typename K::acc_t *sums)
+                {
+                    // Initialize the window for the first row, the edge row is repeated
+                    size_t last     = height - 1;
+                    for (size_t x=0; x<width; ++x)
+                        sums[x]         = K::acc_zero();
+                    for (size_t i=0; i<r; ++i)
+                        for (size_t x=0; x<width; ++x)
+                            sums[x]         = K::acc_add(sums[x], K::acc_load(src[x]));
+                    for (size_t i=0; i<=r; ++i)
+                    {
+                        const uint32_t *row = &src[lsp_min(i, last) * width];
+                        for (size_t x=0; x<width; ++x)
+                            sums[x]         = K::acc_add(sums[x], K::acc_load(row[x]));
+                    }
+
+                    // Slide the window row by row to keep the sequential memory access
+                    for (size_t y=0; y<height; ++y, dst += stride)
+                    {
+                        uint32_t *d         = reinterpret_cast<uint32_t *>(dst);
+                        const uint32_t *in  = &src[lsp_min(y + r + 1, last) * width];
+                        const uint32_t *out = &src[((y >= r) ? y - r : 0) * width];
+
+                        for (size_t x=0; x<width; ++x)
+                        {
+                            d[x]            = K::acc_store(sums[x], k);
+                            sums[x]         = K::acc_sub(K::acc_add(sums[x], K::acc_load(in[x])), K::acc_load(out[x]));
+                        }
+                    }
+                }
+
+            template <class K>
+                static void fill_region(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel)
+                {
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+                    for (size_t y=0; y<height; ++y, p += stride)
+                        K::fill_row(reinterpret_cast<uint32_t *>(p), pixel, width);
+                }
+
+            template <class K>
+                static void blend_fill_region(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel)
+                {
+                    // Opaque pixel replaces the destination, transparent one does not change it
+                    if ((pixel >> 24) == 0xff)
+                    {
+                        fill_region<K>(dst, stride, width, height, pixel);
+                        return;
+                    }
+                    if (pixel == 0)
+                        return;
+
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+                    for (size_t y=0; y<height; ++y, p += stride)
+                        K::blend_fill_row(reinterpret_cast<uint32_t *>(p), pixel, width);
+                }
+
+            template <class K>
+                static void copy_opaque_region(void *dst, size_t stride, const void *src, size_t src_stride,
+                    size_t width, size_t height)
+                {
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+                    const uint8_t *s= static_cast<const uint8_t *>(src);
+                    for (size_t y=0; y<height; ++y, p += stride, s += src_stride)
+                        K::copy_opaque_row(reinterpret_cast<uint32_t *>(p), reinterpret_cast<const uint32_t *>(s), width);
+                }
+
+            template <class K>
+                static void widen_region(void *dst, size_t stride, const void *src, size_t src_stride,
+                    size_t width, size_t height)
+                {
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+                    const uint8_t *s= static_cast<const uint8_t *>(src);
+                    for (size_t y=0; y<height; ++y, p += stride, s += src_stride)
+                        K::widen_row(reinterpret_cast<unsigned long *>(p), reinterpret_cast<const uint32_t *>(s), width);
+                }
+
+            template <class K>
+                static void premultiply_region(void *dst, size_t stride, size_t width, size_t height)
+                {
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+                    for (size_t y=0; y<height; ++y, p += stride)
+                        K::premultiply_row(reinterpret_cast<uint32_t *>(p), width);
+                }
+
+            template <class K>
+                static void unpremultiply_region(void *dst, size_t stride, size_t width, size_t height)
+                {
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+                    for (size_t y=0; y<height; ++y, p += stride)
+                        K::unpremultiply_row(reinterpret_cast<uint32_t *>(p), width);
+                }
+
+            template <class K>
+                static void colormap_region(void *dst, size_t stride, const float *src, size_t src_stride,
+                    size_t width, size_t height, const uint32_t *lut, size_t n, float min, float max)
+                {
+                    if ((lut == NULL) || (n <= 0))
+                        return;
+
+                    float k         = (max != min) ? n / (max - min) : 0.0f;
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+                    for (size_t y=0; y<height; ++y, p += stride, src += src_stride)
+                        K::colormap_row(reinterpret_cast<uint32_t *>(p), src, width, lut, n - 1, min, k);
+                }
+
+            template <class K>
+                static void blend_region(void *dst, size_t stride, const void *src, size_t src_stride,
+                    size_t width, size_t height, float a)
+                {
+                    uint32_t k      = uint32_t(lsp_limit(1.0f - a, 0.0f, 1.0f) * 255.0f + 0.5f);
+                    if (k == 0)
+                        return;
+
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+                    const uint8_t *s= static_cast<const uint8_t *>(src);
+                    for (size_t y=0; y<height; ++y, p += stride, s += src_stride)
+                        K::blend_row(reinterpret_cast<uint32_t *>(p), reinterpret_cast<const uint32_t *>(s), width, k);
+                }
+
+            template <class K>
+                static status_t blur_region(void *dst, size_t stride, size_t width, size_t height, size_t rx, size_t ry)
+                {
+                    typedef typename K::acc_t acc_t;
+
+                    if (dst == NULL)
+                        return STATUS_BAD_ARGUMENTS;
+                    if ((width <= 0) || (height <= 0) || ((rx <= 0) && (ry <= 0)))
+                        return STATUS_OK;
+
+                    // The vertical pass needs the copy of the whole region and the column sums,
+                    // the horizontal pass needs the copy of the single row
+                    size_t nsums    = (ry > 0) ? width : 0;
+                    size_t npixels  = (ry > 0) ? width * height : width;
+                    uint8_t *buf    = static_cast<uint8_t *>(::malloc(nsums * sizeof(acc_t) + npixels * sizeof(uint32_t) + 0x10));
+                    if (buf == NULL)
+                        return STATUS_NO_MEM;
+
+                    acc_t *sums     = reinterpret_cast<acc_t *>((uintptr_t(buf) + 0x0f) & ~uintptr_t(0x0f));
+                    uint32_t *tmp   = reinterpret_cast<uint32_t *>(&sums[nsums]);
+                    uint8_t *p      = static_cast<uint8_t *>(dst);
+
+                    if (rx > 0)
+                    {
+                        float k         = 1.0f / (rx * 2 + 1);
+                        uint8_t *row    = p;
+                        for (size_t y=0; y<height; ++y, row += stride)
+                        {
+                            ::memcpy(tmp, row, width * sizeof(uint32_t));
+                            blur_row<K>(reinterpret_cast<uint32_t *>(row), tmp, width, rx, k);
+                        }
+                    }
+
+                    if (ry > 0)
+                    {
+                        uint8_t *row    = p;
+                        for (size_t y=0; y<height; ++y, row += stride)
+                            ::memcpy(&tmp[y * width], row, width * sizeof(uint32_t));
+                        blur_cols<K>(p, stride, tmp, width, height, ry, 1.0f / (ry * 2 + 1), sums);
+                    }
+
+                    ::free(buf);
+                    return STATUS_OK;
+                }
+
+            static inline uint32_t color_short(double c)
+            {
+                return uint32_t(c * 65535.0 + 0.5);
+            }
+
+            uint32_t pixel(float r, float g, float b, float a)
+            {
+                // Cairo clamps components, premultiplies them and converts to 16 bits,
+                // pixman then takes 8 most significant bits of each component
+                double ca       = lsp_limit(double(1.0f - a), 0.0, 1.0);
+                uint32_t cr     = color_short(lsp_limit(double(r), 0.0, 1.0) * ca);
+                uint32_t cg     = color_short(lsp_limit(double(g), 0.0, 1.0) * ca);
+                uint32_t cb     = color_short(lsp_limit(double(b), 0.0, 1.0) * ca);
+
+                return ((color_short(ca) >> 8) << 24) | ((cr >> 8) << 16) | (cg & 0xff00) | (cb >> 8);
+            }
+
+            uint32_t pixel(const Color &c)
+            {
+                return pixel(c.red(), c.green(), c.blue(), c.alpha());
+            }
+
+            void fill(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel)
+            {
+                fill_region<vector_kernels_t>(dst, stride, width, height, pixel);
+            }
+
+            void blend_fill(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel)
+            {
+                blend_fill_region<vector_kernels_t>(dst, stride, width, height, pixel);
+            }
+
+            void copy_opaque(void *dst, size_t stride, const void *src, size_t src_stride, size_t width, size_t height)
+            {
+                copy_opaque_region<vector_kernels_t>(dst, stride, src, src_stride, width, height);
+            }
+
+            void widen(void *dst, size_t stride, const void *src, size_t src_stride, size_t width, size_t height)
+            {
+                widen_region<vector_kernels_t>(dst, stride, src, src_stride, width, height);
+            }
+
+            void premultiply(void *dst, size_t stride, size_t width, size_t height)
+            {
+                premultiply_region<vector_kernels_t>(dst, stride, width, height);
+            }
+
+            void unpremultiply(void *dst, size_t stride, size_t width, size_t height)
+            {
+                unpremultiply_region<vector_kernels_t>(dst, stride, width, height);
+            }
+
+            void colormap(void *dst, size_t stride, const float *src, size_t src_stride,
+                size_t width, size_t height, const uint32_t *lut, size_t n, float min, float max)
+            {
+                colormap_region<vector_kernels_t>(dst, stride, src, src_stride, width, height, lut, n, min, max);
+            }
+
+            void blend(void *dst, size_t stride, const void *src, size_t src_stride,
+                size_t width, size_t height, float a)
+            {
+                blend_region<vector_kernels_t>(dst, stride, src, src_stride, width, height, a);
+            }
+
+            status_t blur(void *dst, size_t stride, size_t width, size_t height, size_t rx, size_t ry)
+            {
+                return blur_region<vector_kernels_t>(dst, stride, width, height, rx, ry);
+            }
+
+            namespace generic
+            {
+                void fill(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel)
+                {
+                    fill_region<scalar_kernels_t>(dst, stride, width, height, pixel);
+                }
+
+                void blend_fill(void *dst, size_t stride, size_t width, size_t height, uint32_t pixel)
+                {
+                    blend_fill_region<scalar_kernels_t>(dst, stride, width, height, pixel);
+                }
+
+                void copy_opaque(void *dst, size_t stride, const void *src, size_t src_stride, size_t width, size_t height)
+                {
+                    copy_opaque_region<scalar_kernels_t>(dst, stride, src, src_stride, width, height);
+                }
+
+                void widen(void *dst, size_t stride, const void *src, size_t src_stride, size_t width, size_t height)
+                {
+                    widen_region<scalar_kernels_t>(dst, stride, src, src_stride, width, height);
+                }
+
+                void premultiply(void *dst, size_t stride, size_t width, size_t height)
+                {
+                    premultiply_region<scalar_kernels_t>(dst, stride, width, height);
+                }
+
+                void unpremultiply(void *dst, size_t stride, size_t width, size_t height)
+                {
+                    unpremultiply_region<scalar_kernels_t>(dst, stride, width, height);
+                }
+
+                void colormap(void *dst, size_t stride, const float *src, size_t src_stride,
+                    size_t width, size_t height, const uint32_t *lut, size_t n, float min, float max)
+                {
+                    colormap_region<scalar_kernels_t>(dst, stride, src, src_stride, width, height, lut, n, min, max);
+                }
+
+                void blend(void *dst, size_t stride, const void *src, size_t src_stride,
+                    size_t width, size_t height, float a)
+                {
+                    blend_region<scalar_kernels_t>(dst, stride, src, src_stride, width, height, a);
+                }
+
+                status_t blur(void *dst, size_t stride, size_t width, size_t height, size_t rx, size_t ry)
+                {
+                    return blur_region<scalar_kernels_t>(dst, stride, width, height, rx, ry);
+                }
+            }
+        }
+    }
+}
@@ -31,9 +31,13 @@ namespace lsp
     {
         namespace x11
         {
-            X11CairoGradient::X11CairoGradient()
+            X11CairoGradient::X11CairoGradient(X11GradientCache *cache, gradient_type_t type)
             {
-                pCP = NULL;
+                pCP         = NULL;
+                pCache      = cache;
+                enType      = type;
+                for (size_t i=0; i<6; ++i)
+                    vParams[i]  = 0.0f;
             }
 
             X11CairoGradient::~X11CairoGradient()
@@ -43,27 +47,71 @@ namespace lsp
                     cairo_pattern_destroy(pCP);
                     pCP = NULL;
                 }
+                vStops.flush();
             }
 
             void X11CairoGradient::add_color(float offset, float r, float g, float b, float a)
             {
-                if (pCP == NULL)
+                // Drop the pattern, it will be rebuilt on next use
+                if (pCP != NULL)
+                {
+                    cairo_pattern_destroy(pCP);
+                    pCP = NULL;
+                }
+
+                // Keep stops sorted by offset, stops with the same offset keep the order of addition
+                size_t index = vStops.size();
+                while ((index > 0) && (vStops.uget(index - 1)->offset > offset))
+                    --index;
+
+                gradient_stop_t *s = vStops.insert(index);
+                if (s == NULL)
                     return;
 
-                cairo_pattern_add_color_stop_rgba(pCP, offset, r, g, b, 1.0f - a);
+                s->offset   = offset;
+                s->r        = r;
+                s->g        = g;
+                s->b        = b;
+                s->a        = 1.0f - a;
             }
 
             void X11CairoGradient::apply(cairo_t *cr)
             {
                 if (pCP == NULL)
-                    return;
+                {
+                    pCP = (pCache != NULL) ?
+                        pCache->acquire(enType, vParams, vStops.array(), vStops.size()) :
+                        X11GradientCache::create_pattern(enType, vParams, vStops.array(), vStops.size());
+                    if (pCP == NULL)
+                        return;
+                }
                 cairo_set_source(cr, pCP);
             }
 
+            X11CairoLinearGradient::X11CairoLinearGradient(X11GradientCache *cache, float x0, float y0, float x1, float y1):
+                X11CairoGradient(cache, GRADIENT_LINEAR)
+            {
+                vParams[0]  = x0;
+                vParams[1]  = y0;
+                vParams[2]  = x1;
+                vParams[3]  = y1;
+            }
+
             X11CairoLinearGradient::~X11CairoLinearGradient()
             {
             }
 
+            X11CairoRadialGradient::X11CairoRadialGradient(X11GradientCache *cache, float cx0, float cy0, float r0, float cx1, float cy1, float r1):
+                X11CairoGradient(cache, GRADIENT_RADIAL)
+            {
+                vParams[0]  = cx0;
+                vParams[1]  = cy0;
+                vParams[2]  = r0;
+                vParams[3]  = cx1;
+                vParams[4]  = cy1;
+                vParams[5]  = r1;
+            }
+
             X11CairoRadialGradient::~X11CairoRadialGradient()
             {
             }
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+
+#include <lsp-plug.in/stdlib/math.h>
+#include <private/x11/X11CairoPath.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            X11CairoPath::X11CairoPath()
+            {
+                clear();
+            }
+
+            X11CairoPath::~X11CairoPath()
+            {
+                vOps.flush();
+            }
+
+            void X11CairoPath::clear()
+            {
+                vOps.clear();
+                fStartX         = 0.0f;
+                fStartY         = 0.0f;
+                fLastX          = 0.0f;
+                fLastY          = 0.0f;
+                bCurrent        = false;
+                bBounds         = false;
+                vBounds[0]      = 0.0f;
+                vBounds[1]      = 0.0f;
+                vBounds[2]      = 0.0f;
+                vBounds[3]      = 0.0f;
+            }
+
+            X11CairoPath::op_t *X11CairoPath::add_op(op_type_t type)
+            {
+                op_t *op        = vOps.add();
+                if (op != NULL)
+                    op->enType      = type;
+                return op;
+            }
+
+            void X11CairoPath::add_bounds(float x, float y)
+            {
+                // The first point initializes the bounding box
+                if (!bBounds)
+                {
+                    vBounds[0]      = x;
+                    vBounds[1]      = y;
+                    vBounds[2]      = x;
+                    vBounds[3]      = y;
+                    bBounds         = true;
+                    return;
+                }
+
+                vBounds[0]      = lsp_min(vBounds[0], x);
+                vBounds[1]      = lsp_min(vBounds[1], y);
+                vBounds[2]      = lsp_max(vBounds[2], x);
+                vBounds[3]      = lsp_max(vBounds[3], y);
+            }
+
+            status_t X11CairoPath::move_to(float x, float y)
+            {
+                op_t *op        = add_op(OP_MOVE_TO);
+                if (op == NULL)
+                    return STATUS_NO_MEM;
+
+                op->vArgs[0]    = x;
+                op->vArgs[1]    = y;
+                add_bounds(x, y);
+
+                fStartX         = x;
+                fStartY         = y;
+                fLastX          = x;
+                fLastY          = y;
+                bCurrent        = true;
+
+                return STATUS_OK;
+            }
+
+            status_t X11CairoPath::line_to(float x, float y)
+            {
+                // Line without current point behaves as move_to, as in cairo
+                if (!bCurrent)
+                    return move_to(x, y);
+
+                op_t *op        = add_op(OP_LINE_TO);
+                if (op == NULL)
+                    return STATUS_NO_MEM;
+
+                op->vArgs[0]    = x;
+                op->vArgs[1]    = y;
+                add_bounds(x, y);
+
+                fLastX          = x;
+                fLastY          = y;
+
+                return STATUS_OK;
+            }
+
+            status_t X11CairoPath::curve_to(float x1, float y1, float x2, float y2, float x3, float y3)
+            {
+                status_t res;
+                if ((!bCurrent) && ((res = move_to(x1, y1)) != STATUS_OK))
+                    return res;
+
+                op_t *op        = add_op(OP_CURVE_TO);
+                if (op == NULL)
+                    return STATUS_NO_MEM;
+
+                op->vArgs[0]    = x1;
+                op->vArgs[1]    = y1;
+                op->vArgs[2]    = x2;
+                op->vArgs[3]    = y2;
+                op->vArgs[4]    = x3;
+                op->vArgs[5]    = y3;
+                add_bounds(x1, y1);
+                add_bounds(x2, y2);
+                add_bounds(x3, y3);
+
+                fLastX          = x3;
+                fLastY          = y3;
+
+                return STATUS_OK;
+            }
+
+            status_t X11CairoPath::arc(float cx, float cy, float r, float a1, float a2)
+            {
+                // Degenerate arc is the line to the center point, as in cairo
+                if (r <= 0.0f)
+                    return line_to(cx, cy);
+                while (a2 < a1)
+                    a2             += 2.0f * M_PI;
+
+                op_t *op        = add_op(OP_ARC);
+                if (op == NULL)
+                    return STATUS_NO_MEM;
+
+                op->vArgs[0]    = cx;
+                op->vArgs[1]    = cy;
+                op->vArgs[2]    = r;
+                op->vArgs[3]    = a1;
+                op->vArgs[4]    = a2;
+
+                // The arc starts with the line from the current point or with the new sub-path
+                float sx        = cx + r * cosf(a1);
+                float sy        = cy + r * sinf(a1);
+                add_bounds(sx, sy);
+                if (!bCurrent)
+                {
+                    fStartX         = sx;
+                    fStartY         = sy;
+                    bCurrent        = true;
+                }
+
+                // Extreme points of the circle which belong to the arc
+                ssize_t first   = ceilf(a1 * (2.0f / M_PI));
+                ssize_t last    = lsp_min(ssize_t(floorf(a2 * (2.0f / M_PI))), first + 3);
+                for (ssize_t i=first; i<=last; ++i)
+                {
+                    float a         = i * (0.5f * M_PI);
+                    add_bounds(cx + r * cosf(a), cy + r * sinf(a));
+                }
+
+                fLastX          = cx + r * cosf(a2);
+                fLastY          = cy + r * sinf(a2);
+                add_bounds(fLastX, fLastY);
+
+                return STATUS_OK;
+            }
+
+            status_t X11CairoPath::close()
+            {
+                if (!bCurrent)
+                    return STATUS_OK;
+
+                if (add_op(OP_CLOSE) == NULL)
+                    return STATUS_NO_MEM;
+
+                // The current point is moved to the start of the sub-path
+                fLastX          = fStartX;
+                fLastY          = fStartY;
+
+                return STATUS_OK;
+            }
+
+            bool X11CairoPath::get_bounds(float *bounds) const
+            {
+                if (is_empty())
+                    return false;
+
+                bounds[0]       = vBounds[0];
+                bounds[1]       = vBounds[1];
+                bounds[2]       = vBounds[2];
+                bounds[3]       = vBounds[3];
+                return true;
+            }
+
+            void X11CairoPath::append(cairo_t *cr, float x, float y)
+            {
+                if (is_empty())
+                    return;
+
+                // Translate the coordinate system instead of the path data
+                cairo_matrix_t m;
+                ::cairo_get_matrix(cr, &m);
+                ::cairo_translate(cr, x, y);
+
+                for (size_t i=0, n=vOps.size(); i<n; ++i)
+                {
+                    const op_t *op  = vOps.uget(i);
+                    const float *v  = op->vArgs;
+                    switch (op->enType)
+                    {
+                        case OP_MOVE_TO:
+                            ::cairo_move_to(cr, v[0], v[1]);
+                            break;
+                        case OP_LINE_TO:
+                            ::cairo_line_to(cr, v[0], v[1]);
+                            break;
+                        case OP_CURVE_TO:
+                            ::cairo_curve_to(cr, v[0], v[1], v[2], v[3], v[4], v[5]);
+                            break;
+                        case OP_ARC:
+                            ::cairo_arc(cr, v[0], v[1], v[2], v[3], v[4]);
+                            break;
+                        case OP_CLOSE:
+                            ::cairo_close_path(cr);
+                            break;
+                        default:
+                            break;
+                    }
+                }
+
+                ::cairo_set_matrix(cr, &m);
+            }
+        }
+    }
+}
+
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
@@ -25,13 +25,23 @@
 #if defined(USE_LIBX11) && defined (USE_LIBCAIRO)
 
 #include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/ws/pixels.h>
 #include <private/x11/X11CairoGradient.h>
 #include <private/x11/X11CairoSurface.h>
+#include <private/x11/X11Decimation.h>
 #include <private/x11/X11Display.h>
 #include <cairo/cairo.h>
 #include <cairo/cairo-ft.h>
 #include <cairo/cairo-xlib.h>
 
+#ifdef USE_LIBXEXT
+    #include <X11/Xutil.h>
+    #include <X11/extensions/XShm.h>
+    #include <sys/ipc.h>
+    #include <sys/shm.h>
+#endif /* USE_LIBXEXT */
+
 // Freetype headers
 #ifdef USE_LIBFREETYPE
     #include <ft2build.h>
@@ -60,6 +70,39 @@ namespace lsp
                 return CAIRO_ANTIALIAS_DEFAULT;
             }
 
+            static inline cairo_format_t decode_format(surface_format_t format)
+            {
+                switch (format)
+                {
+                    case SFMT_RGB24: return CAIRO_FORMAT_RGB24;
+                    case SFMT_A8: return CAIRO_FORMAT_A8;
+                    default: break;
+                }
+                return CAIRO_FORMAT_ARGB32;
+            }
+
+            static inline cairo_filter_t decode_filter(surface_filter_t filter)
+            {
+                switch (filter)
+                {
+                    case SFLT_NEAREST: return CAIRO_FILTER_NEAREST;
+                    case SFLT_FAST: return CAIRO_FILTER_FAST;
+                    case SFLT_BEST: return CAIRO_FILTER_BEST;
+                    default: break;
+                }
+                return CAIRO_FILTER_GOOD;
+            }
+
+            static inline bool pixel_aligned(float v)
+            {
+                return (v >= -8388608.0f) && (v <= 8388608.0f) && (float(ssize_t(v)) == v);
+            }
+
+            static inline bool pixel_aligned(float x, float y, float w, float h)
+            {
+                return pixel_aligned(x) && pixel_aligned(y) && pixel_aligned(w) && pixel_aligned(h);
+            }
+
             X11CairoSurface::X11CairoSurface(X11Display *dpy, Drawable drawable, Visual *visual, size_t width, size_t height):
                 ISurface(width, height, ST_XLIB)
             {
@@ -67,26 +110,127 @@ namespace lsp
                 pCR             = NULL;
                 pFO             = NULL;
                 pSurface        = ::cairo_xlib_surface_create(dpy->x11display(), drawable, visual, width, height);
+                pFront          = NULL;
+                pShm            = NULL;
+                enBuffering     = BUF_NONE;
+                nViewLeft       = 0;
+                nViewTop        = 0;
+                bView           = false;
+                bPooled         = false;
+                reset_damage();
+                reset_state();
+                bDecimation     = false;
+                nPathStamp      = 0;
+            }
+
+            X11CairoSurface::X11CairoSurface(X11Display *dpy, size_t width, size_t height, surface_format_t format):
+                ISurface(width, height, ST_IMAGE)
+            {
+                pDisplay        = dpy;
+                pCR             = NULL;
+                pFO             = NULL;
+                pSurface        = dpy->sSurfacePool.acquire(decode_format(format), width, height, true);
+                pFront          = NULL;
+                pShm            = NULL;
+                enBuffering     = BUF_NONE;
+                nStride         = cairo_image_surface_get_stride(pSurface);
+                nViewLeft       = 0;
+                nViewTop        = 0;
+                bView           = false;
+                bPooled         = true;
+                reset_damage();
+                reset_state();
+                bDecimation     = false;
+                nPathStamp      = 0;
             }
 
-            X11CairoSurface::X11CairoSurface(X11Display *dpy, size_t width, size_t height):
-                ISurface(width, height, ST_IMAGE)
+            X11CairoSurface::X11CairoSurface(X11Display *dpy, cairo_surface_t *surface, ssize_t left, ssize_t top):
+                ISurface(::cairo_image_surface_get_width(surface), ::cairo_image_surface_get_height(surface), ST_IMAGE)
             {
                 pDisplay        = dpy;
                 pCR             = NULL;
                 pFO             = NULL;
-                pSurface        = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+                pSurface        = surface;
+                pFront          = NULL;
+                pShm            = NULL;
+                enBuffering     = BUF_NONE;
                 nStride         = cairo_image_surface_get_stride(pSurface);
+                nViewLeft       = left;
+                nViewTop        = top;
+                bView           = true;
+                bPooled         = false;
+                reset_damage();
+                reset_state();
+                bDecimation     = false;
+                nPathStamp      = 0;
             }
 
             ISurface *X11CairoSurface::create(size_t width, size_t height)
             {
-                return new X11CairoSurface(pDisplay, width, height);
+                return new X11CairoSurface(pDisplay, width, height, SFMT_ARGB32);
+            }
+
+            ISurface *X11CairoSurface::create(size_t width, size_t height, surface_format_t format)
+            {
+                return new X11CairoSurface(pDisplay, width, height, format);
+            }
+
+            surface_format_t X11CairoSurface::format() const
+            {
+                if ((nType != ST_IMAGE) || (pSurface == NULL))
+                    return SFMT_ARGB32;
+
+                switch (::cairo_image_surface_get_format(pSurface))
+                {
+                    case CAIRO_FORMAT_RGB24: return SFMT_RGB24;
+                    case CAIRO_FORMAT_A8: return SFMT_A8;
+                    default: break;
+                }
+                return SFMT_ARGB32;
+            }
+
+            ISurface *X11CairoSurface::create_view(ssize_t left, ssize_t top, size_t width, size_t height)
+            {
+                if ((nType != ST_IMAGE) || (pSurface == NULL))
+                    return NULL;
+
+                cairo_format_t fmt  = ::cairo_image_surface_get_format(pSurface);
+                size_t bpp          = (fmt == CAIRO_FORMAT_A8) ? sizeof(uint8_t) : sizeof(uint32_t);
+                if ((fmt != CAIRO_FORMAT_ARGB32) && (fmt != CAIRO_FORMAT_RGB24) && (fmt != CAIRO_FORMAT_A8))
+                    return NULL;
+
+                // Clip the area by the surface
+                left               -= nViewLeft;
+                top                -= nViewTop;
+                ssize_t l           = lsp_max(left, ssize_t(0));
+                ssize_t t           = lsp_max(top, ssize_t(0));
+                ssize_t r           = lsp_min(ssize_t(left + width), ssize_t(nWidth));
+                ssize_t b           = lsp_min(ssize_t(top + height), ssize_t(nHeight));
+                if ((l >= r) || (t >= b))
+                    return NULL;
+
+                // Create image surface which refers the pixel data of this surface
+                ::cairo_surface_flush(pSurface);
+                uint8_t *data       = ::cairo_image_surface_get_data(pSurface);
+                size_t stride       = ::cairo_image_surface_get_stride(pSurface);
+                cairo_surface_t *s  = ::cairo_image_surface_create_for_data(
+                        &data[t * stride + l * bpp], fmt, r - l, b - t, stride);
+                if (::cairo_surface_status(s) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_surface_destroy(s);
+                    return NULL;
+                }
+
+                // Views use coordinates of the parent surface
+                X11CairoSurface *view = new X11CairoSurface(pDisplay, s, nViewLeft + l, nViewTop + t);
+                if (view == NULL)
+                    ::cairo_surface_destroy(s);
+                return view;
             }
 
             ISurface *X11CairoSurface::create_copy()
             {
-                X11CairoSurface *s = new X11CairoSurface(pDisplay, nWidth, nHeight);
+                X11CairoSurface *s = new X11CairoSurface(pDisplay, nWidth, nHeight, format());
                 if (s == NULL)
                     return NULL;
 
@@ -101,17 +245,18 @@ namespace lsp
 
             IGradient *X11CairoSurface::linear_gradient(float x0, float y0, float x1, float y1)
             {
-                return new X11CairoLinearGradient(x0, y0, x1, y1);
+                return new X11CairoLinearGradient(&pDisplay->sGradientCache, x0, y0, x1, y1);
             }
 
             IGradient *X11CairoSurface::radial_gradient(float cx0, float cy0, float r0, float cx1, float cy1, float r1)
             {
-                return new X11CairoRadialGradient(cx0, cy0, r0, cx1, cy1, r1);
+                return new X11CairoRadialGradient(&pDisplay->sGradientCache, cx0, cy0, r0, cx1, cy1, r1);
             }
 
             X11CairoSurface::~X11CairoSurface()
             {
                 destroy_context();
+                drop_path_cache();
             }
 
             void X11CairoSurface::destroy_context()
@@ -128,55 +273,159 @@ namespace lsp
                 }
                 if (pSurface != NULL)
                 {
-                    cairo_surface_destroy(pSurface);
+                    if (bPooled)
+                        pDisplay->sSurfacePool.release(pSurface);
+                    else
+                        cairo_surface_destroy(pSurface);
                     pSurface        = NULL;
                 }
+                if (pFront != NULL)
+                {
+                    cairo_surface_destroy(pFront);
+                    pFront          = NULL;
+                }
+                if (pShm != NULL)
+                {
+                    free_shm_buffer(pShm);
+                    pShm            = NULL;
+                }
             }
 
             void X11CairoSurface::destroy()
             {
                 destroy_context();
+                drop_path_cache();
             }
 
             bool X11CairoSurface::resize(size_t width, size_t height)
             {
-                if (nType == ST_XLIB)
+                return resize(width, height, true);
+            }
+
+            bool X11CairoSurface::resize(size_t width, size_t height, bool copy)
+            {
+                if (bView)
+                    return false;
+                else if (nType == ST_XLIB)
                 {
+                    drop_back_buffer();
                     ::cairo_xlib_surface_set_size(pSurface, width, height);
+                    nWidth      = width;
+                    nHeight     = height;
+                    reset_damage();
+
+                    // Create new back buffer, the window will be redrawn after resize
+                    if (enBuffering != BUF_NONE)
+                    {
+                        cairo_surface_t *s  = create_back_buffer(enBuffering, width, height);
+                        if (s != NULL)
+                        {
+                            pFront      = pSurface;
+                            pSurface    = s;
+                        }
+                        else
+                            enBuffering = BUF_NONE;
+                    }
                     return true;
                 }
                 else if (nType == ST_IMAGE)
+                    return resize_image(width, height, copy);
+
+                return false;
+            }
+
+            bool X11CairoSurface::resize_image(size_t width, size_t height, bool copy)
+            {
+                if ((width == nWidth) && (height == nHeight))
+                    return true;
+
+                // The cairo context refers the current image, finish drawing first
+                end();
+
+                // Estimate the capacity of the image
+                cairo_surface_t *backing    = X11SurfacePool::backing(pSurface);
+                cairo_format_t fmt          = ::cairo_image_surface_get_format(backing);
+                size_t cap_w                = ::cairo_image_surface_get_width(backing);
+                size_t cap_h                = ::cairo_image_surface_get_height(backing);
+                size_t new_w                = (width > cap_w) ? lsp_max(width, cap_w * CAPACITY_GROW_NUM / CAPACITY_GROW_DEN) : cap_w;
+                size_t new_h                = (height > cap_h) ? lsp_max(height, cap_h * CAPACITY_GROW_NUM / CAPACITY_GROW_DEN) : cap_h;
+                if ((width * height * CAPACITY_SHRINK_RATIO) < (new_w * new_h))
                 {
-                    // Create new surface and cairo
-                    cairo_surface_t *s  = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-                    if (s == NULL)
-                        return false;
-                    cairo_t *cr         = ::cairo_create(s);
-                    if (cr == NULL)
+                    new_w                       = width;
+                    new_h                       = height;
+                }
+
+                if ((new_w == cap_w) && (new_h == cap_h))
+                {
+                    // The image has enough capacity, the contents remain in place. The area
+                    // outside of the previous size may keep pixels of an earlier larger size
+                    if ((width > nWidth) || (height > nHeight))
                     {
-                        cairo_surface_destroy(s);
-                        return false;
+                        size_t bpp                  = (fmt == CAIRO_FORMAT_A8) ? 1 : sizeof(uint32_t);
+                        size_t stride               = ::cairo_image_surface_get_stride(backing);
+                        size_t keep_w               = lsp_min(width, nWidth);
+                        size_t keep_h               = lsp_min(height, nHeight);
+                        uint8_t *row                = ::cairo_image_surface_get_data(backing);
+
+                        ::cairo_surface_flush(pSurface);
+                        ::cairo_surface_flush(backing);
+                        for (size_t i=0; i<height; ++i, row += stride)
+                        {
+                            size_t from                 = (i < keep_h) ? keep_w : 0;
+                            if (from < width)
+                                ::memset(&row[from * bpp], 0, (width - from) * bpp);
+                        }
+                        ::cairo_surface_mark_dirty(backing);
                     }
 
-                    // Draw previous content
-                    ::cairo_set_source_surface(cr, pSurface, 0, 0);
-                    ::cairo_fill(cr);
-
-                    // Destroy previously used context
-                    destroy_context();
+                    ::cairo_surface_reference(backing);
+                }
+                else
+                {
+                    // Allocate new image
+                    backing                     = ::cairo_image_surface_create(fmt, new_w, new_h);
+                    if (::cairo_surface_status(backing) != CAIRO_STATUS_SUCCESS)
+                    {
+                        ::cairo_surface_destroy(backing);
+                        return false;
+                    }
 
-                    // Update context
-                    pSurface            = s;
-                    if (pCR != NULL)
+                    // Copy previous contents
+                    if (copy)
                     {
-                        ::cairo_destroy(pCR);
-                        pCR                 = cr;
+                        size_t rows                 = lsp_min(height, nHeight);
+                        size_t bytes                = ::cairo_format_stride_for_width(fmt, lsp_min(width, nWidth));
+                        size_t src_stride           = ::cairo_image_surface_get_stride(pSurface);
+                        size_t dst_stride           = ::cairo_image_surface_get_stride(backing);
+                        const uint8_t *src          = ::cairo_image_surface_get_data(pSurface);
+                        uint8_t *dst                = ::cairo_image_surface_get_data(backing);
+
+                        ::cairo_surface_flush(pSurface);
+                        ::cairo_surface_flush(backing);
+                        for (size_t i=0; i<rows; ++i, src += src_stride, dst += dst_stride)
+                            ::memcpy(dst, src, bytes);
+                        ::cairo_surface_mark_dirty(backing);
                     }
-                    else
-                        ::cairo_destroy(cr);
                 }
 
-                return false;
+                // Use the whole image or the view of its top-left area
+                cairo_surface_t *s  = ((width == new_w) && (height == new_h)) ? backing : X11SurfacePool::create_view(backing, width, height);
+                if (s == NULL)
+                    return false;
+
+                // Replace the image
+                if (bPooled)
+                    pDisplay->sSurfacePool.release(pSurface);
+                else
+                    ::cairo_surface_destroy(pSurface);
+
+                pSurface    = s;
+                nWidth      = width;
+                nHeight     = height;
+                nStride     = ::cairo_image_surface_get_stride(pSurface);
+                reset_damage();
+
+                return true;
             }
 
             void X11CairoSurface::draw(ISurface *s, float x, float y)
@@ -190,12 +439,41 @@ namespace lsp
                 if (cs->pSurface == NULL)
                     return;
 
+                // Pixel-aligned images are copied directly
+                if ((pixel_aligned(x)) && (pixel_aligned(y)) &&
+                    (direct_draw(cs, x, y, 0, 0, cs->nWidth, cs->nHeight)))
+                    return;
+
                 // Draw one surface on another
+                add_damage_rect(x, y, cs->nWidth, cs->nHeight);
                 ::cairo_set_source_surface(pCR, cs->pSurface, x, y);
                 ::cairo_paint(pCR);
+                sState.bSource  = false;
+            }
+
+            void X11CairoSurface::draw_mask(const Color &color, ISurface *mask, float x, float y)
+            {
+                surface_type_t type = mask->type();
+                if ((type != ST_XLIB) && (type != ST_IMAGE))
+                    return;
+                if (pCR == NULL)
+                    return;
+                X11CairoSurface *cs = static_cast<X11CairoSurface *>(mask);
+                if (cs->pSurface == NULL)
+                    return;
+
+                // Fill the color through the alpha channel of the mask
+                add_damage_rect(x, y, cs->nWidth, cs->nHeight);
+                setSourceRGBA(color.red(), color.green(), color.blue(), 1.0f - color.alpha());
+                ::cairo_mask_surface(pCR, cs->pSurface, x, y);
             }
 
             void X11CairoSurface::draw(ISurface *s, float x, float y, float sx, float sy)
+            {
+                draw(s, x, y, sx, sy, SFLT_GOOD);
+            }
+
+            void X11CairoSurface::draw(ISurface *s, float x, float y, float sx, float sy, surface_filter_t filter)
             {
                 surface_type_t type = s->type();
                 if ((type != ST_XLIB) && (type != ST_IMAGE))
@@ -206,6 +484,11 @@ namespace lsp
                 if (cs->pSurface == NULL)
                     return;
 
+                // Unscaled pixel-aligned images are copied directly
+                if ((sx == 1.0f) && (sy == 1.0f) && (pixel_aligned(x)) && (pixel_aligned(y)) &&
+                    (direct_draw(cs, x, y, 0, 0, cs->nWidth, cs->nHeight)))
+                    return;
+
                 // Draw one surface on another
                 ::cairo_save(pCR);
                 if (sx < 0.0f)
@@ -214,7 +497,9 @@ namespace lsp
                     y       -= sy * s->height();
                 ::cairo_translate(pCR, x, y);
                 ::cairo_scale(pCR, sx, sy);
+                add_damage_rect(0.0f, 0.0f, cs->nWidth, cs->nHeight);
                 ::cairo_set_source_surface(pCR, cs->pSurface, 0.0f, 0.0f);
+                ::cairo_pattern_set_filter(::cairo_get_source(pCR), decode_filter(filter));
                 ::cairo_paint(pCR);
                 ::cairo_restore(pCR);
             }
@@ -238,86 +523,815 @@ namespace lsp
                     y       -= sy * s->height();
                 ::cairo_translate(pCR, x, y);
                 ::cairo_scale(pCR, sx, sy);
+                add_damage_rect(0.0f, 0.0f, cs->nWidth, cs->nHeight);
+                ::cairo_set_source_surface(pCR, cs->pSurface, 0.0f, 0.0f);
+                ::cairo_paint_with_alpha(pCR, 1.0f - a);
+                ::cairo_restore(pCR);
+            }
+
+            void X11CairoSurface::draw_rotate_alpha(ISurface *s, float x, float y, float sx, float sy, float ra, float a)
+            {
+                surface_type_t type = s->type();
+                if ((type != ST_XLIB) && (type != ST_IMAGE))
+                    return;
+                if (pCR == NULL)
+                    return;
+                X11CairoSurface *cs = static_cast<X11CairoSurface *>(s);
+                if (cs->pSurface == NULL)
+                    return;
+
+                // Draw one surface on another
+                ::cairo_save(pCR);
+                ::cairo_translate(pCR, x, y);
+                ::cairo_scale(pCR, sx, sy);
+                ::cairo_rotate(pCR, ra);
+                add_damage_rect(0.0f, 0.0f, cs->nWidth, cs->nHeight);
                 ::cairo_set_source_surface(pCR, cs->pSurface, 0.0f, 0.0f);
                 ::cairo_paint_with_alpha(pCR, 1.0f - a);
                 ::cairo_restore(pCR);
             }
 
-            void X11CairoSurface::draw_rotate_alpha(ISurface *s, float x, float y, float sx, float sy, float ra, float a)
+            void X11CairoSurface::draw_clipped(ISurface *s, float x, float y, float sx, float sy, float sw, float sh)
+            {
+                surface_type_t type = s->type();
+                if ((type != ST_XLIB) && (type != ST_IMAGE))
+                    return;
+                if (pCR == NULL)
+                    return;
+                X11CairoSurface *cs = static_cast<X11CairoSurface *>(s);
+                if (cs->pSurface == NULL)
+                    return;
+
+                // Pixel-aligned areas are copied directly
+                if ((sw >= 0.0f) && (sh >= 0.0f) && (pixel_aligned(x)) && (pixel_aligned(y)) &&
+                    (pixel_aligned(sx, sy, sw, sh)) &&
+                    (direct_draw(cs, x, y, sx, sy, sw, sh)))
+                    return;
+
+                // Draw one surface on another
+                ::cairo_save(pCR);
+                ::cairo_set_source_surface(pCR, cs->pSurface, x - sx, y - sy);
+                ::cairo_rectangle(pCR, x, y, sw, sh);
+                do_fill();
+                ::cairo_restore(pCR);
+            }
+
+            void X11CairoSurface::draw_batch(ISurface *s, const surface_blit_t *list, size_t count)
+            {
+                surface_type_t type = s->type();
+                if ((type != ST_XLIB) && (type != ST_IMAGE))
+                    return;
+                if ((pCR == NULL) || (count <= 0))
+                    return;
+                X11CairoSurface *cs = static_cast<X11CairoSurface *>(s);
+                if (cs->pSurface == NULL)
+                    return;
+
+                // Pixel-aligned blits are copied directly, other ones use the single
+                // pattern for all rectangles, only the pattern matrix is changed
+                cairo_pattern_t *cp = NULL;
+                cairo_matrix_t m;
+                for (size_t i=0; i<count; ++i)
+                {
+                    const surface_blit_t *b = &list[i];
+                    if ((b->nWidth <= 0) || (b->nHeight <= 0))
+                        continue;
+                    if ((pixel_aligned(b->fX)) && (pixel_aligned(b->fY)) &&
+                        (direct_draw(cs, b->fX, b->fY, b->nLeft, b->nTop, b->nWidth, b->nHeight)))
+                        continue;
+
+                    if (cp == NULL)
+                    {
+                        cp = ::cairo_pattern_create_for_surface(cs->pSurface);
+                        if (::cairo_pattern_status(cp) != CAIRO_STATUS_SUCCESS)
+                        {
+                            ::cairo_pattern_destroy(cp);
+                            return;
+                        }
+                    }
+
+                    ::cairo_matrix_init_translate(&m, b->nLeft - b->fX, b->nTop - b->fY);
+                    ::cairo_pattern_set_matrix(cp, &m);
+                    ::cairo_set_source(pCR, cp);
+                    ::cairo_rectangle(pCR, b->fX, b->fY, b->nWidth, b->nHeight);
+                    add_damage_rect(b->fX, b->fY, b->nWidth, b->nHeight);
+                    ::cairo_fill(pCR);
+                }
+
+                if (cp != NULL)
+                {
+                    ::cairo_pattern_destroy(cp);
+                    sState.bSource  = false;
+                }
+            }
+
+            void X11CairoSurface::begin()
+            {
+                // Force end() call
+                end();
+                wait_shm();
+                reset_damage();
+                vClips.clear();
+                bDecimation     = false;
+
+                // Create cairo objects
+                pCR             = ::cairo_create(pSurface);
+                if (pCR == NULL)
+                    return;
+                pFO             = ::cairo_font_options_create();
+                if (pFO == NULL)
+                    return;
+
+                // Initialize settings
+                reset_state();
+                ::cairo_set_antialias(pCR, CAIRO_ANTIALIAS_DEFAULT);
+                ::cairo_set_line_join(pCR, CAIRO_LINE_JOIN_BEVEL);
+                if (bView)
+                    ::cairo_translate(pCR, -nViewLeft, -nViewTop);
+            }
+
+            void X11CairoSurface::end()
+            {
+                if (pCR == NULL)
+                    return;
+
+            #ifdef LSP_TRACE
+                if ((nStateCalls + nStateSkips) > 0)
+                    lsp_trace("this=%p, cairo state changes: issued=%d, skipped=%d",
+                        this, int(nStateCalls), int(nStateSkips));
+            #endif /* LSP_TRACE */
+
+                if (pFO != NULL)
+                {
+                    cairo_font_options_destroy(pFO);
+                    pFO             = NULL;
+                }
+                if (pCR != NULL)
+                {
+                    cairo_destroy(pCR);
+                    pCR             = NULL;
+                }
+
+                ::cairo_surface_flush(pSurface);
+
+                // Present the damaged region of the back buffer
+                if ((pFront != NULL) && (nDamage > 0) && (!present_shm()))
+                {
+                    cairo_t *cr     = ::cairo_create(pFront);
+                    if (cr != NULL)
+                    {
+                        ::cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+                        ::cairo_set_source_surface(cr, pSurface, 0.0, 0.0);
+                        for (size_t i=0; i<nDamage; ++i)
+                        {
+                            const rectangle_t *d = &vDamage[i];
+                            ::cairo_rectangle(cr, d->nLeft, d->nTop, d->nWidth, d->nHeight);
+                        }
+                        ::cairo_fill(cr);
+                        ::cairo_destroy(cr);
+                    }
+                    ::cairo_surface_flush(pFront);
+                }
+            }
+
+        #ifdef USE_LIBXEXT
+            struct X11CairoSurface::shm_buffer_t
+            {
+                XShmSegmentInfo     sInfo;          // Shared memory segment
+                XImage             *pImage;         // Image which refers the shared memory segment
+                GC                  hGC;            // Graphic context for XShmPutImage
+                bool                bAttached;      // The segment is attached by the server
+                bool                bPending;       // The server may still read the segment
+            };
+        #endif /* USE_LIBXEXT */
+
+            cairo_surface_t *X11CairoSurface::create_shm_buffer(size_t width, size_t height)
+            {
+            #ifdef USE_LIBXEXT
+                if (!pDisplay->shm_supported())
+                    return NULL;
+
+                Display *dpy        = pDisplay->x11display();
+                Visual *visual      = ::cairo_xlib_surface_get_visual(pSurface);
+                int depth           = ::cairo_xlib_surface_get_depth(pSurface);
+                if ((visual == NULL) || ((depth != 24) && (depth != 32)))
+                    return NULL;
+
+                shm_buffer_t *shm   = static_cast<shm_buffer_t *>(::malloc(sizeof(shm_buffer_t)));
+                if (shm == NULL)
+                    return NULL;
+
+                shm->sInfo.shmseg   = 0;
+                shm->sInfo.shmid    = -1;
+                shm->sInfo.shmaddr  = NULL;
+                shm->sInfo.readOnly = False;
+                shm->hGC            = None;
+                shm->bAttached      = false;
+                shm->bPending       = false;
+
+                // The image should have the same pixel layout as the cairo image surface
+                const uint32_t probe = 1;
+                int byte_order      = (*reinterpret_cast<const uint8_t *>(&probe)) ? LSBFirst : MSBFirst;
+                cairo_format_t fmt  = (depth == 32) ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24;
+
+                shm->pImage         = ::XShmCreateImage(dpy, visual, depth, ZPixmap, NULL, &shm->sInfo, width, height);
+                if ((shm->pImage == NULL) ||
+                    (shm->pImage->bits_per_pixel != 32) ||
+                    (shm->pImage->byte_order != byte_order) ||
+                    (shm->pImage->bytes_per_line != ::cairo_format_stride_for_width(fmt, width)))
+                {
+                    free_shm_buffer(shm);
+                    return NULL;
+                }
+
+                // Allocate and attach the shared memory segment
+                shm->sInfo.shmid    = ::shmget(IPC_PRIVATE, shm->pImage->bytes_per_line * height, IPC_CREAT | 0600);
+                if (shm->sInfo.shmid < 0)
+                {
+                    free_shm_buffer(shm);
+                    return NULL;
+                }
+
+                void *addr          = ::shmat(shm->sInfo.shmid, NULL, 0);
+                if (addr != reinterpret_cast<void *>(-1))
+                {
+                    shm->sInfo.shmaddr  = static_cast<char *>(addr);
+                    shm->pImage->data   = shm->sInfo.shmaddr;
+                    shm->bAttached      = pDisplay->shm_attach(&shm->sInfo);
+                }
+
+                // The segment will be released after it is detached by both client and server
+                ::shmctl(shm->sInfo.shmid, IPC_RMID, NULL);
+                if (!shm->bAttached)
+                {
+                    free_shm_buffer(shm);
+                    return NULL;
+                }
+
+                shm->hGC            = ::XCreateGC(dpy, ::cairo_xlib_surface_get_drawable(pSurface), 0, NULL);
+
+                cairo_surface_t *s  = ::cairo_image_surface_create_for_data(
+                        reinterpret_cast<unsigned char *>(shm->sInfo.shmaddr),
+                        fmt, width, height, shm->pImage->bytes_per_line);
+                if (::cairo_surface_status(s) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_surface_destroy(s);
+                    free_shm_buffer(shm);
+                    return NULL;
+                }
+
+                pShm                = shm;
+                return s;
+            #else
+                return NULL;
+            #endif /* USE_LIBXEXT */
+            }
+
+            void X11CairoSurface::free_shm_buffer(shm_buffer_t *shm)
+            {
+            #ifdef USE_LIBXEXT
+                if (shm == NULL)
+                    return;
+
+                // Requests are processed in order, so the pending XShmPutImage completes before detach
+                Display *dpy        = pDisplay->x11display();
+                if (shm->bAttached)
+                    ::XShmDetach(dpy, &shm->sInfo);
+                if (shm->hGC != None)
+                    ::XFreeGC(dpy, shm->hGC);
+                if (shm->pImage != NULL)
+                {
+                    shm->pImage->data   = NULL;
+                    XDestroyImage(shm->pImage);
+                }
+                if (shm->sInfo.shmaddr != NULL)
+                    ::shmdt(shm->sInfo.shmaddr);
+
+                ::free(shm);
+            #endif /* USE_LIBXEXT */
+            }
+
+            bool X11CairoSurface::present_shm()
+            {
+            #ifdef USE_LIBXEXT
+                if (pShm == NULL)
+                    return false;
+
+                Display *dpy        = pDisplay->x11display();
+                Drawable front      = ::cairo_xlib_surface_get_drawable(pFront);
+                for (size_t i=0; i<nDamage; ++i)
+                {
+                    const rectangle_t *d = &vDamage[i];
+                    ::XShmPutImage(dpy, front, pShm->hGC, pShm->pImage,
+                        d->nLeft, d->nTop, d->nLeft, d->nTop, d->nWidth, d->nHeight,
+                        False);
+                }
+                ::XFlush(dpy);
+                pShm->bPending      = true;
+
+                return true;
+            #else
+                return false;
+            #endif /* USE_LIBXEXT */
+            }
+
+            void X11CairoSurface::wait_shm()
+            {
+            #ifdef USE_LIBXEXT
+                // Do not modify the segment until the server completes the previous XShmPutImage
+                if ((pShm != NULL) && (pShm->bPending))
+                {
+                    ::XSync(pDisplay->x11display(), False);
+                    pShm->bPending      = false;
+                }
+            #endif /* USE_LIBXEXT */
+            }
+
+            cairo_surface_t *X11CairoSurface::create_back_buffer(buffering_t mode, size_t width, size_t height)
+            {
+                cairo_surface_t *s      = NULL;
+
+                switch (mode)
+                {
+                    case BUF_IMAGE:
+                        // Prefer the image in shared memory
+                        if ((s = create_shm_buffer(width, height)) != NULL)
+                            break;
+                        s   = ::cairo_image_surface_create(
+                                (::cairo_surface_get_content(pSurface) == CAIRO_CONTENT_COLOR) ? CAIRO_FORMAT_RGB24 : CAIRO_FORMAT_ARGB32,
+                                width, height);
+                        break;
+                    case BUF_PIXMAP:
+                        s   = ::cairo_surface_create_similar(pSurface, ::cairo_surface_get_content(pSurface), width, height);
+                        break;
+                    default:
+                        return NULL;
+                }
+
+                if ((s != NULL) && (::cairo_surface_status(s) != CAIRO_STATUS_SUCCESS))
+                {
+                    ::cairo_surface_destroy(s);
+                    s   = NULL;
+                }
+
+                return s;
+            }
+
+            void X11CairoSurface::drop_back_buffer()
+            {
+                if (pFront == NULL)
+                    return;
+
+                ::cairo_surface_destroy(pSurface);
+                free_shm_buffer(pShm);
+                pShm            = NULL;
+                pSurface        = pFront;
+                pFront          = NULL;
+            }
+
+            bool X11CairoSurface::set_buffering(buffering_t mode)
+            {
+                if (nType != ST_XLIB)
+                    return false;
+                if (enBuffering == mode)
+                    return true;
+
+                // Draw directly on the window
+                end();
+                drop_back_buffer();
+                enBuffering     = BUF_NONE;
+                reset_damage();
+                if (mode == BUF_NONE)
+                    return true;
+
+                // Create back buffer and initialize it with the current window contents
+                cairo_surface_t *s  = create_back_buffer(mode, nWidth, nHeight);
+                if (s == NULL)
+                    return false;
+
+                cairo_t *cr         = ::cairo_create(s);
+                if (cr != NULL)
+                {
+                    ::cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+                    ::cairo_set_source_surface(cr, pSurface, 0.0, 0.0);
+                    ::cairo_paint(cr);
+                    ::cairo_destroy(cr);
+                }
+
+                pFront          = pSurface;
+                pSurface        = s;
+                enBuffering     = mode;
+
+                return true;
+            }
+
+            void X11CairoSurface::reset_damage()
+            {
+                nDamage             = 0;
+            }
+
+            void X11CairoSurface::damage_all()
+            {
+                if ((nDamage == 1) && (vDamage[0].nWidth == ssize_t(nWidth)) && (vDamage[0].nHeight == ssize_t(nHeight)))
+                    return;
+
+                rectangle_t *d      = &vDamage[0];
+                d->nLeft            = 0;
+                d->nTop             = 0;
+                d->nWidth           = nWidth;
+                d->nHeight          = nHeight;
+                nDamage             = 1;
+            }
+
+            void X11CairoSurface::add_damage(double x1, double y1, double x2, double y2)
+            {
+                // Only the back buffer presentation needs the precise region
+                if (!track_damage())
+                {
+                    damage_all();
+                    return;
+                }
+
+                // Clip the bounding box by the current clip
+                double cx1, cy1, cx2, cy2;
+                ::cairo_clip_extents(pCR, &cx1, &cy1, &cx2, &cy2);
+                x1              = lsp_max(x1, cx1);
+                y1              = lsp_max(y1, cy1);
+                x2              = lsp_min(x2, cx2);
+                y2              = lsp_min(y2, cy2);
+                if ((x1 >= x2) || (y1 >= y2))
+                    return;
+
+                // Transform the bounding box into device space
+                double vx[4]    = { x1, x2, x1, x2 };
+                double vy[4]    = { y1, y1, y2, y2 };
+                for (size_t i=0; i<4; ++i)
+                    ::cairo_user_to_device(pCR, &vx[i], &vy[i]);
+
+                double xmin     = lsp_min(lsp_min(vx[0], vx[1]), lsp_min(vx[2], vx[3]));
+                double xmax     = lsp_max(lsp_max(vx[0], vx[1]), lsp_max(vx[2], vx[3]));
+                double ymin     = lsp_min(lsp_min(vy[0], vy[1]), lsp_min(vy[2], vy[3]));
+                double ymax     = lsp_max(lsp_max(vy[0], vy[1]), lsp_max(vy[2], vy[3]));
+
+                add_device_damage(floor(xmin), floor(ymin), ceil(xmax), ceil(ymax));
+            }
+
+            void X11CairoSurface::add_device_damage(ssize_t l, ssize_t t, ssize_t r, ssize_t b)
+            {
+                if (!track_damage())
+                {
+                    damage_all();
+                    return;
+                }
+
+                // Clip by the surface
+                l               = lsp_max(l, ssize_t(0));
+                t               = lsp_max(t, ssize_t(0));
+                r               = lsp_min(r, ssize_t(nWidth));
+                b               = lsp_min(b, ssize_t(nHeight));
+                if ((l >= r) || (t >= b))
+                    return;
+
+                while (true)
+                {
+                    // Drop rectangles covered by the new one, skip the new one if it is already covered
+                    ssize_t best        = -1;
+                    ssize_t best_cost   = 0;
+
+                    for (size_t i=0; i<nDamage; )
+                    {
+                        rectangle_t *d      = &vDamage[i];
+                        ssize_t dr          = d->nLeft + d->nWidth;
+                        ssize_t db          = d->nTop + d->nHeight;
+
+                        if ((d->nLeft <= l) && (d->nTop <= t) && (dr >= r) && (db >= b))
+                            return;
+                        if ((l <= d->nLeft) && (t <= d->nTop) && (r >= dr) && (b >= db))
+                        {
+                            vDamage[i]          = vDamage[--nDamage];
+                            continue;
+                        }
+
+                        // Estimate the area added by merging the rectangles
+                        ssize_t cost        = (lsp_max(r, dr) - lsp_min(l, d->nLeft)) * (lsp_max(b, db) - lsp_min(t, d->nTop))
+                                            - d->nWidth * d->nHeight;
+                        if ((best < 0) || (cost < best_cost))
+                        {
+                            best                = i;
+                            best_cost           = cost;
+                        }
+                        ++i;
+                    }
+
+                    if (nDamage < DAMAGE_RECTS)
+                    {
+                        rectangle_t *d      = &vDamage[nDamage++];
+                        d->nLeft            = l;
+                        d->nTop             = t;
+                        d->nWidth           = r - l;
+                        d->nHeight          = b - t;
+                        return;
+                    }
+
+                    // The region is full: merge with the cheapest rectangle and add the result again
+                    rectangle_t *d      = &vDamage[best];
+                    l                   = lsp_min(l, d->nLeft);
+                    t                   = lsp_min(t, d->nTop);
+                    r                   = lsp_max(r, d->nLeft + d->nWidth);
+                    b                   = lsp_max(b, d->nTop + d->nHeight);
+                    vDamage[best]       = vDamage[--nDamage];
+                }
+            }
+
+            size_t X11CairoSurface::get_damage(rectangle_t *rects, size_t count)
+            {
+                count           = lsp_min(count, nDamage);
+                for (size_t i=0; i<count; ++i)
+                    rects[i]        = vDamage[i];
+                return nDamage;
+            }
+
+            void X11CairoSurface::add_damage_rect(double x, double y, double w, double h)
+            {
+                add_damage(x, y, x + w, y + h);
+            }
+
+            static inline bool square_dot_aligned(float width)
+            {
+                // Square caps of the odd-width dot lie on pixel boundaries
+                return (width >= 1.0f) && (width <= 4096.0f) && (pixel_aligned(width)) && (ssize_t(width) & 1);
+            }
+
+            bool X11CairoSurface::direct_fill_begin(direct_fill_t *df, float r, float g, float b, float a)
+            {
+                // Only image surfaces with the default compositing are supported
+                if ((nType != ST_IMAGE) || (pCR == NULL) || (pSurface == NULL))
+                    return false;
+                if (::cairo_image_surface_get_format(pSurface) != CAIRO_FORMAT_ARGB32)
+                    return false;
+                if (sState.enOperator != CAIRO_OPERATOR_OVER)
+                    return false;
+
+                // Compute the clipping rectangle
+                df->vClip[0]    = 0;
+                df->vClip[1]    = 0;
+                df->vClip[2]    = nWidth;
+                df->vClip[3]    = nHeight;
+
+                size_t n        = vClips.size();
+                if (n > 0)
+                {
+                    const clip_t *c = vClips.uget(n - 1);
+                    if (!c->bAligned)
+                        return false;
+                    df->vClip[0]    = lsp_max(df->vClip[0], c->nLeft);
+                    df->vClip[1]    = lsp_max(df->vClip[1], c->nTop);
+                    df->vClip[2]    = lsp_min(df->vClip[2], c->nRight);
+                    df->vClip[3]    = lsp_min(df->vClip[3], c->nBottom);
+                }
+
+                df->pData       = NULL;
+                df->nStride     = 0;
+                df->nPixel      = pixels::pixel(r, g, b, a);
+                df->vDirty[0]   = df->vClip[2];
+                df->vDirty[1]   = df->vClip[3];
+                df->vDirty[2]   = df->vClip[0];
+                df->vDirty[3]   = df->vClip[1];
+
+                return true;
+            }
+
+            void X11CairoSurface::direct_fill_rect(direct_fill_t *df, ssize_t left, ssize_t top, ssize_t width, ssize_t height)
+            {
+                // Fully transparent color does not change anything
+                if (df->nPixel == 0)
+                    return;
+
+                // Normalize the rectangle the same way as cairo does
+                if (width < 0)
+                {
+                    left           += width;
+                    width           = -width;
+                }
+                if (height < 0)
+                {
+                    top            += height;
+                    height          = -height;
+                }
+
+                // Translate into device space and clip
+                ssize_t l       = lsp_max(left - nViewLeft, df->vClip[0]);
+                ssize_t t       = lsp_max(top - nViewTop, df->vClip[1]);
+                ssize_t r       = lsp_min(left + width - nViewLeft, df->vClip[2]);
+                ssize_t b       = lsp_min(top + height - nViewTop, df->vClip[3]);
+                if ((l >= r) || (t >= b))
+                    return;
+
+                // Flush pending cairo operations before the first access to the pixel data
+                if (df->pData == NULL)
+                {
+                    ::cairo_surface_flush(pSurface);
+                    df->pData       = ::cairo_image_surface_get_data(pSurface);
+                    df->nStride     = ::cairo_image_surface_get_stride(pSurface);
+                    if (df->pData == NULL)
+                    {
+                        df->nPixel      = 0;
+                        return;
+                    }
+                }
+
+                uint8_t *row    = &df->pData[t * df->nStride + l * sizeof(uint32_t)];
+                pixels::blend_fill(row, df->nStride, r - l, b - t, df->nPixel);
+
+                df->vDirty[0]   = lsp_min(df->vDirty[0], l);
+                df->vDirty[1]   = lsp_min(df->vDirty[1], t);
+                df->vDirty[2]   = lsp_max(df->vDirty[2], r);
+                df->vDirty[3]   = lsp_max(df->vDirty[3], b);
+            }
+
+            void X11CairoSurface::direct_fill_end(direct_fill_t *df)
+            {
+                if (df->pData == NULL)
+                    return;
+
+                ssize_t w       = df->vDirty[2] - df->vDirty[0];
+                ssize_t h       = df->vDirty[3] - df->vDirty[1];
+                if ((w <= 0) || (h <= 0))
+                    return;
+
+                ::cairo_surface_mark_dirty_rectangle(pSurface, df->vDirty[0], df->vDirty[1], w, h);
+                add_device_damage(df->vDirty[0], df->vDirty[1], df->vDirty[2], df->vDirty[3]);
+            }
+
+            bool X11CairoSurface::direct_draw(X11CairoSurface *cs, ssize_t x, ssize_t y, ssize_t sx, ssize_t sy, ssize_t sw, ssize_t sh)
+            {
+                // Only ARGB32 and RGB24 image sources are supported
+                cairo_surface_t *src    = cs->pSurface;
+                if (::cairo_surface_get_type(src) != CAIRO_SURFACE_TYPE_IMAGE)
+                    return false;
+                cairo_format_t fmt      = ::cairo_image_surface_get_format(src);
+                if ((fmt != CAIRO_FORMAT_ARGB32) && (fmt != CAIRO_FORMAT_RGB24))
+                    return false;
+
+                // The clipping and the compositing mode are checked the same way as for solid fill
+                direct_fill_t df;
+                if (!direct_fill_begin(&df, 0.0f, 0.0f, 0.0f, 0.0f))
+                    return false;
+
+                // Clip the source rectangle by the source surface
+                ssize_t src_w           = ::cairo_image_surface_get_width(src);
+                ssize_t src_h           = ::cairo_image_surface_get_height(src);
+                if (sx < 0)
+                {
+                    x          -= sx;
+                    sw         += sx;
+                    sx          = 0;
+                }
+                if (sy < 0)
+                {
+                    y          -= sy;
+                    sh         += sy;
+                    sy          = 0;
+                }
+                sw                      = lsp_min(sw, src_w - sx);
+                sh                      = lsp_min(sh, src_h - sy);
+
+                // Translate into device space and clip
+                x                      -= nViewLeft;
+                y                      -= nViewTop;
+                ssize_t l               = lsp_max(x, df.vClip[0]);
+                ssize_t t               = lsp_max(y, df.vClip[1]);
+                ssize_t r               = lsp_min(x + sw, df.vClip[2]);
+                ssize_t b               = lsp_min(y + sh, df.vClip[3]);
+                if ((l >= r) || (t >= b))
+                    return true;
+
+                ::cairo_surface_flush(src);
+                ::cairo_surface_flush(pSurface);
+                const uint8_t *sdata    = ::cairo_image_surface_get_data(src);
+                uint8_t *ddata          = ::cairo_image_surface_get_data(pSurface);
+                size_t sstride          = ::cairo_image_surface_get_stride(src);
+                size_t dstride          = ::cairo_image_surface_get_stride(pSurface);
+                if ((sdata == NULL) || (ddata == NULL))
+                    return false;
+
+                // Surfaces which share pixel data (views) are drawn by cairo
+                const uint8_t *dend     = &ddata[dstride * ::cairo_image_surface_get_height(pSurface)];
+                const uint8_t *send     = &sdata[sstride * src_h];
+                if ((sdata < dend) && (ddata < send))
+                    return false;
+
+                const uint8_t *srow     = &sdata[(sy + t - y) * sstride + (sx + l - x) * sizeof(uint32_t)];
+                uint8_t *drow           = &ddata[t * dstride + l * sizeof(uint32_t)];
+
+                if (fmt == CAIRO_FORMAT_RGB24)
+                    pixels::copy_opaque(drow, dstride, srow, sstride, r - l, b - t);
+                else
+                    pixels::blend(drow, dstride, srow, sstride, r - l, b - t);
+
+                ::cairo_surface_mark_dirty_rectangle(pSurface, l, t, r - l, b - t);
+                add_device_damage(l, t, r, b);
+
+                return true;
+            }
+
+            void X11CairoSurface::do_fill()
             {
-                surface_type_t type = s->type();
-                if ((type != ST_XLIB) && (type != ST_IMAGE))
-                    return;
-                if (pCR == NULL)
-                    return;
-                X11CairoSurface *cs = static_cast<X11CairoSurface *>(s);
-                if (cs->pSurface == NULL)
-                    return;
+                if (track_damage())
+                {
+                    double x1, y1, x2, y2;
+                    ::cairo_fill_extents(pCR, &x1, &y1, &x2, &y2);
+                    add_damage(x1, y1, x2, y2);
+                }
+                else
+                    damage_all();
+                ::cairo_fill(pCR);
+            }
 
-                // Draw one surface on another
-                ::cairo_save(pCR);
-                ::cairo_translate(pCR, x, y);
-                ::cairo_scale(pCR, sx, sy);
-                ::cairo_rotate(pCR, ra);
-                ::cairo_set_source_surface(pCR, cs->pSurface, 0.0f, 0.0f);
-                ::cairo_paint_with_alpha(pCR, 1.0f - a);
-                ::cairo_restore(pCR);
+            void X11CairoSurface::do_fill_preserve()
+            {
+                if (track_damage())
+                {
+                    double x1, y1, x2, y2;
+                    ::cairo_fill_extents(pCR, &x1, &y1, &x2, &y2);
+                    add_damage(x1, y1, x2, y2);
+                }
+                else
+                    damage_all();
+                ::cairo_fill_preserve(pCR);
             }
 
-            void X11CairoSurface::draw_clipped(ISurface *s, float x, float y, float sx, float sy, float sw, float sh)
+            void X11CairoSurface::add_stroke_damage()
             {
-                surface_type_t type = s->type();
-                if ((type != ST_XLIB) && (type != ST_IMAGE))
-                    return;
-                if (pCR == NULL)
-                    return;
-                X11CairoSurface *cs = static_cast<X11CairoSurface *>(s);
-                if (cs->pSurface == NULL)
+                if (!track_damage())
+                {
+                    damage_all();
                     return;
+                }
 
-                // Draw one surface on another
-                ::cairo_save(pCR);
-                ::cairo_set_source_surface(pCR, cs->pSurface, x - sx, y - sy);
-                ::cairo_rectangle(pCR, x, y, sw, sh);
-                ::cairo_fill(pCR);
-                ::cairo_restore(pCR);
+                // Computing exact stroke extents runs the stroker, so the bounding box of the
+                // path is extended by the maximum distance of the outline from the path
+                double x1, y1, x2, y2;
+                ::cairo_path_extents(pCR, &x1, &y1, &x2, &y2);
+
+                double k        = (::cairo_get_line_cap(pCR) == CAIRO_LINE_CAP_SQUARE) ? M_SQRT2 : 1.0;
+                if (::cairo_get_line_join(pCR) == CAIRO_LINE_JOIN_MITER)
+                    k               = lsp_max(k, ::cairo_get_miter_limit(pCR));
+                double w        = ::cairo_get_line_width(pCR) * 0.5 * k + 1.0;
+
+                add_damage(x1 - w, y1 - w, x2 + w, y2 + w);
             }
 
-            void X11CairoSurface::begin()
+            void X11CairoSurface::do_stroke()
             {
-                // Force end() call
-                end();
-
-                // Create cairo objects
-                pCR             = ::cairo_create(pSurface);
-                if (pCR == NULL)
-                    return;
-                pFO             = ::cairo_font_options_create();
-                if (pFO == NULL)
-                    return;
+                do_stroke(enLineCap);
+            }
 
-                // Initialize settings
-                ::cairo_set_antialias(pCR, CAIRO_ANTIALIAS_DEFAULT);
-                ::cairo_set_line_join(pCR, CAIRO_LINE_JOIN_BEVEL);
+            void X11CairoSurface::do_stroke(cairo_line_cap_t cap)
+            {
+                setLineCap(cap);
+                add_stroke_damage();
+                ::cairo_stroke(pCR);
             }
 
-            void X11CairoSurface::end()
+            void X11CairoSurface::do_stroke_preserve()
             {
-                if (pCR == NULL)
-                    return;
+                setLineCap(enLineCap);
+                add_stroke_damage();
+                ::cairo_stroke_preserve(pCR);
+            }
 
-                if (pFO != NULL)
+            void X11CairoSurface::do_paint()
+            {
+                if (track_damage())
                 {
-                    cairo_font_options_destroy(pFO);
-                    pFO             = NULL;
+                    double x1, y1, x2, y2;
+                    ::cairo_clip_extents(pCR, &x1, &y1, &x2, &y2);
+                    add_damage(x1, y1, x2, y2);
                 }
-                if (pCR != NULL)
+                else
+                    damage_all();
+                ::cairo_paint(pCR);
+            }
+
+            void X11CairoSurface::do_show_text(const char *text)
+            {
+                if (!track_damage())
                 {
-                    cairo_destroy(pCR);
-                    pCR             = NULL;
+                    damage_all();
+                    ::cairo_show_text(pCR, text);
+                    return;
                 }
 
-                ::cairo_surface_flush(pSurface);
+                // Glyphs are antialiased, so extend the ink rectangle by one pixel
+                double x, y;
+                cairo_text_extents_t te;
+                ::cairo_get_current_point(pCR, &x, &y);
+                ::cairo_text_extents(pCR, text, &te);
+                x  += te.x_bearing;
+                y  += te.y_bearing;
+                add_damage(x - 1.0, y - 1.0, x + te.width + 1.0, y + te.height + 1.0);
+                ::cairo_show_text(pCR, text);
             }
 
             void X11CairoSurface::set_current_font(font_context_t *ctx, const Font &f)
@@ -327,14 +1341,16 @@ namespace lsp
                 cairo_font_options_set_antialias(pFO, decode_antialiasing(f));
                 cairo_set_font_options(pCR, pFO);
 
-                // Try to select custom font face
+                // Try to select custom font face, the face may be created concurrently by views
+                while (!atomic_cas(&pDisplay->hFontLock, 0, 1)) { /* Wait */ }
                 X11Display::font_t *font = pDisplay->get_font(f.get_name());
+                cairo_font_face_t *ff = NULL;
                 if (font != NULL)
                 {
                     size_t index = (f.is_bold())    ? 0x1 : 0;
                     index       |= (f.is_italic())  ? 0x2 : 0;
 
-                    cairo_font_face_t *ff = font->cr_face[index];
+                    ff = font->cr_face[index];
                     if (ff == NULL)
                     {
                         ff = cairo_ft_font_face_create_for_ft_face(font->ft_face, 0);
@@ -365,16 +1381,17 @@ namespace lsp
                                 cairo_ft_font_face_set_synthesize(ff, CAIRO_FT_SYNTHESIZE_OBLIQUE);
                         }
                     }
+                }
+                pDisplay->hFontLock = 0;
 
-                    if (ff != NULL)
-                    {
-                        cairo_set_font_face(pCR, ff);
-                        cairo_set_font_size(pCR, f.get_size());
+                if (ff != NULL)
+                {
+                    cairo_set_font_face(pCR, ff);
+                    cairo_set_font_size(pCR, f.get_size());
 
-                        ctx->font   = font;
-                        ctx->face   = ff;
-                        return;
-                    }
+                    ctx->font   = font;
+                    ctx->face   = ff;
+                    return;
                 }
 
                 // Try to select fall-back font face
@@ -410,42 +1427,116 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
-                cairo_operator_t op = cairo_get_operator(pCR);
-                ::cairo_set_operator (pCR, CAIRO_OPERATOR_SOURCE);
-                ::cairo_set_source_rgba(pCR,
+                cairo_operator_t op = sState.enOperator;
+                setOperator(CAIRO_OPERATOR_SOURCE);
+                setSourceRGBA(
                     float((rgba >> 16) & 0xff)/255.0f,
                     float((rgba >> 8) & 0xff)/255.0f,
                     float(rgba & 0xff)/255.0f,
                     float((rgba >> 24) & 0xff)/255.0f
                 );
-                ::cairo_paint(pCR);
-                ::cairo_set_operator (pCR, op);
-            }
+                do_paint();
+                setOperator(op);
+            }
+
+            void X11CairoSurface::reset_state()
+            {
+                // Initial state of the newly created cairo context
+                sState.vSource[0]       = 0.0f;
+                sState.vSource[1]       = 0.0f;
+                sState.vSource[2]       = 0.0f;
+                sState.vSource[3]       = 1.0f;
+                sState.bSource          = true;
+                sState.fLineWidth       = 2.0;
+                sState.enLineCap        = CAIRO_LINE_CAP_BUTT;
+                sState.enAntialias      = CAIRO_ANTIALIAS_DEFAULT;
+                sState.enOperator       = CAIRO_OPERATOR_OVER;
+                enLineCap               = CAIRO_LINE_CAP_BUTT;
+                nStateCalls             = 0;
+                nStateSkips             = 0;
+            }
+
+            #define STATE_CHANGED(changed) \
+                if (changed) \
+                    ++nStateCalls; \
+                else \
+                { \
+                    ++nStateSkips; \
+                    return; \
+                }
 
             inline void X11CairoSurface::setSourceRGB(const Color &col)
             {
-                if (pCR == NULL)
-                    return;
-                ::cairo_set_source_rgb(pCR, col.red(), col.green(), col.blue());
+                setSourceRGBA(col.red(), col.green(), col.blue(), 1.0f);
             }
 
             inline void X11CairoSurface::setSourceRGBA(const Color &col)
+            {
+                setSourceRGBA(col.red(), col.green(), col.blue(), 1.0f - col.alpha());
+            }
+
+            void X11CairoSurface::setSourceRGBA(float r, float g, float b, float a)
             {
                 if (pCR == NULL)
                     return;
-                ::cairo_set_source_rgba(pCR, col.red(), col.green(), col.blue(), 1.0f - col.alpha());
+
+                float *v = sState.vSource;
+                STATE_CHANGED((!sState.bSource) || (v[0] != r) || (v[1] != g) || (v[2] != b) || (v[3] != a));
+
+                ::cairo_set_source_rgba(pCR, r, g, b, a);
+                v[0]                = r;
+                v[1]                = g;
+                v[2]                = b;
+                v[3]                = a;
+                sState.bSource      = true;
+            }
+
+            void X11CairoSurface::setSourceGradient(X11CairoGradient *g)
+            {
+                g->apply(pCR);
+                sState.bSource      = false;
+            }
+
+            void X11CairoSurface::setLineWidth(double width)
+            {
+                STATE_CHANGED(sState.fLineWidth != width);
+                ::cairo_set_line_width(pCR, width);
+                sState.fLineWidth   = width;
+            }
+
+            void X11CairoSurface::setLineCap(cairo_line_cap_t cap)
+            {
+                STATE_CHANGED(sState.enLineCap != cap);
+                ::cairo_set_line_cap(pCR, cap);
+                sState.enLineCap    = cap;
             }
 
+            void X11CairoSurface::setAntialias(cairo_antialias_t aa)
+            {
+                STATE_CHANGED(sState.enAntialias != aa);
+                ::cairo_set_antialias(pCR, aa);
+                sState.enAntialias  = aa;
+            }
+
+            void X11CairoSurface::setOperator(cairo_operator_t op)
+            {
+                STATE_CHANGED(sState.enOperator != op);
+                ::cairo_set_operator(pCR, op);
+                sState.enOperator   = op;
+            }
+
+            #undef STATE_CHANGED
+
             void X11CairoSurface::clear(const Color &color)
             {
                 if (pCR == NULL)
                     return;
 
                 setSourceRGBA(color);
-                cairo_operator_t op = ::cairo_get_operator(pCR);
-                ::cairo_set_operator (pCR, CAIRO_OPERATOR_SOURCE);
-                ::cairo_paint(pCR);
-                ::cairo_set_operator (pCR, op);
+                cairo_operator_t op = sState.enOperator;
+                setOperator(CAIRO_OPERATOR_SOURCE);
+                do_paint();
+                setOperator(op);
             }
 
             void X11CairoSurface::fill_rect(const Color &color, float left, float top, float width, float height)
@@ -453,9 +1544,18 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
+                direct_fill_t df;
+                if ((pixel_aligned(left, top, width, height)) &&
+                    (direct_fill_begin(&df, color.red(), color.green(), color.blue(), color.alpha())))
+                {
+                    direct_fill_rect(&df, left, top, width, height);
+                    direct_fill_end(&df);
+                    return;
+                }
+
                 setSourceRGBA(color);
                 ::cairo_rectangle(pCR, left, top, width, height);
-                ::cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_rect(IGradient *g, float left, float top, float width, float height)
@@ -464,9 +1564,9 @@ namespace lsp
                     return;
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
-                cg->apply(pCR);
+                setSourceGradient(cg);
                 cairo_rectangle(pCR, left, top, width, height);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::wire_rect(const Color &color, float left, float top, float width, float height, float line_width)
@@ -474,12 +1574,31 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
+                // Bevel joins produce partially covered corners when antialiasing is enabled,
+                // so only one-pixel non-antialiased outlines are drawn directly
+                direct_fill_t df;
+                if ((line_width == 1.0f) && (width != 0.0f) && (height != 0.0f) &&
+                    (pixel_aligned(left, top, width, height)) &&
+                    (sState.enAntialias == CAIRO_ANTIALIAS_NONE) &&
+                    (direct_fill_begin(&df, color.red(), color.green(), color.blue(), color.alpha())))
+                {
+                    ssize_t l   = (width < 0.0f) ? left + width : left;
+                    ssize_t t   = (height < 0.0f) ? top + height : top;
+                    ssize_t w   = (width < 0.0f) ? -width : width;
+                    ssize_t h   = (height < 0.0f) ? -height : height;
+
+                    direct_fill_rect(&df, l, t, w + 1, 1);
+                    direct_fill_rect(&df, l, t + 1, 1, h - 1);
+                    direct_fill_rect(&df, l + w, t + 1, 1, h - 1);
+                    direct_fill_rect(&df, l, t + h, w + 1, 1);
+                    direct_fill_end(&df);
+                    return;
+                }
+
                 setSourceRGBA(color);
-                double w = cairo_get_line_width(pCR);
-                cairo_set_line_width(pCR, line_width);
+                setLineWidth(line_width);
                 cairo_rectangle(pCR, left + 0.5f, top + 0.5f, width, height);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, w);
+                do_stroke();
             }
 
             void X11CairoSurface::wire_rect(IGradient *g, float left, float top, float width, float height, float line_width)
@@ -488,13 +1607,78 @@ namespace lsp
                     return;
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
-                cg->apply(pCR);
+                setSourceGradient(cg);
 
-                double w = cairo_get_line_width(pCR);
-                cairo_set_line_width(pCR, line_width);
+                setLineWidth(line_width);
                 cairo_rectangle(pCR, left + 0.5f, top + 0.5f, width, height);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, w);
+                do_stroke();
+            }
+
+            void X11CairoSurface::drop_path_cache()
+            {
+                for (size_t i=0, n=vRoundRects.size(); i<n; ++i)
+                {
+                    round_rect_t *rr    = vRoundRects.uget(i);
+                    if (rr->pPath != NULL)
+                        delete rr->pPath;
+                }
+                vRoundRects.flush();
+            }
+
+            X11CairoPath *X11CairoSurface::cached_round_rect(float width, float height, float radius, size_t mask)
+            {
+                // Lookup the cache
+                round_rect_t *rr    = NULL;
+                for (size_t i=0, n=vRoundRects.size(); i<n; ++i)
+                {
+                    round_rect_t *x     = vRoundRects.uget(i);
+                    if ((x->fWidth == width) && (x->fHeight == height) &&
+                        (x->fRadius == radius) && (x->nMask == mask))
+                    {
+                        x->nStamp           = ++nPathStamp;
+                        return x->pPath;
+                    }
+                    if ((rr == NULL) || (x->nStamp < rr->nStamp))
+                        rr                  = x;
+                }
+
+                // Allocate new entry or replace the least recently used one
+                if (vRoundRects.size() < PATH_CACHE_SIZE)
+                {
+                    if ((rr = vRoundRects.add()) == NULL)
+                        return NULL;
+                    rr->pPath           = NULL;
+                }
+                else if (rr == NULL)
+                    return NULL;
+
+                if (rr->pPath == NULL)
+                {
+                    if ((rr->pPath = new X11CairoPath()) == NULL)
+                    {
+                        vRoundRects.premove(rr);
+                        return NULL;
+                    }
+                }
+                else
+                    rr->pPath->clear();
+
+                rr->fWidth          = width;
+                rr->fHeight         = height;
+                rr->fRadius         = radius;
+                rr->nMask           = mask;
+                rr->nStamp          = ++nPathStamp;
+
+                if (rr->pPath->round_rect(mask, radius, 0.0f, 0.0f, width, height) != STATUS_OK)
+                {
+                    // Invalidate the entry, the mask never matches
+                    rr->pPath->clear();
+                    rr->nMask           = ~size_t(0);
+                    rr->nStamp          = 0;
+                    return NULL;
+                }
+
+                return rr->pPath;
             }
 
             void X11CairoSurface::drawRoundRect(float xmin, float ymin, float width, float height, float radius, size_t mask)
@@ -503,6 +1687,19 @@ namespace lsp
                     return;
 
                 radius = lsp_max(0.0f, radius);
+
+                // Rounded rectangles of the same size are drawn many times,
+                // so build the path once and translate it to the position
+                if (mask & SURFMASK_ALL_CORNER)
+                {
+                    X11CairoPath *path  = cached_round_rect(width, height, radius, mask & SURFMASK_ALL_CORNER);
+                    if (path != NULL)
+                    {
+                        path->append(pCR, xmin, ymin);
+                        return;
+                    }
+                }
+
                 const float xmax = xmin + width;
                 const float ymax = ymin + height;
 
@@ -538,11 +1735,9 @@ namespace lsp
                     return;
 
                 setSourceRGBA(color);
-                double w = cairo_get_line_width(pCR);
-                cairo_set_line_width(pCR, line_width);
+                setLineWidth(line_width);
                 drawRoundRect(left, top, width, height, radius, mask);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, w);
+                do_stroke();
             }
 
             void X11CairoSurface::wire_round_rect(IGradient *g, size_t mask, float radius, float left, float top, float width, float height, float line_width)
@@ -552,12 +1747,10 @@ namespace lsp
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
 
-                double w = cairo_get_line_width(pCR);
-                cairo_set_line_width(pCR, line_width);
-                cg->apply(pCR);
+                setLineWidth(line_width);
+                setSourceGradient(cg);
                 drawRoundRect(left, top, width, height, radius, mask);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, w);
+                do_stroke();
             }
 
             void X11CairoSurface::wire_round_rect_inside(const Color &color, size_t mask, float radius, float left, float top, float width, float height, float line_width)
@@ -566,12 +1759,10 @@ namespace lsp
                     return;
 
                 setSourceRGBA(color);
-                double w = cairo_get_line_width(pCR);
                 float lw2 = line_width * 0.5f;
-                cairo_set_line_width(pCR, line_width);
+                setLineWidth(line_width);
                 drawRoundRect(left + lw2, top + lw2, width - line_width, height - line_width, radius, mask);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, w);
+                do_stroke();
             }
 
             void X11CairoSurface::wire_round_rect_inside(IGradient *g, size_t mask, float radius, float left, float top, float width, float height, float line_width)
@@ -581,13 +1772,11 @@ namespace lsp
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
 
-                double w = cairo_get_line_width(pCR);
                 float lw2 = line_width * 0.5f;
-                cairo_set_line_width(pCR, line_width);
-                cg->apply(pCR);
+                setLineWidth(line_width);
+                setSourceGradient(cg);
                 drawRoundRect(left + lw2, top + lw2, width - line_width, height - line_width, radius, mask);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, w);
+                do_stroke();
             }
 
             void X11CairoSurface::fill_round_rect(const Color &color, size_t mask, float radius, float left, float top, float width, float height)
@@ -597,7 +1786,7 @@ namespace lsp
 
                 setSourceRGBA(color);
                 drawRoundRect(left, top, width, height, radius, mask);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_round_rect(const Color &color, size_t mask, float radius, const ws::rectangle_t *r)
@@ -606,7 +1795,7 @@ namespace lsp
                     return;
                 setSourceRGBA(color);
                 drawRoundRect(r->nLeft, r->nTop, r->nWidth, r->nHeight, radius, mask);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_round_rect(IGradient *g, size_t mask, float radius, float left, float top, float width, float height)
@@ -615,9 +1804,9 @@ namespace lsp
                     return;
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
-                cg->apply(pCR);
+                setSourceGradient(cg);
                 drawRoundRect(left, top, width, height, radius, mask);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_round_rect(IGradient *g, size_t mask, float radius, const ws::rectangle_t *r)
@@ -626,9 +1815,9 @@ namespace lsp
                     return;
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
-                cg->apply(pCR);
+                setSourceGradient(cg);
                 drawRoundRect(r->nLeft, r->nTop, r->nWidth, r->nHeight, radius, mask);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::full_rect(float left, float top, float width, float height, float line_width, const Color &color)
@@ -637,10 +1826,10 @@ namespace lsp
                     return;
 
                 setSourceRGBA(color);
-                cairo_set_line_width(pCR, line_width);
+                setLineWidth(line_width);
                 cairo_rectangle(pCR, left, top, width, height);
-                cairo_stroke_preserve(pCR);
-                cairo_fill(pCR);
+                do_stroke_preserve();
+                do_fill();
             }
 
             void X11CairoSurface::fill_sector(float cx, float cy, float radius, float angle1, float angle2, const Color &color)
@@ -652,7 +1841,7 @@ namespace lsp
                 cairo_move_to(pCR, cx, cy);
                 cairo_arc(pCR, cx, cy, radius, angle1, angle2);
                 cairo_close_path(pCR);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_triangle(float x0, float y0, float x1, float y1, float x2, float y2, IGradient *g)
@@ -661,12 +1850,12 @@ namespace lsp
                     return;
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
-                cg->apply(pCR);
+                setSourceGradient(cg);
                 cairo_move_to(pCR, x0, y0);
                 cairo_line_to(pCR, x1, y1);
                 cairo_line_to(pCR, x2, y2);
                 cairo_close_path(pCR);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_triangle(float x0, float y0, float x1, float y1, float x2, float y2, const Color &color)
@@ -679,7 +1868,7 @@ namespace lsp
                 cairo_line_to(pCR, x1, y1);
                 cairo_line_to(pCR, x2, y2);
                 cairo_close_path(pCR);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             bool X11CairoSurface::get_font_parameters(const Font &f, font_parameters_t *fp)
@@ -775,7 +1964,7 @@ namespace lsp
                     // Draw
                     cairo_move_to(pCR, x, y);
                     setSourceRGBA(color);
-                    cairo_show_text(pCR, text);
+                    do_show_text(text);
 
                     if (f.is_underline())
                     {
@@ -783,11 +1972,11 @@ namespace lsp
                         cairo_text_extents(pCR, text, &te);
                         float width = lsp_max(1.0f, f.get_size() / 12.0f);
 
-                        cairo_set_line_width(pCR, width);
+                        setLineWidth(width);
 
                         cairo_move_to(pCR, x, y + te.y_advance + 1 + width);
                         cairo_line_to(pCR, x + te.x_advance, y + te.y_advance + 1 + width);
-                        cairo_stroke(pCR);
+                        do_stroke();
                     }
                 }
                 unset_current_font(&ctx);
@@ -819,7 +2008,7 @@ namespace lsp
                     float fy    = y - extents.y_advance + (r_h + 4) * 0.5f * (1.0f - dy) - r_h * 0.5f + 1.0f;
 
                     cairo_move_to(pCR, fx, fy);
-                    cairo_show_text(pCR, text);
+                    do_show_text(text);
                 }
                 unset_current_font(&ctx);
             }
@@ -836,16 +2025,21 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
-                double ow = cairo_get_line_width(pCR);
-                cairo_line_cap_t cap = cairo_get_line_cap(pCR);
+                direct_fill_t df;
+                if ((pixel_aligned(x)) && (pixel_aligned(y)) && (square_dot_aligned(width)) &&
+                    (direct_fill_begin(&df, color.red(), color.green(), color.blue(), color.alpha())))
+                {
+                    ssize_t d   = (ssize_t(width) - 1) / 2;
+                    direct_fill_rect(&df, x - d, y - d, width + 1, width);
+                    direct_fill_end(&df);
+                    return;
+                }
+
                 setSourceRGBA(color);
-                cairo_set_line_width(pCR, width);
-                cairo_set_line_cap(pCR, CAIRO_LINE_CAP_SQUARE);
+                setLineWidth(width);
                 cairo_move_to(pCR, x + 0.5f, y + 0.5f);
                 cairo_line_to(pCR, x + 1.5f, y + 0.5f);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, ow);
-                cairo_set_line_cap(pCR, cap);
+                do_stroke(CAIRO_LINE_CAP_SQUARE);
             }
 
             void X11CairoSurface::square_dot(float x, float y, float width, float r, float g, float b, float a)
@@ -853,16 +2047,21 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
-                double ow = cairo_get_line_width(pCR);
-                cairo_line_cap_t cap = cairo_get_line_cap(pCR);
-                cairo_set_source_rgba(pCR, r, g, b, 1.0f - a);
-                cairo_set_line_width(pCR, width);
-                cairo_set_line_cap(pCR, CAIRO_LINE_CAP_SQUARE);
+                direct_fill_t df;
+                if ((pixel_aligned(x)) && (pixel_aligned(y)) && (square_dot_aligned(width)) &&
+                    (direct_fill_begin(&df, r, g, b, a)))
+                {
+                    ssize_t d   = (ssize_t(width) - 1) / 2;
+                    direct_fill_rect(&df, x - d, y - d, width + 1, width);
+                    direct_fill_end(&df);
+                    return;
+                }
+
+                setSourceRGBA(r, g, b, 1.0f - a);
+                setLineWidth(width);
                 cairo_move_to(pCR, x + 0.5f, y + 0.5f);
                 cairo_line_to(pCR, x + 1.5f, y + 0.5f);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, ow);
-                cairo_set_line_cap(pCR, cap);
+                do_stroke(CAIRO_LINE_CAP_SQUARE);
             }
 
             void X11CairoSurface::line(float x0, float y0, float x1, float y1, float width, const Color &color)
@@ -870,13 +2069,11 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
-                double ow = cairo_get_line_width(pCR);
                 setSourceRGBA(color);
-                cairo_set_line_width(pCR, width);
+                setLineWidth(width);
                 cairo_move_to(pCR, x0, y0);
                 cairo_line_to(pCR, x1, y1);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, ow);
+                do_stroke();
             }
 
             void X11CairoSurface::line(float x0, float y0, float x1, float y1, float width, IGradient *g)
@@ -885,14 +2082,49 @@ namespace lsp
                     return;
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
-                cg->apply(pCR);
+                setSourceGradient(cg);
 
-                double ow = cairo_get_line_width(pCR);
-                cairo_set_line_width(pCR, width);
+                setLineWidth(width);
                 cairo_move_to(pCR, x0, y0);
                 cairo_line_to(pCR, x1, y1);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, ow);
+                do_stroke();
+            }
+
+            void X11CairoSurface::draw_lines(const float *x0, const float *y0, const float *x1, const float *y1, size_t n, float width, const Color &color)
+            {
+                if ((pCR == NULL) || (n <= 0))
+                    return;
+
+                // Build the single path and stroke it once
+                for (size_t i=0; i<n; ++i)
+                {
+                    cairo_move_to(pCR, x0[i], y0[i]);
+                    cairo_line_to(pCR, x1[i], y1[i]);
+                }
+
+                setSourceRGBA(color);
+                setLineWidth(width);
+                do_stroke();
+            }
+
+            void X11CairoSurface::draw_polylines(const float *x, const float *y, const size_t *count, size_t n, float width, const Color &color)
+            {
+                if ((pCR == NULL) || (n <= 0))
+                    return;
+
+                // Build the single path and stroke it once
+                for (size_t i=0; i<n; ++i)
+                {
+                    size_t k    = count[i];
+                    if (k >= 2)
+                        poly_path(x, y, k);
+                    x          += k;
+                    y          += k;
+                }
+
+                setSourceRGBA(color);
+                setLineWidth(width);
+                do_stroke();
             }
 
             void X11CairoSurface::parametric_line(float a, float b, float c, float width, const Color &color)
@@ -900,9 +2132,8 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
-                double ow = cairo_get_line_width(pCR);
                 setSourceRGBA(color);
-                cairo_set_line_width(pCR, width);
+                setLineWidth(width);
 
                 if (fabs(a) > fabs(b))
                 {
@@ -915,8 +2146,7 @@ namespace lsp
                     cairo_line_to(pCR, nWidth, -(c + a*nWidth)/b);
                 }
 
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, ow);
+                do_stroke();
             }
 
             void X11CairoSurface::parametric_line(float a, float b, float c, float left, float right, float top, float bottom, float width, const Color &color)
@@ -924,9 +2154,8 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
-                double ow = cairo_get_line_width(pCR);
                 setSourceRGBA(color);
-                cairo_set_line_width(pCR, width);
+                setLineWidth(width);
 
                 if (fabs(a) > fabs(b))
                 {
@@ -939,8 +2168,7 @@ namespace lsp
                     cairo_line_to(pCR, roundf(right), roundf(-(c + a*right)/b));
                 }
 
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, ow);
+                do_stroke();
             }
 
             void X11CairoSurface::parametric_bar(float a1, float b1, float c1, float a2, float b2, float c2,
@@ -950,7 +2178,7 @@ namespace lsp
                     return;
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(gr);
-                cg->apply(pCR);
+                setSourceGradient(cg);
 
                 if (fabs(a1) > fabs(b1))
                 {
@@ -975,7 +2203,7 @@ namespace lsp
                 }
 
                 cairo_close_path(pCR);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::wire_arc(float x, float y, float r, float a1, float a2, float width, const Color &color)
@@ -983,12 +2211,32 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
-                double ow = cairo_get_line_width(pCR);
                 setSourceRGBA(color);
-                cairo_set_line_width(pCR, width);
+                setLineWidth(width);
                 cairo_arc(pCR, x, y, r, a1, a2);
-                cairo_stroke(pCR);
-                cairo_set_line_width(pCR, ow);
+                do_stroke();
+            }
+
+            void X11CairoSurface::poly_path(const float *x, const float *y, size_t n)
+            {
+                // Reduce dense input to the envelope of each pixel column
+                if ((bDecimation) && (n >= DECIMATION_THRESHOLD))
+                {
+                    vDecimated.clear();
+                    float *buf      = vDecimated.append_n(n * 2);
+                    if (buf != NULL)
+                    {
+                        float *dx       = buf;
+                        float *dy       = &buf[n];
+                        n               = decimate_polyline(dx, dy, x, y, n);
+                        x               = dx;
+                        y               = dy;
+                    }
+                }
+
+                cairo_move_to(pCR, x[0], y[0]);
+                for (size_t i=1; i < n; ++i)
+                    cairo_line_to(pCR, x[i], y[i]);
             }
 
             void X11CairoSurface::fill_poly(const Color & color, const float *x, const float *y, size_t n)
@@ -996,12 +2244,10 @@ namespace lsp
                 if ((pCR == NULL) || (n < 2))
                     return;
 
-                cairo_move_to(pCR, *(x++), *(y++));
-                for (size_t i=1; i < n; ++i)
-                    cairo_line_to(pCR, *(x++), *(y++));
+                poly_path(x, y, n);
 
                 setSourceRGBA(color);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_poly(IGradient *gr, const float *x, const float *y, size_t n)
@@ -1009,13 +2255,11 @@ namespace lsp
                 if ((pCR == NULL) || (n < 2) || (gr == NULL))
                     return;
 
-                cairo_move_to(pCR, *(x++), *(y++));
-                for (size_t i=1; i < n; ++i)
-                    cairo_line_to(pCR, *(x++), *(y++));
+                poly_path(x, y, n);
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(gr);
-                cg->apply(pCR);
-                cairo_fill(pCR);
+                setSourceGradient(cg);
+                do_fill();
             }
 
             void X11CairoSurface::wire_poly(const Color & color, float width, const float *x, const float *y, size_t n)
@@ -1023,13 +2267,47 @@ namespace lsp
                 if ((pCR == NULL) || (n < 2))
                     return;
 
-                cairo_move_to(pCR, *(x++), *(y++));
-                for (size_t i=1; i < n; ++i)
-                    cairo_line_to(pCR, *(x++), *(y++));
+                poly_path(x, y, n);
+
+                setSourceRGBA(color);
+                setLineWidth(width);
+                do_stroke();
+            }
+
+            IPath *X11CairoSurface::create_path()
+            {
+                return new X11CairoPath();
+            }
+
+            void X11CairoSurface::fill_path(const Color &color, IPath *path, float x, float y)
+            {
+                if ((pCR == NULL) || (path == NULL))
+                    return;
+
+                static_cast<X11CairoPath *>(path)->append(pCR, x, y);
+                setSourceRGBA(color);
+                do_fill();
+            }
+
+            void X11CairoSurface::fill_path(IGradient *g, IPath *path, float x, float y)
+            {
+                if ((pCR == NULL) || (path == NULL) || (g == NULL))
+                    return;
+
+                static_cast<X11CairoPath *>(path)->append(pCR, x, y);
+                setSourceGradient(static_cast<X11CairoGradient *>(g));
+                do_fill();
+            }
 
+            void X11CairoSurface::wire_path(const Color &color, float width, IPath *path, float x, float y)
+            {
+                if ((pCR == NULL) || (path == NULL))
+                    return;
+
+                static_cast<X11CairoPath *>(path)->append(pCR, x, y);
                 setSourceRGBA(color);
-                cairo_set_line_width(pCR, width);
-                cairo_stroke(pCR);
+                setLineWidth(width);
+                do_stroke();
             }
 
             void X11CairoSurface::draw_poly(const Color &fill, const Color &wire, float width, const float *x, const float *y, size_t n)
@@ -1037,23 +2315,21 @@ namespace lsp
                 if ((pCR == NULL) || (n < 2))
                     return;
 
-                cairo_move_to(pCR, *(x++), *(y++));
-                for (size_t i=1; i < n; ++i)
-                    cairo_line_to(pCR, *(x++), *(y++));
+                poly_path(x, y, n);
 
                 if (width > 0.0f)
                 {
                     setSourceRGBA(fill);
-                    cairo_fill_preserve(pCR);
+                    do_fill_preserve();
 
-                    cairo_set_line_width(pCR, width);
+                    setLineWidth(width);
                     setSourceRGBA(wire);
-                    cairo_stroke(pCR);
+                    do_stroke();
                 }
                 else
                 {
                     setSourceRGBA(fill);
-                    cairo_fill(pCR);
+                    do_fill();
                 }
             }
 
@@ -1064,7 +2340,7 @@ namespace lsp
 
                 setSourceRGBA(color);
                 cairo_arc(pCR, x, y, r, 0.0f, M_PI * 2.0f);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_circle(float x, float y, float r, IGradient *g)
@@ -1073,9 +2349,9 @@ namespace lsp
                     return;
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
-                cg->apply(pCR);
+                setSourceGradient(cg);
                 cairo_arc(pCR, x, y, r, 0, M_PI * 2.0f);
-                cairo_fill(pCR);
+                do_fill();
             }
 
             void X11CairoSurface::fill_frame(
@@ -1089,16 +2365,17 @@ namespace lsp
 
                 float fxe = fx + fw, fye = fy + fh, ixe = ix + iw, iye = iy + ih;
 
-                if ((ix >= fxe) || (ixe < fx) || (iy >= fye) || (iye < fy))
-                {
-                    setSourceRGBA(color);
-                    cairo_rectangle(pCR, fx, fy, fw, fh);
-                    cairo_fill(pCR);
-                    return;
-                }
-                else if ((ix <= fx) && (ixe >= fxe) && (iy <= fy) && (iye >= fye))
+                bool outside = (ix >= fxe) || (ixe < fx) || (iy >= fye) || (iye < fy);
+                if ((!outside) && (ix <= fx) && (ixe >= fxe) && (iy <= fy) && (iye >= fye))
                     return;
 
+                // Pixel-aligned frames are drawn directly into the image
+                direct_fill_t df;
+                bool direct = (pixel_aligned(fx, fy, fw, fh)) && (pixel_aligned(ix, iy, iw, ih)) &&
+                    (direct_fill_begin(&df, color.red(), color.green(), color.blue(), color.alpha()));
+                if (!direct)
+                    setSourceRGBA(color);
+
                 #define MOVE_TO(p, x, y) \
                     /*lsp_trace("move_to: %d, %d", int(x), int(y));*/ \
                     cairo_move_to(p, (x), (y));
@@ -1106,95 +2383,85 @@ namespace lsp
                     /*lsp_trace("line_to: %d, %d", int(x), int(y)); */\
                     cairo_move_to(p, (x), (y));
 
-                #define RECTANGLE(p, x, y, w, h) \
+                #define FILL_RECT(x, y, w, h) \
                     /*lsp_trace("rectangle: %d, %d, %d, %d", int(x), int(y), int(w), int(h)); */ \
-                    cairo_rectangle(p, (x), (y), (w), (h));
+                    if (direct) \
+                        direct_fill_rect(&df, (x), (y), (w), (h)); \
+                    else \
+                    { \
+                        cairo_rectangle(pCR, (x), (y), (w), (h)); \
+                        do_fill(); \
+                    }
 
-                setSourceRGBA(color);
-                if (ix <= fx)
+                if (outside)
+                {
+                    FILL_RECT(fx, fy, fw, fh);
+                }
+                else if (ix <= fx)
                 {
                     if (iy <= fy)
                     { // OK
-                        RECTANGLE(pCR, ixe, fy, fxe - ixe, iye - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        FILL_RECT(ixe, fy, fxe - ixe, iye - fy);
+                        FILL_RECT(fx, iye, fw, fye - iye);
                     }
                     else if (iye >= fye)
                     { // OK
-                        RECTANGLE(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, ixe, iy, fxe - ixe, fye - iy);
-                        cairo_fill(pCR);
+                        FILL_RECT(fx, fy, fw, iy - fy);
+                        FILL_RECT(ixe, iy, fxe - ixe, fye - iy);
                     }
                     else
                     { // OK
-                        RECTANGLE(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, ixe, iy, fxe - ixe, ih);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        FILL_RECT(fx, fy, fw, iy - fy);
+                        FILL_RECT(ixe, iy, fxe - ixe, ih);
+                        FILL_RECT(fx, iye, fw, fye - iye);
                     }
                 }
                 else if (ixe >= fxe)
                 {
                     if (iy <= fy)
                     { // OK ?
-                        RECTANGLE(pCR, fx, fy, ix - fx, iye - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        FILL_RECT(fx, fy, ix - fx, iye - fy);
+                        FILL_RECT(fx, iye, fw, fye - iye);
                     }
                     else if (iye >= fye)
                     { // OK
-                        RECTANGLE(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iy, ix - fx, fye - iy);
-                        cairo_fill(pCR);
+                        FILL_RECT(fx, fy, fw, iy - fy);
+                        FILL_RECT(fx, iy, ix - fx, fye - iy);
                     }
                     else
                     { // OK
-                        RECTANGLE(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iy, ix - fx, ih);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        FILL_RECT(fx, fy, fw, iy - fy);
+                        FILL_RECT(fx, iy, ix - fx, ih);
+                        FILL_RECT(fx, iye, fw, fye - iye);
                     }
                 }
                 else
                 {
                     if (iy <= fy)
                     { // OK
-                        RECTANGLE(pCR, fx, fy, ix - fx, iye - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, ixe, fy, fxe - ixe, iye - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        FILL_RECT(fx, fy, ix - fx, iye - fy);
+                        FILL_RECT(ixe, fy, fxe - ixe, iye - fy);
+                        FILL_RECT(fx, iye, fw, fye - iye);
                     }
                     else if (iye >= fye)
                     { // OK
-                        RECTANGLE(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iy, ix - fx, fye - iy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, ixe, iy, fxe - ixe, fye - iy);
-                        cairo_fill(pCR);
+                        FILL_RECT(fx, fy, fw, iy - fy);
+                        FILL_RECT(fx, iy, ix - fx, fye - iy);
+                        FILL_RECT(ixe, iy, fxe - ixe, fye - iy);
                     }
                     else
                     { // OK
-                        RECTANGLE(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iy, ix - fx, ih);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, ixe, iy, fxe - ixe, ih);
-                        cairo_fill(pCR);
-                        RECTANGLE(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        FILL_RECT(fx, fy, fw, iy - fy);
+                        FILL_RECT(fx, iy, ix - fx, ih);
+                        FILL_RECT(ixe, iy, fxe - ixe, ih);
+                        FILL_RECT(fx, iye, fw, fye - iye);
                     }
                 }
+
+                #undef FILL_RECT
+
+                if (direct)
+                    direct_fill_end(&df);
 //                cairo_close_path(pCR);
 //                cairo_fill(pCR);
             }
@@ -1232,7 +2499,7 @@ namespace lsp
                     cairo_line_to(pCR, ix + iw, iy + radius);
                     cairo_arc_negative(pCR, ix + iw - radius, iy + radius, radius, 2.0*M_PI, 1.5*M_PI);
                     cairo_close_path(pCR);
-                    cairo_fill(pCR);
+                    do_fill();
                 }
                 if (flags & SURFMASK_LT_CORNER)
                 {
@@ -1240,7 +2507,7 @@ namespace lsp
                     cairo_line_to(pCR, ix + radius, iy);
                     cairo_arc_negative(pCR, ix + radius, iy + radius, radius, 1.5*M_PI, 1.0*M_PI);
                     cairo_close_path(pCR);
-                    cairo_fill(pCR);
+                    do_fill();
                 }
                 if (flags & SURFMASK_LB_CORNER)
                 {
@@ -1248,7 +2515,7 @@ namespace lsp
                     cairo_line_to(pCR, ix, iy + ih - radius);
                     cairo_arc_negative(pCR, ix + radius, iy + ih - radius, radius, 1.0*M_PI, 0.5*M_PI);
                     cairo_close_path(pCR);
-                    cairo_fill(pCR);
+                    do_fill();
                 }
                 if (flags & SURFMASK_RB_CORNER)
                 {
@@ -1256,7 +2523,7 @@ namespace lsp
                     cairo_line_to(pCR, ix + iw - radius, iy + ih);
                     cairo_arc_negative(pCR, ix + iw - radius, iy + ih - radius, radius, 0.5*M_PI, 0.0);
                     cairo_close_path(pCR);
-                    cairo_fill(pCR);
+                    do_fill();
                 }
             }
 
@@ -1265,7 +2532,7 @@ namespace lsp
                 if (pCR == NULL)
                     return false;
 
-                return cairo_get_antialias(pCR) != CAIRO_ANTIALIAS_NONE;
+                return sState.enAntialias != CAIRO_ANTIALIAS_NONE;
             }
 
             bool X11CairoSurface::set_antialiasing(bool set)
@@ -1273,9 +2540,21 @@ namespace lsp
                 if (pCR == NULL)
                     return false;
 
-                bool old = cairo_get_antialias(pCR) != CAIRO_ANTIALIAS_NONE;
-                cairo_set_antialias(pCR, (set) ? CAIRO_ANTIALIAS_DEFAULT : CAIRO_ANTIALIAS_NONE);
+                bool old = sState.enAntialias != CAIRO_ANTIALIAS_NONE;
+                setAntialias((set) ? CAIRO_ANTIALIAS_DEFAULT : CAIRO_ANTIALIAS_NONE);
+
+                return old;
+            }
+
+            bool X11CairoSurface::get_decimation()
+            {
+                return bDecimation;
+            }
 
+            bool X11CairoSurface::set_decimation(bool enable)
+            {
+                bool old        = bDecimation;
+                bDecimation     = enable;
                 return old;
             }
 
@@ -1284,7 +2563,7 @@ namespace lsp
                 if (pCR == NULL)
                     return SURFLCAP_BUTT;
 
-                cairo_line_cap_t old = cairo_get_line_cap(pCR);
+                cairo_line_cap_t old = enLineCap;
 
                 return
                     (old == CAIRO_LINE_CAP_BUTT) ? SURFLCAP_BUTT :
@@ -1296,15 +2575,14 @@ namespace lsp
                 if (pCR == NULL)
                     return SURFLCAP_BUTT;
 
-                cairo_line_cap_t old = cairo_get_line_cap(pCR);
+                cairo_line_cap_t old = enLineCap;
 
-                cairo_line_cap_t cap =
+                // The line cap is applied to the context lazily by stroking primitives
+                enLineCap =
                     (lc == SURFLCAP_BUTT) ? CAIRO_LINE_CAP_BUTT :
                     (lc == SURFLCAP_ROUND) ? CAIRO_LINE_CAP_ROUND :
                     CAIRO_LINE_CAP_SQUARE;
 
-                cairo_set_line_cap(pCR, cap);
-
                 return
                     (old == CAIRO_LINE_CAP_BUTT) ? SURFLCAP_BUTT :
                     (old == CAIRO_LINE_CAP_ROUND) ? SURFLCAP_ROUND : SURFLCAP_SQUARE;
@@ -1315,16 +2593,40 @@ namespace lsp
                 if ((pCR == NULL) || (pSurface == NULL) || (nType != ST_IMAGE))
                     return NULL;
 
+                cairo_surface_flush(pSurface);
                 nStride = cairo_image_surface_get_stride(pSurface);
                 return pData = reinterpret_cast<uint8_t *>(cairo_image_surface_get_data(pSurface));
             }
 
             void X11CairoSurface::end_direct()
+            {
+                end_direct(NULL);
+            }
+
+            void X11CairoSurface::end_direct(const rectangle_t *dirty)
             {
                 if ((pCR == NULL) || (pSurface == NULL) || (nType != ST_IMAGE) || (pData == NULL))
                     return;
 
-                cairo_surface_mark_dirty(pSurface);
+                if (dirty != NULL)
+                {
+                    // Invalidate only the modified area clipped by the surface
+                    ssize_t l       = lsp_max(dirty->nLeft, ssize_t(0));
+                    ssize_t t       = lsp_max(dirty->nTop, ssize_t(0));
+                    ssize_t r       = lsp_min(dirty->nLeft + dirty->nWidth, ssize_t(nWidth));
+                    ssize_t b       = lsp_min(dirty->nTop + dirty->nHeight, ssize_t(nHeight));
+                    if ((l < r) && (t < b))
+                    {
+                        cairo_surface_mark_dirty_rectangle(pSurface, l, t, r - l, b - t);
+                        add_device_damage(l, t, r, b);
+                    }
+                }
+                else
+                {
+                    cairo_surface_mark_dirty(pSurface);
+                    add_device_damage(0, 0, nWidth, nHeight);
+                }
+
                 pData = NULL;
             }
 
@@ -1333,6 +2635,33 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
+                // Track the clipping rectangle in device space for direct drawing
+                clip_t *c = vClips.append();
+                if (c != NULL)
+                {
+                    ssize_t n       = vClips.size();
+                    c->sState       = sState;
+                    c->enLineCap    = enLineCap;
+                    c->bAligned     = pixel_aligned(x, y, w, h) && ((n < 2) || (vClips.uget(n - 2)->bAligned));
+                    if (c->bAligned)
+                    {
+                        ssize_t l       = ((w < 0.0f) ? x + w : x) - nViewLeft;
+                        ssize_t t       = ((h < 0.0f) ? y + h : y) - nViewTop;
+                        c->nLeft        = l;
+                        c->nTop         = t;
+                        c->nRight       = l + ((w < 0.0f) ? -w : w);
+                        c->nBottom      = t + ((h < 0.0f) ? -h : h);
+                        if (n >= 2)
+                        {
+                            const clip_t *p = vClips.uget(n - 2);
+                            c->nLeft        = lsp_max(c->nLeft, p->nLeft);
+                            c->nTop         = lsp_max(c->nTop, p->nTop);
+                            c->nRight       = lsp_min(c->nRight, p->nRight);
+                            c->nBottom      = lsp_min(c->nBottom, p->nBottom);
+                        }
+                    }
+                }
+
                 cairo_save(pCR);
                 cairo_rectangle(pCR, x, y, w, h);
                 cairo_clip(pCR);
@@ -1344,6 +2673,13 @@ namespace lsp
                 if (pCR == NULL)
                     return;
 
+                // Restoring the context also restores the graphics state
+                clip_t c;
+                if (vClips.pop(&c))
+                {
+                    sState          = c.sState;
+                    enLineCap       = c.enLineCap;
+                }
                 cairo_restore(pCR);
             }
 
@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+
+#ifdef USE_LIBX11
+
+#include <lsp-plug.in/stdlib/math.h>
+#include <private/x11/X11Decimation.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            namespace generic
+            {
+                size_t find_run_end(const float *x, size_t i, size_t n, float lo, float hi)
+                {
+                    for ( ; (i < n) && (x[i] >= lo) && (x[i] < hi); ++i)
+                        /* nothing */ ;
+                    return i;
+                }
+
+                void find_extremes(const float *y, size_t n, size_t *imin, size_t *imax)
+                {
+                    size_t kmin     = 0, kmax = 0;
+                    for (size_t i=1; i < n; ++i)
+                    {
+                        if (y[i] < y[kmin])
+                            kmin            = i;
+                        if (y[i] > y[kmax])
+                            kmax            = i;
+                    }
+
+                    *imin           = kmin;
+                    *imax           = kmax;
+                }
+            }
+
+        #if defined(__SSE2__)
+            size_t find_run_end(const float *x, size_t i, size_t n, float lo, float hi)
+            {
+                __m128 vlo      = _mm_set1_ps(lo);
+                __m128 vhi      = _mm_set1_ps(hi);
+
+                for ( ; (i + 4) <= n; i += 4)
+                {
+                    __m128 v        = _mm_loadu_ps(&x[i]);
+                    int mask        = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(v, vlo), _mm_cmplt_ps(v, vhi)));
+                    if (mask != 0x0f)
+                    {
+                        for ( ; mask & 1; mask >>= 1)
+                            ++i;
+                        return i;
+                    }
+                }
+                for ( ; (i < n) && (x[i] >= lo) && (x[i] < hi); ++i)
+                    /* nothing */ ;
+
+                return i;
+            }
+
+            void find_extremes(const float *y, size_t n, size_t *imin, size_t *imax)
+            {
+                size_t i        = 0;
+                size_t kmin     = 0, kmax = 0;
+
+                if (n >= 8)
+                {
+                    __m128 vmin     = _mm_loadu_ps(y);
+                    __m128 vmax     = vmin;
+                    __m128i vi      = _mm_set_epi32(3, 2, 1, 0);
+                    __m128i vimin   = vi;
+                    __m128i vimax   = vi;
+                    __m128i step    = _mm_set1_epi32(4);
+
+                    // Keep the first occurrence of extremes in each lane
+                    for (i = 4; (i + 4) <= n; i += 4)
+                    {
+                        __m128 v        = _mm_loadu_ps(&y[i]);
+                        vi              = _mm_add_epi32(vi, step);
+                        __m128 lt       = _mm_cmplt_ps(v, vmin);
+                        __m128 gt       = _mm_cmpgt_ps(v, vmax);
+                        vmin            = _mm_or_ps(_mm_and_ps(lt, v), _mm_andnot_ps(lt, vmin));
+                        vmax            = _mm_or_ps(_mm_and_ps(gt, v), _mm_andnot_ps(gt, vmax));
+                        vimin           = _mm_or_si128(_mm_and_si128(_mm_castps_si128(lt), vi), _mm_andnot_si128(_mm_castps_si128(lt), vimin));
+                        vimax           = _mm_or_si128(_mm_and_si128(_mm_castps_si128(gt), vi), _mm_andnot_si128(_mm_castps_si128(gt), vimax));
+                    }
+
+                    // Reduce lanes, prefer the earlier point on equal values
+                    float fmin[4], fmax[4];
+                    int32_t idmin[4], idmax[4];
+                    _mm_storeu_ps(fmin, vmin);
+                    _mm_storeu_ps(fmax, vmax);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(idmin), vimin);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(idmax), vimax);
+
+                    kmin            = idmin[0];
+                    kmax            = idmax[0];
+                    for (size_t j=1; j<4; ++j)
+                    {
+                        if ((fmin[j] < y[kmin]) || ((fmin[j] == y[kmin]) && (size_t(idmin[j]) < kmin)))
+                            kmin            = idmin[j];
+                        if ((fmax[j] > y[kmax]) || ((fmax[j] == y[kmax]) && (size_t(idmax[j]) < kmax)))
+                            kmax            = idmax[j];
+                    }
+                }
+
+                for ( ; i < n; ++i)
+                {
+                    if (y[i] < y[kmin])
+                        kmin            = i;
+                    if (y[i] > y[kmax])
+                        kmax            = i;
+                }
+
+                *imin           = kmin;
+                *imax           = kmax;
+            }
+        #elif defined(__ARM_NEON)
+            size_t find_run_end(const float *x, size_t i, size_t n, float lo, float hi)
+            {
+                return generic::find_run_end(x, i, n, lo, hi);
+            }
+
+            void find_extremes(const float *y, size_t n, size_t *imin, size_t *imax)
+            {
+                size_t i        = 0;
+                size_t kmin     = 0, kmax = 0;
+
+                if (n >= 8)
+                {
+                    static const uint32_t start[4] = { 0, 1, 2, 3 };
+                    float32x4_t vmin    = vld1q_f32(y);
+                    float32x4_t vmax    = vmin;
+                    uint32x4_t vi       = vld1q_u32(start);
+                    uint32x4_t vimin    = vi;
+                    uint32x4_t vimax    = vi;
+                    uint32x4_t step     = vdupq_n_u32(4);
+
+                    // Keep the first occurrence of extremes in each lane
+                    for (i = 4; (i + 4) <= n; i += 4)
+                    {
+                        float32x4_t v       = vld1q_f32(&y[i]);
+                        vi                  = vaddq_u32(vi, step);
+                        uint32x4_t lt       = vcltq_f32(v, vmin);
+                        uint32x4_t gt       = vcgtq_f32(v, vmax);
+                        vmin                = vbslq_f32(lt, v, vmin);
+                        vmax                = vbslq_f32(gt, v, vmax);
+                        vimin               = vbslq_u32(lt, vi, vimin);
+                        vimax               = vbslq_u32(gt, vi, vimax);
+                    }
+
+                    // Reduce lanes, prefer the earlier point on equal values
+                    float fmin[4], fmax[4];
+                    uint32_t idmin[4], idmax[4];
+                    vst1q_f32(fmin, vmin);
+                    vst1q_f32(fmax, vmax);
+                    vst1q_u32(idmin, vimin);
+                    vst1q_u32(idmax, vimax);
+
+                    kmin            = idmin[0];
+                    kmax            = idmax[0];
+                    for (size_t j=1; j<4; ++j)
+                    {
+                        if ((fmin[j] < y[kmin]) || ((fmin[j] == y[kmin]) && (idmin[j] < kmin)))
+                            kmin            = idmin[j];
+                        if ((fmax[j] > y[kmax]) || ((fmax[j] == y[kmax]) && (idmax[j] < kmax)))
+                            kmax            = idmax[j];
+                    }
+                }
+
+                for ( ; i < n; ++i)
+                {
+                    if (y[i] < y[kmin])
+                        kmin            = i;
+                    if (y[i] > y[kmax])
+                        kmax            = i;
+                }
+
+                *imin           = kmin;
+                *imax           = kmax;
+            }
+        #else
+            size_t find_run_end(const float *x, size_t i, size_t n, float lo, float hi)
+            {
+                return generic::find_run_end(x, i, n, lo, hi);
+            }
+
+            void find_extremes(const float *y, size_t n, size_t *imin, size_t *imax)
+            {
+                generic::find_extremes(y, n, imin, imax);
+            }
+        #endif /* __SSE2__, __ARM_NEON */
+
+            struct generic_kernels_t
+            {
+                static inline size_t find_run_end(const float *x, size_t i, size_t n, float lo, float hi)
+                {
+                    return generic::find_run_end(x, i, n, lo, hi);
+                }
+
+                static inline void find_extremes(const float *y, size_t n, size_t *imin, size_t *imax)
+                {
+                    generic::find_extremes(y, n, imin, imax);
+                }
+            };
+
+            struct kernels_t
+            {
+                static inline size_t find_run_end(const float *x, size_t i, size_t n, float lo, float hi)
+                {
+                    return x11::find_run_end(x, i, n, lo, hi);
+                }
+
+                static inline void find_extremes(const float *y, size_t n, size_t *imin, size_t *imax)
+                {
+                    x11::find_extremes(y, n, imin, imax);
+                }
+            };
+
+            template <class K>
+                static size_t decimate(float *dx, float *dy, const float *x, const float *y, size_t n)
+                {
+                    size_t count    = 0;
+
+                    for (size_t i=0; i<n; )
+                    {
+                        // Find the run of points within the same pixel column
+                        float lo        = floorf(x[i]);
+                        size_t j        = K::find_run_end(x, i + 1, n, lo, lo + 1.0f);
+                        size_t k        = j - i;
+
+                        if (k <= 4)
+                        {
+                            // Nothing to reduce
+                            for ( ; i < j; ++i, ++count)
+                            {
+                                dx[count]       = x[i];
+                                dy[count]       = y[i];
+                            }
+                            continue;
+                        }
+
+                        // Emit the first, the lowest, the highest and the last point of the run
+                        size_t imin, imax;
+                        K::find_extremes(&y[i], k, &imin, &imax);
+                        size_t v[4]     = { 0, lsp_min(imin, imax), lsp_max(imin, imax), k - 1 };
+
+                        for (size_t m=0; m<4; ++m)
+                        {
+                            if ((m > 0) && (v[m] == v[m-1]))
+                                continue;
+                            dx[count]       = x[i + v[m]];
+                            dy[count]       = y[i + v[m]];
+                            ++count;
+                        }
+
+                        i               = j;
+                    }
+
+                    return count;
+                }
+
+            size_t decimate_polyline(float *dx, float *dy, const float *x, const float *y, size_t n)
+            {
+                return decimate<kernels_t>(dx, dy, x, y, n);
+            }
+
+            namespace generic
+            {
+                size_t decimate_polyline(float *dx, float *dy, const float *x, const float *y, size_t n)
+                {
+                    return decimate<generic_kernels_t>(dx, dy, x, y, n);
+                }
+            }
+        }
+    }
+}
+
+#endif /* USE_LIBX11 */
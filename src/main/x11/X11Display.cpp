@@ -33,12 +33,15 @@
 #include <lsp-plug.in/ws/x11/decode.h>
 #include <private/x11/X11Display.h>
 #include <private/x11/X11CairoSurface.h>
+#include <private/x11/X11IconSet.h>
 
 #include <poll.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <X11/Xatom.h>
+#include <X11/XKBlib.h>
 #include <X11/cursorfont.h>
 
 
@@ -48,6 +51,7 @@
 #endif /* USE_LIBCAIRO */
 
 #define X11IOBUF_SIZE               0x100000
+#define X11WNDPOOL_SIZE             2
 
 namespace lsp
 {
@@ -140,6 +144,11 @@ namespace lsp
                 pFocusWindow    = NULL;
                 nBlackColor     = 0;
                 nWhiteColor     = 0;
+                bXkbRepeat      = false;
+                bShm            = false;
+                bShmError       = false;
+                nShmOpcode      = 0;
+                hFontLock       = 0;
                 nIOBufSize      = X11IOBUF_SIZE;
                 pIOBuf          = NULL;
                 hFtLibrary      = NULL;
@@ -154,7 +163,15 @@ namespace lsp
                 sTranslateReq.hDstW     = None;
                 sTranslateReq.bSuccess  = false;
 
+                sPointer.bValid         = false;
+                sPointer.nScreen        = 0;
+                sPointer.nLeft          = 0;
+                sPointer.nTop           = 0;
+
+                nPoolSize               = X11WNDPOOL_SIZE;
+
                 bzero(&sCairoUserDataKey, sizeof(sCairoUserDataKey));
+                bzero(vKeyState, sizeof(vKeyState));
             }
 
             X11Display::~X11Display()
@@ -194,6 +211,19 @@ namespace lsp
                 nBlackColor     = BlackPixel(pDisplay, dfl);
                 nWhiteColor     = WhitePixel(pDisplay, dfl);
 
+                // Enable detectable auto-repeat: the server won't generate fake KeyRelease events for held keys
+                Bool repeat     = False;
+                bXkbRepeat      = (::XkbSetDetectableAutoRepeat(pDisplay, True, &repeat)) && (repeat);
+                lsp_trace("XKB detectable auto-repeat is %s", (bXkbRepeat) ? "enabled" : "not supported");
+
+            #ifdef USE_LIBXEXT
+                // Check for MIT-SHM extension which allows to present images without copying them to the socket
+                int shm_event = 0, shm_error = 0;
+                bShm            = (::XShmQueryExtension(pDisplay)) &&
+                                  (::XQueryExtension(pDisplay, "MIT-SHM", &nShmOpcode, &shm_event, &shm_error));
+                lsp_trace("MIT-SHM extension is %s", (bShm) ? "available" : "not available");
+            #endif /* USE_LIBXEXT */
+
                 for (size_t i=0; i<screens; ++i)
                 {
                     x11_screen_t *s     = vScreens.add();
@@ -288,6 +318,23 @@ namespace lsp
                 return new X11Window(this, DefaultScreen(pDisplay), Window(uintptr_t(handle)), NULL, false);
             }
 
+            IWindow *X11Display::create_window(border_style_t style)
+            {
+                size_t screen   = DefaultScreen(pDisplay);
+
+                // Take pre-initialized window from the pool
+                X11Window *wnd  = take_pooled_window(screen, style);
+                if (wnd != NULL)
+                    return wnd;
+
+                // Create new window, border style will be applied at initialization
+                wnd             = new X11Window(this, screen, 0, NULL, false);
+                if (wnd != NULL)
+                    wnd->enBorderStyle  = style;
+
+                return wnd;
+            }
+
             IWindow *X11Display::wrap_window(void *handle)
             {
                 return new X11Window(this, DefaultScreen(pDisplay), Window(uintptr_t(handle)), NULL, true);
@@ -295,7 +342,12 @@ namespace lsp
 
             ISurface *X11Display::create_surface(size_t width, size_t height)
             {
-                return new X11CairoSurface(this, width, height);
+                return new X11CairoSurface(this, width, height, SFMT_ARGB32);
+            }
+
+            ISurface *X11Display::create_surface(size_t width, size_t height, surface_format_t format)
+            {
+                return new X11CairoSurface(this, width, height, format);
             }
 
             void X11Display::do_destroy()
@@ -322,6 +374,16 @@ namespace lsp
                     }
                 }
 
+                // Destroy pooled windows
+                nPoolSize       = 0;
+                trim_window_pool();
+
+            #ifdef USE_LIBCAIRO
+                // Destroy pooled surfaces and cached gradients
+                sSurfacePool.clear();
+                sGradientCache.clear();
+            #endif /* USE_LIBCAIRO */
+
                 // Perform resource release
                 for (size_t i=0; i< vWindows.size(); )
                 {
@@ -342,6 +404,13 @@ namespace lsp
                 }
 
                 vWindows.flush();
+                vDestroyed.flush();
+
+                // Icon sets may outlive the display
+                for (size_t i=0, n=vIconSets.size(); i<n; ++i)
+                    vIconSets.uget(i)->detach();
+                vIconSets.flush();
+
                 sPending.flush();
                 for (size_t i=0; i<__GRAB_TOTAL; ++i)
                     vGrab[i].clear();
@@ -610,6 +679,10 @@ namespace lsp
                     handle_event(&event);
                 }
 
+                // All events generated before the last processed request have been received
+                if ((vDestroyed.size() > 0) && (::XEventsQueued(pDisplay, QueuedAlready) <= 0))
+                    drop_destroyed(LastKnownRequestProcessed(pDisplay));
+
                 // Generate list of tasks for processing
                 sPending.clear();
 
@@ -652,6 +725,9 @@ namespace lsp
                     }
                 }
 
+                // Pre-create windows for the window pool
+                fill_window_pool();
+
                 // Flush & sync display
                 ::XFlush(pDisplay);
 //                XSync(pDisplay, False);
@@ -719,6 +795,425 @@ namespace lsp
                 return NULL;
             }
 
+            bool X11Display::is_pooled_style(border_style_t style)
+            {
+                return (style == BS_POPUP) || (style == BS_DROPDOWN);
+            }
+
+            size_t X11Display::pooled_windows(size_t screen, border_style_t style)
+            {
+                size_t count = 0;
+                for (size_t i=0, n=vWndPool.size(); i<n; ++i)
+                {
+                    X11Window *wnd = vWndPool.uget(i);
+                    if ((wnd->nScreen == screen) && (wnd->enBorderStyle == style))
+                        ++count;
+                }
+                return count;
+            }
+
+            X11Window *X11Display::take_pooled_window(size_t screen, border_style_t style)
+            {
+                for (size_t i=0, n=vWndPool.size(); i<n; ++i)
+                {
+                    X11Window *wnd = vWndPool.uget(i);
+                    if ((wnd->nScreen == screen) && (wnd->enBorderStyle == style))
+                    {
+                        vWndPool.remove(i);
+                        return wnd;
+                    }
+                }
+                return NULL;
+            }
+
+            bool X11Display::reclaim_window(X11Window *wnd)
+            {
+                if ((wnd->hParent != None) || (wnd->hWindow == None) || (!is_pooled_style(wnd->enBorderStyle)))
+                    return false;
+                if (pooled_windows(wnd->nScreen, wnd->enBorderStyle) >= nPoolSize)
+                    return false;
+
+                X11Window *pw   = new X11Window(this, wnd->nScreen, 0, NULL, false);
+                if (pw == NULL)
+                    return false;
+                if (!vWndPool.add(pw))
+                {
+                    delete pw;
+                    return false;
+                }
+
+                // The window may be still not mapped at the moment of hide() call
+                ::XUnmapWindow(pDisplay, wnd->hWindow);
+
+                // Drop properties set by the previous owner, the next owner does not set them up
+                const Atom props[] =
+                {
+                    sAtoms.X11_XA_WM_NAME,
+                    sAtoms.X11__NET_WM_NAME,
+                    sAtoms.X11__NET_WM_ICON_NAME,
+                    sAtoms.X11_XA_WM_CLASS,
+                    sAtoms.X11_WM_WINDOW_ROLE,
+                    sAtoms.X11__NET_WM_ICON,
+                    XA_WM_TRANSIENT_FOR,
+                    XA_WM_NORMAL_HINTS
+                };
+                for (size_t i=0; i<sizeof(props)/sizeof(Atom); ++i)
+                    ::XDeleteProperty(pDisplay, wnd->hWindow, props[i]);
+
+                remove_window(wnd);
+                wnd->hand_over(pw);
+                invalidate_pointer();
+
+                return true;
+            }
+
+        #ifdef USE_LIBXEXT
+            bool X11Display::shm_attach(XShmSegmentInfo *info)
+            {
+                if (!bShm)
+                    return false;
+
+                // Override error handler, errors are reported asynchronously
+                ::XSync(pDisplay, False);
+                XErrorHandler old = ::XSetErrorHandler(x11_error_handler);
+                bShmError       = false;
+
+                // Wait for the server response and reset to previous handler
+                ::XShmAttach(pDisplay, info);
+                ::XSync(pDisplay, False);
+                ::XSetErrorHandler(old);
+
+                // The server can not access the segment (remote connection), don't try again
+                if (bShmError)
+                {
+                    lsp_warn("Failed to attach shared memory segment, MIT-SHM is disabled");
+                    bShm            = false;
+                    return false;
+                }
+
+                return true;
+            }
+        #endif /* USE_LIBXEXT */
+
+            IIconSet *X11Display::create_icon_set()
+            {
+                X11IconSet *icon = new X11IconSet(this);
+                if (icon == NULL)
+                    return NULL;
+                if (!vIconSets.add(icon))
+                {
+                    icon->detach();
+                    delete icon;
+                    return NULL;
+                }
+                return icon;
+            }
+
+            void X11Display::remove_icon_set(X11IconSet *icon)
+            {
+                vIconSets.premove(icon);
+            }
+
+            bool X11Display::owns_icon_set(const IIconSet *icon) const
+            {
+                for (size_t i=0, n=vIconSets.size(); i<n; ++i)
+                {
+                    if (vIconSets.uget(i) == icon)
+                        return true;
+                }
+                return false;
+            }
+
+            void X11Display::destroy_window(Window wnd, bool request)
+            {
+                // Remember the serial of the request to filter out events which are still in the queue
+                x11_destroyed_t *d  = vDestroyed.add();
+                if (d != NULL)
+                {
+                    d->hWindow          = wnd;
+                    d->nSerial          = NextRequest(pDisplay);
+                }
+
+                if (request)
+                    ::XDestroyWindow(pDisplay, wnd);
+
+                // The pointer may be located over the destroyed window
+                invalidate_pointer();
+            }
+
+            bool X11Display::has_ancestor(X11Window *wnd, const Window *list, size_t count)
+            {
+                // Walk up the hierarchy of known windows, limit the depth to prevent loops
+                Window parent   = wnd->hParent;
+                for (size_t depth=vWindows.size() + 1; (parent != None) && (depth > 0); --depth)
+                {
+                    for (size_t i=0; i<count; ++i)
+                        if (list[i] == parent)
+                            return true;
+
+                    X11Window *pwnd = find_window(parent);
+                    parent          = (pwnd != NULL) ? pwnd->hParent : None;
+                }
+
+                return false;
+            }
+
+            void X11Display::destroy_windows(IWindow * const *list, size_t count)
+            {
+                lltl::darray<Window> handles;
+                lltl::darray<bool> nested, requests;
+                Window *vh      = handles.append_n(count);
+                bool *vn        = nested.append_n(count);
+                bool *vr        = requests.append_n(count);
+                if ((vh == NULL) || (vn == NULL) || (vr == NULL))
+                {
+                    IDisplay::destroy_windows(list, count);
+                    return;
+                }
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    X11Window *wnd  = static_cast<X11Window *>(list[i]);
+                    vn[i]           = (wnd != NULL) && (wnd->hParent != None);
+                }
+
+                // Top-level windows have no ancestors, destroy them or return them to the pool
+                // first. Collect only handles of windows which are destroyed on the server
+                size_t nh       = 0;
+                for (size_t i=0; i<count; ++i)
+                {
+                    X11Window *wnd  = static_cast<X11Window *>(list[i]);
+                    if ((wnd == NULL) || (vn[i]))
+                        continue;
+
+                    Window h        = wnd->hWindow;
+                    if ((wnd->do_destroy(true)) && (h != None))
+                        vh[nh++]        = h;
+                }
+
+                // Nested windows are never pooled, all of them except wrappers get destroyed
+                for (size_t i=0; i<count; ++i)
+                {
+                    X11Window *wnd  = static_cast<X11Window *>(list[i]);
+                    if ((vn[i]) && (!wnd->bWrapper) && (wnd->hWindow != None))
+                        vh[nh++]        = wnd->hWindow;
+                }
+
+                // Child window is destroyed by the server together with any of its ancestors,
+                // decide it before the registry of windows gets modified
+                for (size_t i=0; i<count; ++i)
+                {
+                    X11Window *wnd  = static_cast<X11Window *>(list[i]);
+                    vr[i]           = (vn[i]) && (!has_ancestor(wnd, vh, nh));
+                }
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    X11Window *wnd  = static_cast<X11Window *>(list[i]);
+                    if (vn[i])
+                        wnd->do_destroy(vr[i]);
+                }
+
+                ::XFlush(pDisplay);
+            }
+
+            bool X11Display::is_destroyed(XEvent *ev)
+            {
+                if (vDestroyed.size() <= 0)
+                    return false;
+
+                // Events with serial above the XDestroyWindow request can not refer the destroyed window
+                drop_destroyed(ev->xany.serial);
+
+                for (size_t i=0, n=vDestroyed.size(); i<n; ++i)
+                {
+                    x11_destroyed_t *d  = vDestroyed.uget(i);
+                    if (d->hWindow == ev->xany.window)
+                        return true;
+                }
+
+                return false;
+            }
+
+            void X11Display::drop_destroyed(unsigned long serial)
+            {
+                for (size_t i=0; i<vDestroyed.size(); )
+                {
+                    x11_destroyed_t *d  = vDestroyed.uget(i);
+                    if (d->nSerial < serial)
+                        vDestroyed.remove(i);
+                    else
+                        ++i;
+                }
+            }
+
+            void X11Display::fill_window_pool()
+            {
+                // Do not create windows if there is no any window shown by the application
+                if (vWindows.size() <= 0)
+                    return;
+
+                // Create at most one window per iteration to not to stall the main loop
+                static const border_style_t styles[] = { BS_POPUP, BS_DROPDOWN };
+                size_t screen   = DefaultScreen(pDisplay);
+
+                for (size_t i=0; i<sizeof(styles)/sizeof(border_style_t); ++i)
+                {
+                    if (pooled_windows(screen, styles[i]) >= nPoolSize)
+                        continue;
+
+                    X11Window *wnd      = new X11Window(this, screen, 0, NULL, false);
+                    if (wnd == NULL)
+                        return;
+                    wnd->enBorderStyle  = styles[i];
+
+                    status_t res        = wnd->init();
+                    // The window should not be registered until it has been taken from the pool
+                    vWindows.premove(wnd);
+
+                    if ((res != STATUS_OK) || (!vWndPool.add(wnd)))
+                    {
+                        nPoolSize           = 0;
+                        wnd->destroy();
+                        delete wnd;
+                        return;
+                    }
+
+                    wnd->mark_pooled();
+                    return;
+                }
+            }
+
+            void X11Display::trim_window_pool()
+            {
+                for (size_t i=0; i<vWndPool.size(); )
+                {
+                    X11Window *wnd = vWndPool.uget(i);
+                    if (pooled_windows(wnd->nScreen, wnd->enBorderStyle) <= nPoolSize)
+                    {
+                        ++i;
+                        continue;
+                    }
+
+                    vWndPool.remove(i);
+                    wnd->destroy();
+                    delete wnd;
+                }
+            }
+
+            status_t X11Display::set_window_pool_size(size_t count)
+            {
+                nPoolSize       = count;
+                trim_window_pool();
+                return STATUS_OK;
+            }
+
+            size_t X11Display::window_pool_size()
+            {
+                return nPoolSize;
+            }
+
+            status_t X11Display::set_surface_pool_limit(size_t bytes)
+            {
+            #ifdef USE_LIBCAIRO
+                sSurfacePool.set_limit(bytes);
+                return STATUS_OK;
+            #else
+                return STATUS_NOT_IMPLEMENTED;
+            #endif /* USE_LIBCAIRO */
+            }
+
+            size_t X11Display::surface_pool_limit()
+            {
+            #ifdef USE_LIBCAIRO
+                return sSurfacePool.limit();
+            #else
+                return 0;
+            #endif /* USE_LIBCAIRO */
+            }
+
+            status_t X11Display::get_surface_pool_stats(surface_pool_stats_t *stats)
+            {
+                if (stats == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+            #ifdef USE_LIBCAIRO
+                sSurfacePool.get_stats(stats);
+                return STATUS_OK;
+            #else
+                return STATUS_NOT_IMPLEMENTED;
+            #endif /* USE_LIBCAIRO */
+            }
+
+            void X11Display::watch_ancestors(X11Window *wnd)
+            {
+                Window root, parent, *children;
+                unsigned int nchildren;
+                XWindowAttributes xwa;
+
+                wnd->vAncestors.clear();
+                Window w        = wnd->hWindow;
+                if (w == None)
+                    return;
+
+                // Ancestors may be foreign windows destroyed at any moment, override error handler
+                ::XSync(pDisplay, False);
+                XErrorHandler old = ::XSetErrorHandler(x11_error_handler);
+
+                // Moving of any ancestor changes the absolute position of the window,
+                // so we need to receive structure events for the whole chain up to the root window
+                while (true)
+                {
+                    children        = NULL;
+                    if (!::XQueryTree(pDisplay, w, &root, &parent, &children, &nchildren))
+                        break;
+                    if (children != NULL)
+                        ::XFree(children);
+                    if ((parent == None) || (parent == root))
+                        break;
+                    if (!wnd->vAncestors.add(&parent))
+                        break;
+
+                    if ((find_window(parent) == NULL) && (::XGetWindowAttributes(pDisplay, parent, &xwa)))
+                    {
+                        if (!(xwa.your_event_mask & StructureNotifyMask))
+                            ::XSelectInput(pDisplay, parent, xwa.your_event_mask | StructureNotifyMask);
+                    }
+
+                    w               = parent;
+                }
+
+                // Reset to previous handler
+                ::XSync(pDisplay, False);
+                ::XSetErrorHandler(old);
+            }
+
+            void X11Display::invalidate_origins(Window wnd)
+            {
+                // Only windows placed inside of the moved one change their absolute position
+                for (size_t i=0, n=vWindows.size(); i<n; ++i)
+                {
+                    X11Window *w = vWindows.uget(i);
+                    if ((w != NULL) && (w->origin_depends(wnd)))
+                        w->bAbsValid    = false;
+                }
+            }
+
+            bool X11Display::is_autorepeat_release(XKeyEvent *ev)
+            {
+                // Plain X auto-repeat emits KeyRelease immediately followed by KeyPress
+                // with the same key code and timestamp
+                if (::XEventsQueued(pDisplay, QueuedAfterReading) <= 0)
+                    return false;
+
+                XEvent next;
+                ::XPeekEvent(pDisplay, &next);
+
+                return (next.type == KeyPress) &&
+                        (next.xkey.window == ev->window) &&
+                        (next.xkey.keycode == ev->keycode) &&
+                        (next.xkey.time == ev->time);
+            }
+
             status_t X11Display::bufid_to_atom(size_t bufid, Atom *atom)
             {
                 switch (bufid)
@@ -1643,6 +2138,15 @@ namespace lsp
                 if (ev->type > LASTEvent)
                     return;
 
+                // Skip events for windows that have been destroyed asynchronously,
+                // the pointer leaving such window is not tracked any more
+                if (is_destroyed(ev))
+                {
+                    if (ev->type == LeaveNotify)
+                        invalidate_pointer();
+                    return;
+                }
+
                 #if 0
                 lsp_trace("Received event: %d (%s), serial = %ld, window = %x",
                     int(ev->type), event_name(ev->type), long(ev->xany.serial), int(ev->xany.window));
@@ -1698,6 +2202,48 @@ namespace lsp
 //                    }
                 }
 
+                // The pointer may leave the window which has been reclaimed by the window pool
+                if ((target == NULL) && (ev->type == LeaveNotify))
+                    invalidate_pointer();
+
+                // Keep the cached absolute origins of windows up to date
+                switch (ev->type)
+                {
+                    case ConfigureNotify:
+                        // Skip the copy of event sent to the parent window
+                        if (ev->xconfigure.event != ev->xconfigure.window)
+                            break;
+
+                        // The window manager sends synthetic events with root coordinates
+                        // of the window including the frame offset (ICCCM 4.1.5)
+                        invalidate_origins(ev->xconfigure.window);
+                        if ((ev->xconfigure.send_event) && (target != NULL))
+                        {
+                            target->nAbsLeft    = ev->xconfigure.x + ev->xconfigure.border_width;
+                            target->nAbsTop     = ev->xconfigure.y + ev->xconfigure.border_width;
+                            target->bAbsValid   = true;
+                        }
+                        break;
+
+                    case ReparentNotify:
+                        if (ev->xreparent.event != ev->xreparent.window)
+                            break;
+
+                        // The chain of ancestors has changed, watch for the new ones
+                        for (size_t i=0, n=vWindows.size(); i<n; ++i)
+                        {
+                            X11Window *wnd = vWindows.uget(i);
+                            if ((wnd == NULL) || (!wnd->origin_depends(ev->xreparent.window)))
+                                continue;
+                            wnd->bAbsValid  = false;
+                            watch_ancestors(wnd);
+                        }
+                        break;
+
+                    default:
+                        break;
+                }
+
                 event_t ue;
                 init_event(&ue);
 
@@ -1711,10 +2257,30 @@ namespace lsp
                         KeySym ksym;
                         XComposeStatus status;
 
+                        // Track the key state to detect auto-repeat
+                        size_t kcode    = ev->xkey.keycode & 0xff;
+                        uint8_t kmask   = 1 << (kcode & 0x07);
+                        bool repeat     = false;
+
+                        if (ev->type == KeyPress)
+                        {
+                            repeat                  = vKeyState[kcode >> 3] & kmask;
+                            vKeyState[kcode >> 3]  |= kmask;
+                        }
+                        else
+                        {
+                            // Drop fake KeyRelease events if detectable auto-repeat is not supported
+                            if ((!bXkbRepeat) && (is_autorepeat_release(&ev->xkey)))
+                                return;
+                            vKeyState[kcode >> 3]  &= ~kmask;
+                        }
+
                         XLookupString(&ev->xkey, ret, sizeof(ret), &ksym, &status);
                         code_t key   = decode_keycode(ksym);
 
-                        lsp_trace("%s: code=0x%lx, raw=0x%lx", (ev->type == KeyPress) ? "key_press" : "key_release", long(key), long(ksym));
+                        lsp_trace("%s: code=0x%lx, raw=0x%lx, repeat=%s",
+                                (ev->type == KeyPress) ? "key_press" : "key_release",
+                                long(key), long(ksym), (repeat) ? "true" : "false");
 
                         if (key != WSK_UNKNOWN)
                         {
@@ -1724,6 +2290,8 @@ namespace lsp
                             ue.nCode        = key;
                             ue.nRawCode     = ksym;
                             ue.nState       = decode_state(ev->xkey.state);
+                            if (repeat)
+                                ue.nState      |= MCF_REPEAT;
                             ue.nTime        = ev->xkey.time;
                         }
                         break;
@@ -1731,6 +2299,8 @@ namespace lsp
 
                     case ButtonPress:
                     case ButtonRelease:
+                        track_pointer(ev->xbutton.root, ev->xbutton.x_root, ev->xbutton.y_root, ev->xbutton.same_screen);
+
 //                        lsp_trace("button time = %ld, x=%d, y=%d up=%s", long(ev->xbutton.time),
 //                            int(ev->xbutton.x), int(ev->xbutton.y),
 //                            (ev->type == ButtonRelease) ? "true" : "false");
@@ -1767,6 +2337,7 @@ namespace lsp
                         break;
 
                     case MotionNotify:
+                        track_pointer(ev->xmotion.root, ev->xmotion.x_root, ev->xmotion.y_root, ev->xmotion.same_screen);
                         ue.nType        = UIE_MOUSE_MOVE;
                         ue.nLeft        = ev->xmotion.x;
                         ue.nTop         = ev->xmotion.y;
@@ -1805,6 +2376,12 @@ namespace lsp
 
                     case EnterNotify:
                     case LeaveNotify:
+                        // The pointer may be no more tracked after it leaves the window
+                        if (ev->type == EnterNotify)
+                            track_pointer(ev->xcrossing.root, ev->xcrossing.x_root, ev->xcrossing.y_root, ev->xcrossing.same_screen);
+                        else
+                            invalidate_pointer();
+
                         ue.nType        = (ev->type == EnterNotify) ? UIE_MOUSE_IN : UIE_MOUSE_OUT;
                         ue.nLeft        = ev->xcrossing.x;
                         ue.nTop         = ev->xcrossing.y;
@@ -1813,6 +2390,8 @@ namespace lsp
                     case FocusIn:
                     case FocusOut:
                         ue.nType        = (ev->type == FocusIn) ? UIE_FOCUS_IN : UIE_FOCUS_OUT;
+                        // Key releases may be lost while the focus is not owned by our windows
+                        bzero(vKeyState, sizeof(vKeyState));
                         // TODO: maybe useful could be decoding of mode and detail
                         break;
 
@@ -3493,6 +4072,13 @@ namespace lsp
                         this, int(ev->error_code), error, ev->serial, int(ev->request_code), int(ev->minor_code)
                 );
                 #endif
+                // Failed MIT-SHM request, the shared memory is not accessible by the server
+                if ((nShmOpcode != 0) && (ev->request_code == nShmOpcode))
+                {
+                    bShmError       = true;
+                    return;
+                }
+
                 if (ev->error_code == BadWindow)
                 {
                     for (size_t i=0, n=sAsync.size(); i<n; ++i)
@@ -3730,6 +4316,21 @@ namespace lsp
                 return STATUS_OK;
             }
 
+            void X11Display::track_pointer(Window root, int x, int y, Bool same_screen)
+            {
+                // Coordinates are not relative to the event root when the pointer is located on another screen
+                if (!same_screen)
+                {
+                    sPointer.bValid     = false;
+                    return;
+                }
+
+                sPointer.bValid     = true;
+                sPointer.nScreen    = get_screen(root);
+                sPointer.nLeft      = x;
+                sPointer.nTop       = y;
+            }
+
             status_t X11Display::get_pointer_location(size_t *screen, ssize_t *left, ssize_t *top)
             {
                 Window r, root, child;
@@ -3739,6 +4340,21 @@ namespace lsp
                 if (pDisplay == NULL)
                     return STATUS_BAD_STATE;
 
+                // Answer from the pointer state tracked by incoming events if possible
+                if (sPointer.bValid)
+                {
+                    if (screen != NULL)
+                        *screen = sPointer.nScreen;
+                    if (left != NULL)
+                        *left   = sPointer.nLeft;
+                    if (top != NULL)
+                        *top    = sPointer.nTop;
+
+                    return STATUS_OK;
+                }
+
+                // The pointer is outside of our windows, query the server
+
                 for (size_t i=0, n=vScreens.size(); i<n; ++i)
                 {
                     r = RootWindow(pDisplay, i);
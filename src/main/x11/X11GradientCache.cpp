@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+
+#include <private/x11/X11GradientCache.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GRADIENT_CACHE_SIZE         256     /* Maximum number of cached patterns */
+#define GRADIENT_RAMP_MAX           1024    /* Maximum length of the ramp image */
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            X11GradientCache::X11GradientCache()
+            {
+                hLock           = 0;
+                nStamp          = 0;
+            }
+
+            X11GradientCache::~X11GradientCache()
+            {
+                clear();
+            }
+
+            size_t X11GradientCache::hash(gradient_type_t type, const float *params, const gradient_stop_t *stops, size_t n)
+            {
+                // FNV-1a hash over the binary representation of the key
+                uint32_t h          = 2166136261U;
+                h                   = (h ^ uint32_t(type)) * 16777619U;
+
+                const uint8_t *p    = reinterpret_cast<const uint8_t *>(params);
+                for (size_t i=0; i<sizeof(float)*6; ++i)
+                    h                   = (h ^ p[i]) * 16777619U;
+
+                p                   = reinterpret_cast<const uint8_t *>(stops);
+                for (size_t i=0, k=n*sizeof(gradient_stop_t); i<k; ++i)
+                    h                   = (h ^ p[i]) * 16777619U;
+
+                return h;
+            }
+
+            void X11GradientCache::destroy_entry(entry_t *e)
+            {
+                if (e->pPattern != NULL)
+                {
+                    ::cairo_pattern_destroy(e->pPattern);
+                    e->pPattern     = NULL;
+                }
+                if (e->vStops != NULL)
+                {
+                    ::free(e->vStops);
+                    e->vStops       = NULL;
+                }
+            }
+
+            static inline uint32_t ramp_pixel(const gradient_stop_t *stops, size_t n, float t)
+            {
+                float r, g, b, a;
+
+                if (t <= stops[0].offset)
+                {
+                    r = stops[0].r; g = stops[0].g; b = stops[0].b; a = stops[0].a;
+                }
+                else if (t >= stops[n-1].offset)
+                {
+                    r = stops[n-1].r; g = stops[n-1].g; b = stops[n-1].b; a = stops[n-1].a;
+                }
+                else
+                {
+                    // Lookup for the last stop not greater than t, this handles sharp transitions
+                    size_t k = 0;
+                    while ((k + 2 < n) && (stops[k+1].offset <= t))
+                        ++k;
+
+                    const gradient_stop_t *s0 = &stops[k];
+                    const gradient_stop_t *s1 = &stops[k+1];
+                    float d     = s1->offset - s0->offset;
+                    float k1    = (d > 0.0f) ? (t - s0->offset) / d : 1.0f;
+                    float k0    = 1.0f - k1;
+
+                    r           = s0->r * k0 + s1->r * k1;
+                    g           = s0->g * k0 + s1->g * k1;
+                    b           = s0->b * k0 + s1->b * k1;
+                    a           = s0->a * k0 + s1->a * k1;
+                }
+
+                // Pack the premultiplied color
+                a               = lsp_limit(a, 0.0f, 1.0f);
+                uint32_t ia     = uint32_t(a * 255.0f + 0.5f);
+                uint32_t ir     = uint32_t(lsp_limit(r, 0.0f, 1.0f) * a * 255.0f + 0.5f);
+                uint32_t ig     = uint32_t(lsp_limit(g, 0.0f, 1.0f) * a * 255.0f + 0.5f);
+                uint32_t ib     = uint32_t(lsp_limit(b, 0.0f, 1.0f) * a * 255.0f + 0.5f);
+
+                return (ia << 24) | (ir << 16) | (ig << 8) | ib;
+            }
+
+            cairo_pattern_t *X11GradientCache::create_ramp(const float *params, const gradient_stop_t *stops, size_t n)
+            {
+                float dx        = params[2] - params[0];
+                float dy        = params[3] - params[1];
+                float l2        = dx*dx + dy*dy;
+                if ((n <= 0) || (l2 < 1e-6f))
+                    return NULL;
+
+                // One texel per pixel of the gradient length
+                size_t len      = lsp_limit(size_t(ceilf(sqrtf(l2))), size_t(2), size_t(GRADIENT_RAMP_MAX));
+                cairo_surface_t *s  = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, len, 1);
+                if (::cairo_surface_status(s) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_surface_destroy(s);
+                    return NULL;
+                }
+
+                ::cairo_surface_flush(s);
+                uint32_t *dst   = reinterpret_cast<uint32_t *>(::cairo_image_surface_get_data(s));
+                float kt        = 1.0f / len;
+                for (size_t i=0; i<len; ++i)
+                    dst[i]          = ramp_pixel(stops, n, (i + 0.5f) * kt);
+                ::cairo_surface_mark_dirty(s);
+
+                cairo_pattern_t *cp = ::cairo_pattern_create_for_surface(s);
+                ::cairo_surface_destroy(s);
+                if (::cairo_pattern_status(cp) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_pattern_destroy(cp);
+                    return NULL;
+                }
+
+                // Map the gradient axis onto the ramp, the perpendicular axis is
+                // mapped onto the vertical coordinate which is padded to the single row
+                float ku        = len / l2;
+                float kv        = 1.0f / l2;
+                cairo_matrix_t m;
+                ::cairo_matrix_init(&m,
+                        dx * ku, -dy * kv,
+                        dy * ku, dx * kv,
+                        -(params[0]*dx + params[1]*dy) * ku,
+                        (params[0]*dy - params[1]*dx) * kv);
+
+                ::cairo_pattern_set_matrix(cp, &m);
+                ::cairo_pattern_set_extend(cp, CAIRO_EXTEND_PAD);
+                ::cairo_pattern_set_filter(cp, CAIRO_FILTER_BILINEAR);
+
+                return cp;
+            }
+
+            cairo_pattern_t *X11GradientCache::create_pattern(gradient_type_t type, const float *params, const gradient_stop_t *stops, size_t n)
+            {
+                cairo_pattern_t *cp = NULL;
+
+                if (type == GRADIENT_LINEAR)
+                {
+                    if ((cp = create_ramp(params, stops, n)) != NULL)
+                        return cp;
+                    cp      = ::cairo_pattern_create_linear(params[0], params[1], params[2], params[3]);
+                }
+                else
+                    cp      = ::cairo_pattern_create_radial(params[0], params[1], params[2], params[3], params[4], params[5]);
+
+                // Degenerate gradients are drawn by cairo
+                for (size_t i=0; i<n; ++i)
+                {
+                    const gradient_stop_t *s = &stops[i];
+                    ::cairo_pattern_add_color_stop_rgba(cp, s->offset, s->r, s->g, s->b, s->a);
+                }
+
+                return cp;
+            }
+
+            cairo_pattern_t *X11GradientCache::acquire(gradient_type_t type, const float *params, const gradient_stop_t *stops, size_t n)
+            {
+                size_t h            = hash(type, params, stops, n);
+                cairo_pattern_t *cp = NULL;
+
+                // Lookup for the cached pattern
+                lock();
+                {
+                    for (size_t i=0, k=vEntries.size(); i<k; ++i)
+                    {
+                        entry_t *e          = vEntries.uget(i);
+                        if ((e->nHash != h) || (e->enType != type) || (e->nStops != n))
+                            continue;
+                        if (::memcmp(e->vParams, params, sizeof(e->vParams)) != 0)
+                            continue;
+                        if (::memcmp(e->vStops, stops, n * sizeof(gradient_stop_t)) != 0)
+                            continue;
+
+                        e->nStamp           = ++nStamp;
+                        cp                  = ::cairo_pattern_reference(e->pPattern);
+                        break;
+                    }
+                }
+                unlock();
+
+                if (cp != NULL)
+                    return cp;
+
+                // Create new pattern outside of the lock
+                if ((cp = create_pattern(type, params, stops, n)) == NULL)
+                    return NULL;
+
+                entry_t e;
+                e.nHash             = h;
+                e.enType            = type;
+                e.nStops            = n;
+                e.pPattern          = cp;
+                e.vStops            = static_cast<gradient_stop_t *>(::malloc(lsp_max(n, size_t(1)) * sizeof(gradient_stop_t)));
+                if (e.vStops == NULL)
+                    return cp;
+                ::memcpy(e.vParams, params, sizeof(e.vParams));
+                ::memcpy(e.vStops, stops, n * sizeof(gradient_stop_t));
+
+                lock();
+                {
+                    e.nStamp            = ++nStamp;
+                    if (vEntries.add(&e) != NULL)
+                    {
+                        ::cairo_pattern_reference(cp);
+                        e.vStops            = NULL;
+                        trim(GRADIENT_CACHE_SIZE);
+                    }
+                }
+                unlock();
+
+                if (e.vStops != NULL)
+                    ::free(e.vStops);
+
+                return cp;
+            }
+
+            void X11GradientCache::trim(size_t limit)
+            {
+                // Destroy least recently used patterns
+                while (vEntries.size() > limit)
+                {
+                    size_t index    = 0;
+                    for (size_t i=1, n=vEntries.size(); i<n; ++i)
+                    {
+                        if (vEntries.uget(i)->nStamp < vEntries.uget(index)->nStamp)
+                            index       = i;
+                    }
+
+                    destroy_entry(vEntries.uget(index));
+                    vEntries.qremove(index);
+                }
+            }
+
+            void X11GradientCache::clear()
+            {
+                lock();
+                {
+                    for (size_t i=0, n=vEntries.size(); i<n; ++i)
+                        destroy_entry(vEntries.uget(i));
+                    vEntries.flush();
+                }
+                unlock();
+            }
+        }
+    }
+}
+
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
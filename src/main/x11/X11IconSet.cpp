@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+
+#ifdef USE_LIBX11
+
+#include <lsp-plug.in/common/endian.h>
+#include <lsp-plug.in/ws/pixels.h>
+#include <private/x11/X11Display.h>
+#include <private/x11/X11IconSet.h>
+
+#include <stdlib.h>
+
+#define ICONSET_GROW        0x400
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            X11IconSet::X11IconSet(X11Display *dpy)
+            {
+                pDisplay    = dpy;
+                vData       = NULL;
+                nSize       = 0;
+                nCapacity   = 0;
+                nIcons      = 0;
+            }
+
+            X11IconSet::~X11IconSet()
+            {
+                clear();
+                if (pDisplay != NULL)
+                {
+                    pDisplay->remove_icon_set(this);
+                    pDisplay    = NULL;
+                }
+            }
+
+            status_t X11IconSet::add(const void *bgra, size_t width, size_t height)
+            {
+                if ((bgra == NULL) || (width <= 0) || (height <= 0))
+                    return STATUS_BAD_ARGUMENTS;
+
+                // Ensure that there is enough space in the buffer
+                size_t n        = width * height;
+                size_t size     = nSize + n + 2;
+                if (size > nCapacity)
+                {
+                    size_t cap      = (size + ICONSET_GROW - 1) & ~size_t(ICONSET_GROW - 1);
+                    unsigned long *ptr = static_cast<unsigned long *>(::realloc(vData, cap * sizeof(unsigned long)));
+                    if (ptr == NULL)
+                        return STATUS_NO_MEM;
+
+                    vData           = ptr;
+                    nCapacity       = cap;
+                }
+
+                // Append the image
+                unsigned long *dst  = &vData[nSize];
+                dst[0]          = width;
+                dst[1]          = height;
+                pixels::widen(&dst[2], width * sizeof(unsigned long), bgra, width * sizeof(uint32_t), width, height);
+            #ifdef ARCH_BE
+                // Packed BGRA components are read as little-endian pixels
+                for (size_t i=0; i<n; ++i)
+                    dst[i+2]        = LE_TO_CPU(uint32_t(dst[i+2]));
+            #endif /* ARCH_BE */
+
+                nSize           = size;
+                ++nIcons;
+
+                return STATUS_OK;
+            }
+
+            size_t X11IconSet::size() const
+            {
+                return nIcons;
+            }
+
+            void X11IconSet::clear()
+            {
+                if (vData != NULL)
+                {
+                    ::free(vData);
+                    vData       = NULL;
+                }
+                nSize       = 0;
+                nCapacity   = 0;
+                nIcons      = 0;
+            }
+        }
+    }
+}
+
+#endif /* USE_LIBX11 */
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+
+#include <private/x11/X11SurfacePool.h>
+
+#include <string.h>
+
+#define SURFPOOL_DEFAULT_LIMIT      0x1000000   /* 16 MiB */
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            cairo_user_data_key_t X11SurfacePool::sBackingKey;
+
+            X11SurfacePool::X11SurfacePool()
+            {
+                hLock               = 0;
+                nStamp              = 0;
+
+                sStats.nHits        = 0;
+                sStats.nMisses      = 0;
+                sStats.nEvictions   = 0;
+                sStats.nSurfaces    = 0;
+                sStats.nBytes       = 0;
+                sStats.nLimit       = SURFPOOL_DEFAULT_LIMIT;
+            }
+
+            X11SurfacePool::~X11SurfacePool()
+            {
+                clear();
+            }
+
+            static inline size_t ceil_log2(size_t n)
+            {
+                size_t bits = 0;
+                if (n > 0)
+                {
+                    for (--n; n > 0; n >>= 1)
+                        ++bits;
+                }
+                return bits;
+            }
+
+            size_t X11SurfacePool::bucket(size_t width, size_t height)
+            {
+                return (ceil_log2(width) << 8) | ceil_log2(height);
+            }
+
+            void X11SurfacePool::release_backing(void *ptr)
+            {
+                ::cairo_surface_destroy(static_cast<cairo_surface_t *>(ptr));
+            }
+
+            void X11SurfacePool::clear_surface(cairo_surface_t *s)
+            {
+                ::cairo_surface_flush(s);
+                uint8_t *data   = ::cairo_image_surface_get_data(s);
+                if (data != NULL)
+                {
+                    size_t bytes    = ::cairo_image_surface_get_stride(s) * ::cairo_image_surface_get_height(s);
+                    ::memset(data, 0, bytes);
+                }
+                ::cairo_surface_mark_dirty(s);
+            }
+
+            cairo_surface_t *X11SurfacePool::acquire(cairo_format_t format, size_t width, size_t height, bool clear)
+            {
+                if ((width == 0) || (height == 0))
+                    return ::cairo_image_surface_create(format, width, height);
+
+                // Lookup for the matching surface, prefer the surface of the same size,
+                // otherwise take the surface which uses the least amount of memory
+                size_t b        = bucket(width, height);
+                entry_t e;
+                e.pSurface      = NULL;
+
+                lock();
+                {
+                    ssize_t index   = -1;
+                    for (size_t i=0, n=vEntries.size(); i<n; ++i)
+                    {
+                        entry_t *x      = vEntries.uget(i);
+                        if ((x->enFormat != format) || (x->nBucket != b))
+                            continue;
+                        if ((x->nWidth < width) || (x->nHeight < height))
+                            continue;
+                        if ((index < 0) || (x->nBytes < vEntries.uget(index)->nBytes))
+                            index           = i;
+                        if ((x->nWidth == width) && (x->nHeight == height))
+                            break;
+                    }
+
+                    if (index >= 0)
+                    {
+                        e               = *(vEntries.uget(index));
+                        vEntries.qremove(index);
+                        sStats.nSurfaces   -= 1;
+                        sStats.nBytes      -= e.nBytes;
+                        ++sStats.nHits;
+                    }
+                    else
+                        ++sStats.nMisses;
+                }
+                unlock();
+
+                // Allocate new surface if there is no match
+                if (e.pSurface == NULL)
+                    return ::cairo_image_surface_create(format, width, height);
+
+                // Surface of the same size can be returned as is, otherwise
+                // create view which refers the pixel data and keeps the pooled surface
+                cairo_surface_t *s  = e.pSurface;
+                if ((e.nWidth != width) || (e.nHeight != height))
+                {
+                    s   = create_view(e.pSurface, width, height);
+                    if (s == NULL)
+                        return ::cairo_image_surface_create(format, width, height);
+                }
+
+                if (clear)
+                    clear_surface(s);
+
+                return s;
+            }
+
+            cairo_surface_t *X11SurfacePool::create_view(cairo_surface_t *backing, size_t width, size_t height)
+            {
+                ::cairo_surface_flush(backing);
+                cairo_surface_t *s  = ::cairo_image_surface_create_for_data(
+                        ::cairo_image_surface_get_data(backing),
+                        ::cairo_image_surface_get_format(backing),
+                        width, height,
+                        ::cairo_image_surface_get_stride(backing));
+
+                if (::cairo_surface_status(s) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_surface_destroy(s);
+                    ::cairo_surface_destroy(backing);
+                    return NULL;
+                }
+                if (::cairo_surface_set_user_data(s, &sBackingKey, backing, release_backing) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_surface_destroy(s);
+                    ::cairo_surface_destroy(backing);
+                    return NULL;
+                }
+
+                return s;
+            }
+
+            cairo_surface_t *X11SurfacePool::backing(cairo_surface_t *s)
+            {
+                cairo_surface_t *b  = static_cast<cairo_surface_t *>(::cairo_surface_get_user_data(s, &sBackingKey));
+                return (b != NULL) ? b : s;
+            }
+
+            void X11SurfacePool::release(cairo_surface_t *s)
+            {
+                if (s == NULL)
+                    return;
+
+                // Views of pooled surfaces return the original surface to the pool
+                cairo_surface_t *backing = static_cast<cairo_surface_t *>(::cairo_surface_get_user_data(s, &sBackingKey));
+                if (backing != NULL)
+                {
+                    // The view is still referenced by someone, the original surface will be destroyed with it
+                    if (::cairo_surface_get_reference_count(s) != 1)
+                    {
+                        ::cairo_surface_destroy(s);
+                        return;
+                    }
+
+                    ::cairo_surface_reference(backing);
+                    ::cairo_surface_destroy(s);
+                    s           = backing;
+                }
+
+                // Only image surfaces which are not referenced by anyone else can be reused
+                if ((::cairo_surface_get_reference_count(s) != 1) ||
+                    (::cairo_surface_status(s) != CAIRO_STATUS_SUCCESS) ||
+                    (::cairo_surface_get_type(s) != CAIRO_SURFACE_TYPE_IMAGE))
+                {
+                    ::cairo_surface_destroy(s);
+                    return;
+                }
+
+                entry_t e;
+                e.pSurface      = s;
+                e.enFormat      = ::cairo_image_surface_get_format(s);
+                e.nWidth        = ::cairo_image_surface_get_width(s);
+                e.nHeight       = ::cairo_image_surface_get_height(s);
+                e.nBucket       = bucket(e.nWidth, e.nHeight);
+                e.nBytes        = ::cairo_image_surface_get_stride(s) * e.nHeight;
+
+                lock();
+                {
+                    if ((e.nBytes > 0) && (e.nBytes <= sStats.nLimit))
+                    {
+                        e.nStamp        = ++nStamp;
+                        if (vEntries.add(&e) != NULL)
+                        {
+                            sStats.nSurfaces   += 1;
+                            sStats.nBytes      += e.nBytes;
+                            s                   = NULL;
+                            trim(sStats.nLimit);
+                        }
+                    }
+                }
+                unlock();
+
+                if (s != NULL)
+                    ::cairo_surface_destroy(s);
+            }
+
+            void X11SurfacePool::trim(size_t limit)
+            {
+                // Destroy least recently released surfaces
+                while ((sStats.nBytes > limit) && (vEntries.size() > 0))
+                {
+                    size_t index    = 0;
+                    for (size_t i=1, n=vEntries.size(); i<n; ++i)
+                    {
+                        if (vEntries.uget(i)->nStamp < vEntries.uget(index)->nStamp)
+                            index       = i;
+                    }
+
+                    entry_t *e      = vEntries.uget(index);
+                    ::cairo_surface_destroy(e->pSurface);
+                    sStats.nSurfaces   -= 1;
+                    sStats.nBytes      -= e->nBytes;
+                    ++sStats.nEvictions;
+                    vEntries.qremove(index);
+                }
+            }
+
+            void X11SurfacePool::set_limit(size_t bytes)
+            {
+                lock();
+                    sStats.nLimit   = bytes;
+                    trim(bytes);
+                unlock();
+            }
+
+            size_t X11SurfacePool::limit()
+            {
+                return sStats.nLimit;
+            }
+
+            void X11SurfacePool::get_stats(surface_pool_stats_t *stats)
+            {
+                lock();
+                    *stats          = sStats;
+                unlock();
+            }
+
+            void X11SurfacePool::clear()
+            {
+                lock();
+                {
+                    for (size_t i=0, n=vEntries.size(); i<n; ++i)
+                        ::cairo_surface_destroy(vEntries.uget(i)->pSurface);
+                    vEntries.flush();
+                    sStats.nSurfaces    = 0;
+                    sStats.nBytes       = 0;
+                }
+                unlock();
+            }
+        }
+    }
+}
+
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
@@ -32,6 +32,7 @@
 #include <private/x11/X11Window.h>
 #include <private/x11/X11Display.h>
 #include <private/x11/X11CairoSurface.h>
+#include <private/x11/X11IconSet.h>
 
 #include <limits.h>
 #include <errno.h>
@@ -51,6 +52,9 @@ namespace lsp
                 pX11Display             = core;
                 bWrapper                = wrapper;
                 bVisible                = false;
+                bAbsValid               = false;
+                nAbsLeft                = 0;
+                nAbsTop                 = 0;
                 if (wrapper)
                 {
                     hWindow                 = wnd;
@@ -68,6 +72,7 @@ namespace lsp
                 nActions                = WA_SINGLE;
                 nFlags                  = 0;
                 enPointer               = MP_DEFAULT;
+                enBuffering             = BUF_NONE;
 
                 sSize.nLeft             = 0;
                 sSize.nTop              = 0;
@@ -88,6 +93,14 @@ namespace lsp
                     vBtnEvent[i].sDown.nType    = UIE_UNKNOWN;
                     vBtnEvent[i].sUp.nType      = UIE_UNKNOWN;
                 }
+
+                sUpdate.nLock           = 0;
+                sUpdate.nDirty          = 0;
+                sUpdate.sCaption        = NULL;
+                sUpdate.sCaptionUtf8    = NULL;
+                sUpdate.sClass          = NULL;
+                sUpdate.nClassLen       = 0;
+                sUpdate.sRole           = NULL;
             }
 
             void X11Window::do_create()
@@ -96,6 +109,7 @@ namespace lsp
 
             X11Window::~X11Window()
             {
+                drop_update();
                 pX11Display       = NULL;
             }
 
@@ -104,6 +118,15 @@ namespace lsp
                 Display *dpy = pX11Display->x11display();
                 Atom dnd_version    = 5;    // Version 5 of protocol is supported
 
+                // The window has been pre-initialized by the window pool, just register it
+                if (nFlags & F_POOLED)
+                {
+                    nFlags     &= ~F_POOLED;
+                    if (!pX11Display->add_window(this))
+                        return STATUS_NO_MEM;
+                    return STATUS_OK;
+                }
+
                 if (bWrapper)
                 {
                     if (!pX11Display->add_window(this))
@@ -151,6 +174,7 @@ namespace lsp
                     ::XChangeProperty(dpy, hWindow, pX11Display->atoms().X11_XdndProxy, XA_WINDOW, 32, PropModeReplace,
                                     reinterpret_cast<unsigned char *>(&hWindow), 1);
 
+                    pX11Display->watch_ancestors(this);
                     pX11Display->flush();
                 }
                 else
@@ -270,10 +294,13 @@ namespace lsp
                     sMotif.status       = 0;
 
                     hWindow = wnd;
+                    pX11Display->watch_ancestors(this);
 
                     // Initialize window border style and actions
-                    set_border_style(BS_SIZEABLE);
+                    begin_update();
+                    set_border_style(enBorderStyle);
                     set_window_actions(WA_ALL);
+                    commit_update();
                     set_mouse_pointer(MP_DEFAULT);
                 }
 
@@ -292,31 +319,103 @@ namespace lsp
                 }
             }
 
-            void X11Window::destroy()
+            status_t X11Window::release_surface()
             {
-                // Drop surface
-                hide();
+                if (bVisible)
+                    return STATUS_BAD_STATE;
+
                 drop_surface();
+                return STATUS_OK;
+            }
 
-                if (!bWrapper)
-                {
-                    // Remove window from registry
-                    if (pX11Display != NULL)
-                        pX11Display->remove_window(this);
+            void X11Window::destroy()
+            {
+                do_destroy(true);
+            }
 
-                    // Destroy window
-                    if (hWindow > 0)
-                    {
-                        XDestroyWindow(pX11Display->x11display(), hWindow);
-                        hWindow = 0;
-                    }
-                    pX11Display->sync();
+            void X11Window::drop_state()
+            {
+                // Reset the state of the window destroyed by the server without issuing X requests
+                bVisible        = false;
+                hTransientFor   = None;
+                if (pX11Display == NULL)
+                    return;
+
+                if (pX11Display->pFocusWindow == this)
+                    pX11Display->pFocusWindow = NULL;
+                if (nFlags & F_GRABBING)
+                {
+                    pX11Display->ungrab_events(this);
+                    nFlags &= ~F_GRABBING;
                 }
+                if (nFlags & F_LOCKING)
+                {
+                    pX11Display->unlock_events(this);
+                    nFlags &= ~F_LOCKING;
+                }
+            }
+
+            bool X11Window::origin_depends(::Window wnd)
+            {
+                if (hWindow == wnd)
+                    return true;
+                for (size_t i=0, n=vAncestors.size(); i<n; ++i)
+                    if (*(vAncestors.uget(i)) == wnd)
+                        return true;
+                return false;
+            }
+
+            bool X11Window::do_destroy(bool request)
+            {
+                // Hide window and try to return it to the window pool, the window
+                // destroyed together with its parent does not exist on the server any more
+                if (request)
+                    hide();
                 else
+                    drop_state();
+                if ((!bWrapper) && (request) && (pX11Display != NULL) && (pX11Display->reclaim_window(this)))
+                    return false;
+
+                // Drop surface and staged changes
+                drop_surface();
+                drop_update();
+
+                if (bWrapper)
                 {
                     hWindow = None;
                     hParent = None;
+                    return false;
+                }
+
+                // Remove window from registry
+                if (pX11Display != NULL)
+                    pX11Display->remove_window(this);
+
+                // Destroy window, the request is sent with the next flush
+                if (hWindow > 0)
+                {
+                    pX11Display->destroy_window(hWindow, request);
+                    hWindow = 0;
                 }
+
+                return true;
+            }
+
+            void X11Window::hand_over(X11Window *dst)
+            {
+                dst->hWindow        = hWindow;
+                dst->nScreen        = nScreen;
+                dst->pSurface       = pSurface;
+                dst->enBorderStyle  = enBorderStyle;
+                dst->sMotif         = sMotif;
+                dst->nActions       = nActions;
+                dst->enPointer      = enPointer;
+                dst->enBuffering    = enBuffering;
+                dst->sSize          = sSize;
+                dst->nFlags         = F_POOLED;
+
+                hWindow             = None;
+                pSurface            = NULL;
             }
 
             void X11Window::calc_constraints(rectangle_t *dst, const rectangle_t *req)
@@ -335,7 +434,7 @@ namespace lsp
 
             ISurface *X11Window::get_surface()
             {
-                if (bWrapper)
+                if ((bWrapper) || (!bVisible))
                     return NULL;
                 return pSurface;
             }
@@ -424,16 +523,23 @@ namespace lsp
                         if (bWrapper)
                             break;
 
-                        // Drop previously existed drawing surface
-                        drop_surface();
-
-                        // Create surface
-                        Display *dpy    = pX11Display->x11display();
-                        Visual *v       = DefaultVisual(dpy, screen());
-                        pSurface        = new X11CairoSurface(
-                                            static_cast<X11Display *>(pDisplay),
-                                            hWindow, v, sSize.nWidth, sSize.nHeight
-                                          );
+                        // Keep the drawing surface from the previous show
+                        if (pSurface == NULL)
+                        {
+                            Display *dpy    = pX11Display->x11display();
+                            X11CairoSurface *surface = new X11CairoSurface(
+                                                static_cast<X11Display *>(pDisplay),
+                                                hWindow, DefaultVisual(dpy, screen()), sSize.nWidth, sSize.nHeight
+                                              );
+                            if ((surface != NULL) && (enBuffering != BUF_NONE))
+                                surface->set_buffering(enBuffering);
+                            pSurface        = surface;
+                        }
+                        else if ((ssize_t(pSurface->width()) != sSize.nWidth) || (ssize_t(pSurface->height()) != sSize.nHeight))
+                        {
+                            X11CairoSurface *surface = static_cast<X11CairoSurface *>(pSurface);
+                            surface->resize(sSize.nWidth, sSize.nHeight);
+                        }
 
                         // Need to take focus?
                         if (pX11Display->pFocusWindow == this)
@@ -443,12 +549,8 @@ namespace lsp
 
                     case UIE_HIDE:
                     {
+                        // The drawing surface is kept until the next show or release_surface() call
                         bVisible        = false;
-                        if (bWrapper)
-                            break;
-
-                        // Drop previously existed drawing surface
-                        drop_surface();
                         break;
                     }
 
@@ -586,15 +688,30 @@ namespace lsp
 
                 if (hWindow == None)
                     return STATUS_OK;
+                if (sUpdate.nLock > 0)
+                {
+                    sUpdate.nDirty     |= UF_BORDER;
+                    return STATUS_OK;
+                }
 
                 // Send changes to X11
+                send_border_style();
+                send_motif_hints();
+
+                status_t result = do_update_constraints();
+                pX11Display->flush();
+                return result;
+            }
+
+            void X11Window::send_border_style()
+            {
                 const x11_atoms_t &a = pX11Display->atoms();
 
                 Atom atoms[32];
                 int n_items = 0;
 
                 // Set window type
-                switch (style)
+                switch (enBorderStyle)
                 {
                     case BS_DIALOG:
                         atoms[n_items++] = a.X11__NET_WM_WINDOW_TYPE_DIALOG;
@@ -643,7 +760,7 @@ namespace lsp
 
                 // Set window state
                 n_items = 0;
-                switch (style)
+                switch (enBorderStyle)
                 {
                     case BS_DIALOG:         // Not resizable; no minimize/maximize menu
                         atoms[n_items++] = a.X11__NET_WM_STATE_MODAL;
@@ -673,9 +790,12 @@ namespace lsp
                     reinterpret_cast<unsigned char *>(&atoms[0]),
                     n_items
                 );
+            }
 
+            void X11Window::send_motif_hints()
+            {
+                const x11_atoms_t &a = pX11Display->atoms();
 
-                // Set MOTIF hints
 //                lsp_trace("Setting _MOTIF_WM_HINTS...");
                 XChangeProperty(
                     pX11Display->x11display(),
@@ -687,13 +807,6 @@ namespace lsp
                     reinterpret_cast<unsigned char *>(&sMotif),
                     sizeof(sMotif)/sizeof(long)
                 );
-
-
-//                lsp_trace("All seems to be OK");
-
-                status_t result = do_update_constraints();
-                pX11Display->flush();
-                return result;
             }
 
             status_t X11Window::get_border_style(border_style_t *style)
@@ -725,7 +838,7 @@ namespace lsp
 
             bool X11Window::is_visible()
             {
-                return pSurface != NULL;
+                return (pSurface != NULL) && (bVisible);
             }
 
             void *X11Window::handle()
@@ -747,6 +860,11 @@ namespace lsp
 
                 sSize.nLeft     = left;
                 sSize.nTop      = top;
+                if (sUpdate.nLock > 0)
+                {
+                    sUpdate.nDirty     |= UF_GEOMETRY;
+                    return STATUS_OK;
+                }
 
 //                lsp_trace("left=%d, top=%d", int(left), int(top));
 
@@ -755,7 +873,10 @@ namespace lsp
 //                else
                 status_t result = do_update_constraints(true);
                 if (hParent <= 0)
+                {
                     ::XMoveWindow(pX11Display->x11display(), hWindow, sSize.nLeft, sSize.nTop);
+                    pX11Display->invalidate_origins(hWindow);
+                }
                 if (result == STATUS_OK)
                     result = do_update_constraints();
                 if (result != STATUS_OK)
@@ -769,6 +890,11 @@ namespace lsp
             {
                 if (hWindow == None)
                     return STATUS_OK;
+                if (sUpdate.nLock > 0)
+                {
+                    sUpdate.nDirty     |= UF_GEOMETRY;
+                    return STATUS_OK;
+                }
 
                 // Temporarily drop constraints
                 status_t result = do_update_constraints(true);
@@ -833,6 +959,11 @@ namespace lsp
                     (old.nWidth == sSize.nWidth) &&
                     (old.nHeight == sSize.nHeight))
                     return STATUS_OK;
+                if (sUpdate.nLock > 0)
+                {
+                    sUpdate.nDirty     |= UF_GEOMETRY;
+                    return STATUS_OK;
+                }
 
                 status_t result = do_update_constraints(true);
                 if (hParent > 0)
@@ -853,6 +984,7 @@ namespace lsp
                     {
 //                        lsp_trace("XMoveResizeWindow(%d, %d, %d, %d)", int(sSize.nLeft), int(sSize.nTop), int(sSize.nWidth), int(sSize.nHeight));
                         ::XMoveResizeWindow(pX11Display->x11display(), hWindow, sSize.nLeft, sSize.nTop, sSize.nWidth, sSize.nHeight);
+                        pX11Display->invalidate_origins(hWindow);
                     }
                 }
 
@@ -884,15 +1016,23 @@ namespace lsp
                     return STATUS_BAD_STATE;
                 }
 
-                int x, y;
-                Window child;
-                Display *dpy = pX11Display->x11display();
-                // We do not trust XGetWindowAttributes since it can always return (0, 0) coordinates
-                XTranslateCoordinates(dpy, hWindow, pX11Display->hRootWnd, 0, 0, &x, &y, &child);
-                // lsp_trace("xy = {%d, %d}", int(x), int(y));
+                // The origin is kept up to date by ConfigureNotify and ReparentNotify events
+                if (!bAbsValid)
+                {
+                    int x, y;
+                    Window child;
+                    Display *dpy = pX11Display->x11display();
+                    // We do not trust XGetWindowAttributes since it can always return (0, 0) coordinates
+                    XTranslateCoordinates(dpy, hWindow, pX11Display->hRootWnd, 0, 0, &x, &y, &child);
+                    // lsp_trace("xy = {%d, %d}", int(x), int(y));
+
+                    nAbsLeft            = x;
+                    nAbsTop             = y;
+                    bAbsValid           = true;
+                }
 
-                realize->nLeft      = x;
-                realize->nTop       = y;
+                realize->nLeft      = nAbsLeft;
+                realize->nTop       = nAbsTop;
                 realize->nWidth     = sSize.nWidth;
                 realize->nHeight    = sSize.nHeight;
 
@@ -901,6 +1041,7 @@ namespace lsp
 
             status_t X11Window::hide()
             {
+                bool visible    = bVisible;
                 bVisible        = false;
                 hTransientFor   = None;
                 if (hWindow == 0)
@@ -921,9 +1062,11 @@ namespace lsp
                     nFlags &= ~F_LOCKING;
                 }
 
-                if (pSurface != NULL)
+                if ((pSurface != NULL) && (visible))
                     ::XUnmapWindow(dpy, hWindow);
 
+                // The cached pointer location may refer to the hidden window
+                pX11Display->invalidate_pointer();
                 pX11Display->flush();
                 return STATUS_OK;
             }
@@ -949,7 +1092,7 @@ namespace lsp
             {
                 if (hWindow == 0)
                     return STATUS_BAD_STATE;
-                if (pSurface != NULL)
+                if ((pSurface != NULL) && (bVisible))
                     return STATUS_OK;
 
                 ::Window transient_for = None;
@@ -971,8 +1114,10 @@ namespace lsp
 //                XGetWindowAttributes(pX11Display->x11display(), hWindow, &atts);
 //                lsp_trace("window x=%d, y=%d", atts.x, atts.y);
 
+                begin_update();
                 set_border_style(enBorderStyle);
                 set_window_actions(nActions);
+                commit_update();
 
                 switch (enBorderStyle)
                 {
@@ -1145,6 +1290,37 @@ namespace lsp
                 if (utf8 == NULL)
                     utf8 = ascii;
 
+                if (sUpdate.nLock > 0)
+                {
+                    char *xascii    = ::strdup(ascii);
+                    char *xutf8     = ::strdup(utf8);
+                    if ((xascii == NULL) || (xutf8 == NULL))
+                    {
+                        if (xascii != NULL)
+                            ::free(xascii);
+                        if (xutf8 != NULL)
+                            ::free(xutf8);
+                        return STATUS_NO_MEM;
+                    }
+
+                    if (sUpdate.sCaption != NULL)
+                        ::free(sUpdate.sCaption);
+                    if (sUpdate.sCaptionUtf8 != NULL)
+                        ::free(sUpdate.sCaptionUtf8);
+                    sUpdate.sCaption        = xascii;
+                    sUpdate.sCaptionUtf8    = xutf8;
+                    sUpdate.nDirty         |= UF_CAPTION;
+                    return STATUS_OK;
+                }
+
+                send_caption(ascii, utf8);
+                pX11Display->flush();
+
+                return STATUS_OK;
+            }
+
+            void X11Window::send_caption(const char *ascii, const char *utf8)
+            {
                 const x11_atoms_t &a = pX11Display->atoms();
 
                 ::XChangeProperty(
@@ -1177,10 +1353,6 @@ namespace lsp
                     reinterpret_cast<const unsigned char *>(utf8),
                     ::strlen(utf8)
                 );
-
-                pX11Display->flush();
-
-                return STATUS_OK;
             }
 
             status_t X11Window::get_caption(char *text, size_t len)
@@ -1235,28 +1407,39 @@ namespace lsp
                 if (hWindow <= 0)
                     return STATUS_BAD_STATE;
 
-                size_t n = width * height;
-                unsigned long *buffer = new unsigned long [n + 2];
-                if (buffer == NULL)
-                    return STATUS_NO_MEM;
+                X11IconSet icon(NULL);
+                status_t res = icon.add(bgra, width, height);
+                if (res != STATUS_OK)
+                    return res;
 
-                buffer[0] = width;
-                buffer[1] = height;
+                return apply_icon(&icon);
+            }
 
-                const uint32_t *ptr = reinterpret_cast<const uint32_t *>(bgra);
-                unsigned long *dst  = &buffer[2];
+            status_t X11Window::set_icon(const IIconSet *icon)
+            {
+                if (icon == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if (hWindow <= 0)
+                    return STATUS_BAD_STATE;
 
-                for (size_t i=0; i<n; ++i)
-                    *(dst++) = LE_TO_CPU(*(ptr++));
+                // Only icon sets created by the same display have the expected type
+                if (!pX11Display->owns_icon_set(icon))
+                    return STATUS_BAD_ARGUMENTS;
 
-                const x11_atoms_t &a = pX11Display->atoms();
+                return apply_icon(static_cast<const X11IconSet *>(icon));
+            }
 
-                XChangeProperty(
-                        pX11Display->x11display(), hWindow,
-                        a.X11__NET_WM_ICON, a.X11_XA_CARDINAL, 32, PropModeReplace,
-                        reinterpret_cast<unsigned char *>(buffer), n + 2);
+            status_t X11Window::apply_icon(const X11IconSet *xicon)
+            {
+                const x11_atoms_t &a    = pX11Display->atoms();
 
-                delete [] buffer; // Drop buffer
+                if (xicon->length() > 0)
+                    XChangeProperty(
+                            pX11Display->x11display(), hWindow,
+                            a.X11__NET_WM_ICON, a.X11_XA_CARDINAL, 32, PropModeReplace,
+                            reinterpret_cast<const unsigned char *>(xicon->data()), xicon->length());
+                else
+                    XDeleteProperty(pX11Display->x11display(), hWindow, a.X11__NET_WM_ICON);
 
                 return STATUS_OK;
             }
@@ -1290,15 +1473,28 @@ namespace lsp
 
                 if (hWindow == None)
                     return STATUS_OK;
+                if (sUpdate.nLock > 0)
+                {
+                    sUpdate.nDirty     |= UF_ACTIONS;
+                    return STATUS_OK;
+                }
+
+                send_window_actions();
+                send_motif_hints();
+                pX11Display->flush();
+
+                return STATUS_OK;
+            }
 
-                // Set window actions
+            void X11Window::send_window_actions()
+            {
                 Atom atoms[10];
                 size_t n_items = 0;
                 const x11_atoms_t &a = pX11Display->atoms();
 
                 // Update _NET_WM_ALLOWED_ACTIONS
                 #define TR_ACTION(from, to)    \
-                    if (actions & from) \
+                    if (nActions & from) \
                         atoms[n_items++] = a.X11__NET_WM_ACTION_ ## to;
 
                 TR_ACTION(WA_MOVE, MOVE);
@@ -1325,24 +1521,6 @@ namespace lsp
                     reinterpret_cast<unsigned char *>(&atoms[0]),
                     n_items
                 );
-
-
-                // Send _MOTIF_WM_HINTS
-//                lsp_trace("Setting _MOTIF_WM_HINTS...");
-                XChangeProperty(
-                    pX11Display->x11display(),
-                    hWindow,
-                    a.X11__MOTIF_WM_HINTS,
-                    a.X11__MOTIF_WM_HINTS,
-                    32,
-                    PropModeReplace,
-                    reinterpret_cast<unsigned char *>(&sMotif),
-                    sizeof(sMotif)/sizeof(long)
-                );
-
-                pX11Display->flush();
-
-                return STATUS_OK;
             }
 
             status_t X11Window::set_mouse_pointer(mouse_pointer_t pointer)
@@ -1379,6 +1557,24 @@ namespace lsp
                 ::memcpy(dup, instance, l1+1);
                 ::memcpy(&dup[l1+1], wclass, l2+1);
 
+                if (sUpdate.nLock > 0)
+                {
+                    if (sUpdate.sClass != NULL)
+                        ::free(sUpdate.sClass);
+                    sUpdate.sClass      = dup;
+                    sUpdate.nClassLen   = l1 + l2 + 2;
+                    sUpdate.nDirty     |= UF_CLASS;
+                    return STATUS_OK;
+                }
+
+                send_class(dup, l1 + l2 + 2);
+
+                ::free(dup);
+                return STATUS_OK;
+            }
+
+            void X11Window::send_class(const char *data, size_t len)
+            {
                 const x11_atoms_t &a = pX11Display->atoms();
                 ::XChangeProperty(
                     pX11Display->x11display(),
@@ -1387,12 +1583,9 @@ namespace lsp
                     a.X11_XA_STRING,
                     8,
                     PropModeReplace,
-                    reinterpret_cast<unsigned char *>(dup),
-                    (l1 + l2 + 2)
+                    reinterpret_cast<const unsigned char *>(data),
+                    len
                 );
-
-                ::free(dup);
-                return STATUS_OK;
             }
 
             status_t X11Window::set_role(const char *wrole)
@@ -1400,6 +1593,24 @@ namespace lsp
                 if (wrole == NULL)
                     return STATUS_BAD_ARGUMENTS;
 
+                if (sUpdate.nLock > 0)
+                {
+                    char *dup = ::strdup(wrole);
+                    if (dup == NULL)
+                        return STATUS_NO_MEM;
+                    if (sUpdate.sRole != NULL)
+                        ::free(sUpdate.sRole);
+                    sUpdate.sRole       = dup;
+                    sUpdate.nDirty     |= UF_ROLE;
+                    return STATUS_OK;
+                }
+
+                send_role(wrole);
+                return STATUS_OK;
+            }
+
+            void X11Window::send_role(const char *wrole)
+            {
                 const x11_atoms_t &a = pX11Display->atoms();
                 ::XChangeProperty(
                     pX11Display->x11display(),
@@ -1411,9 +1622,108 @@ namespace lsp
                     reinterpret_cast<const unsigned char *>(wrole),
                     ::strlen(wrole)
                 );
+            }
+
+            void X11Window::drop_update()
+            {
+                if (sUpdate.sCaption != NULL)
+                {
+                    ::free(sUpdate.sCaption);
+                    sUpdate.sCaption        = NULL;
+                }
+                if (sUpdate.sCaptionUtf8 != NULL)
+                {
+                    ::free(sUpdate.sCaptionUtf8);
+                    sUpdate.sCaptionUtf8    = NULL;
+                }
+                if (sUpdate.sClass != NULL)
+                {
+                    ::free(sUpdate.sClass);
+                    sUpdate.sClass          = NULL;
+                }
+                if (sUpdate.sRole != NULL)
+                {
+                    ::free(sUpdate.sRole);
+                    sUpdate.sRole           = NULL;
+                }
+                sUpdate.nClassLen       = 0;
+                sUpdate.nDirty          = 0;
+            }
+
+            status_t X11Window::set_buffering(buffering_t mode)
+            {
+                if (bWrapper)
+                    return STATUS_NOT_IMPLEMENTED;
+
+                if (pSurface != NULL)
+                {
+                    X11CairoSurface *surface = static_cast<X11CairoSurface *>(pSurface);
+                    if (!surface->set_buffering(mode))
+                        return STATUS_NO_MEM;
+                }
+
+                enBuffering     = mode;
+                return STATUS_OK;
+            }
 
+            buffering_t X11Window::get_buffering()
+            {
+                return enBuffering;
+            }
+
+            status_t X11Window::begin_update()
+            {
+                ++sUpdate.nLock;
                 return STATUS_OK;
             }
+
+            status_t X11Window::commit_update()
+            {
+                if (sUpdate.nLock <= 0)
+                    return STATUS_BAD_STATE;
+                if ((--sUpdate.nLock) > 0)
+                    return STATUS_OK;
+
+                size_t dirty    = sUpdate.nDirty;
+                status_t result = STATUS_OK;
+
+                if ((hWindow != None) && (dirty != 0))
+                {
+                    // Send all staged properties
+                    if (dirty & UF_CAPTION)
+                        send_caption(sUpdate.sCaption, sUpdate.sCaptionUtf8);
+                    if (dirty & UF_CLASS)
+                        send_class(sUpdate.sClass, sUpdate.nClassLen);
+                    if (dirty & UF_ROLE)
+                        send_role(sUpdate.sRole);
+                    if (dirty & UF_BORDER)
+                        send_border_style();
+                    if (dirty & UF_ACTIONS)
+                        send_window_actions();
+                    if (dirty & (UF_BORDER | UF_ACTIONS))
+                        send_motif_hints();
+
+                    // Send final size hints once and apply geometry with a single request
+                    if (dirty & (UF_BORDER | UF_ACTIONS | UF_GEOMETRY))
+                        result = do_update_constraints();
+                    if (dirty & UF_GEOMETRY)
+                    {
+                        Display *dpy = pX11Display->x11display();
+                        if (hParent > 0)
+                            ::XResizeWindow(dpy, hWindow, sSize.nWidth, sSize.nHeight);
+                        else
+                        {
+                            ::XMoveResizeWindow(dpy, hWindow, sSize.nLeft, sSize.nTop, sSize.nWidth, sSize.nHeight);
+                            pX11Display->invalidate_origins(hWindow);
+                        }
+                    }
+
+                    pX11Display->flush();
+                }
+
+                drop_update();
+                return result;
+            }
         }
     } /* namespace ws */
 } /* namespace lsp */
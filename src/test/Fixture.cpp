@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/ws/factory.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/test/Fixture.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace test
+        {
+            double time_ms()
+            {
+                system::time_t ts;
+                system::get_time(&ts);
+                return ts.seconds * 1000.0 + ts.nanos / 1000000.0;
+            }
+
+            bool same_pixels(ISurface *a, ISurface *b)
+            {
+                if ((a->width() != b->width()) || (a->height() != b->height()))
+                    return false;
+
+                a->begin();
+                b->begin();
+                uint8_t *pa = static_cast<uint8_t *>(a->start_direct());
+                uint8_t *pb = static_cast<uint8_t *>(b->start_direct());
+                bool res    = (pa != NULL) && (pb != NULL);
+
+                for (size_t i=0; (res) && (i<a->height()); ++i)
+                    res         = ::memcmp(&pa[i * a->stride()], &pb[i * b->stride()], a->width() * sizeof(uint32_t)) == 0;
+
+                a->end_direct();
+                b->end_direct();
+                a->end();
+                b->end();
+                return res;
+            }
+
+            Fixture::Fixture()
+            {
+                pDisplay        = NULL;
+            }
+
+            Fixture::~Fixture()
+            {
+                destroy();
+            }
+
+            status_t Fixture::init()
+            {
+                if (pDisplay != NULL)
+                    return STATUS_BAD_STATE;
+
+                pDisplay        = lsp_ws_create_display(0, NULL);
+                return (pDisplay != NULL) ? STATUS_OK : STATUS_UNKNOWN_ERR;
+            }
+
+            void Fixture::destroy()
+            {
+                // Windows and surfaces should be destroyed before the display
+                for (size_t i=0, n=vWindows.size(); i<n; ++i)
+                {
+                    IWindow *wnd    = vWindows.uget(i);
+                    wnd->destroy();
+                    delete wnd;
+                }
+                vWindows.flush();
+
+                for (size_t i=0, n=vSurfaces.size(); i<n; ++i)
+                {
+                    ISurface *s     = vSurfaces.uget(i);
+                    s->destroy();
+                    delete s;
+                }
+                vSurfaces.flush();
+
+                if (pDisplay != NULL)
+                {
+                    lsp_ws_free_display(pDisplay);
+                    pDisplay        = NULL;
+                }
+            }
+
+            ISurface *Fixture::add_surface(ISurface *s)
+            {
+                if (s == NULL)
+                    return NULL;
+                if (!vSurfaces.add(s))
+                {
+                    s->destroy();
+                    delete s;
+                    return NULL;
+                }
+                return s;
+            }
+
+            IWindow *Fixture::add_window(IWindow *wnd)
+            {
+                if (wnd == NULL)
+                    return NULL;
+                if ((wnd->init() != STATUS_OK) || (!vWindows.add(wnd)))
+                {
+                    wnd->destroy();
+                    delete wnd;
+                    return NULL;
+                }
+                return wnd;
+            }
+
+            ISurface *Fixture::create_surface(size_t width, size_t height)
+            {
+                return (pDisplay != NULL) ? add_surface(pDisplay->create_surface(width, height)) : NULL;
+            }
+
+            ISurface *Fixture::create_surface(size_t width, size_t height, surface_format_t format)
+            {
+                return (pDisplay != NULL) ? add_surface(pDisplay->create_surface(width, height, format)) : NULL;
+            }
+
+            IWindow *Fixture::create_window()
+            {
+                return (pDisplay != NULL) ? add_window(pDisplay->create_window()) : NULL;
+            }
+
+            IWindow *Fixture::create_window(border_style_t style)
+            {
+                return (pDisplay != NULL) ? add_window(pDisplay->create_window(style)) : NULL;
+            }
+        }
+    }
+}
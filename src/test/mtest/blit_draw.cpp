@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define SURFACE_WIDTH       1024
+#define SURFACE_HEIGHT      768
+#define IMAGE_SIZE          64
+#define TEST_CALLS          2000
+#define BATCH_SIZE          16
+#define BENCH_CALLS         20000
+
+MTEST_BEGIN("ws", blit_draw)
+
+    enum method_t
+    {
+        M_DRAW,
+        M_DRAW_FILTERED,
+        M_DRAW_CLIPPED,
+        M_DRAW_BATCH,
+
+        M_TOTAL
+    };
+
+    static const char *method_name(size_t method)
+    {
+        switch (method)
+        {
+            case M_DRAW:            return "draw";
+            case M_DRAW_FILTERED:   return "draw with filter";
+            case M_DRAW_CLIPPED:    return "draw_clipped";
+            case M_DRAW_BATCH:      return "draw_batch";
+            default: break;
+        }
+        return "unknown";
+    }
+
+    void prepare(ws::ISurface *s)
+    {
+        Color c(0.1f, 0.2f, 0.3f);
+
+        s->begin();
+        s->clear(c);
+        for (size_t i=0; i<16; ++i)
+        {
+            c.set_rgba(i / 16.0f, 0.5f, 1.0f - i / 16.0f, 0.25f);
+            s->fill_circle(s->width() * 0.5f, s->height() * 0.5f, (16 - i) * 24.0f, c);
+        }
+        s->end();
+    }
+
+    /**
+     * Draw the image with rings of different color and transparency,
+     * the background is fully transparent for the translucent image
+     */
+    void prepare_image(ws::ISurface *s, bool opaque)
+    {
+        Color c(0.9f, 0.6f, 0.2f, (opaque) ? 0.0f : 1.0f);
+
+        s->begin();
+        s->clear(c);
+        for (size_t i=0; i<8; ++i)
+        {
+            c.set_rgba(i / 8.0f, 1.0f - i / 8.0f, 0.5f, (opaque) ? 0.0f : i / 8.0f);
+            s->fill_circle(IMAGE_SIZE * 0.5f, IMAGE_SIZE * 0.5f, (8 - i) * 4.0f, c);
+        }
+        s->end();
+    }
+
+    /**
+     * Draw the image many times, rectangles partially or fully lay outside of the surface.
+     * The reference rendering wraps the drawing into the clip which covers the whole surface
+     * but is not aligned to pixels: this forces all images to be drawn by cairo without
+     * affecting the result.
+     */
+    void draw(ws::ISurface *s, ws::ISurface *img, size_t method, bool reference, bool clip)
+    {
+        ssize_t w = s->width(), h = s->height();
+        ws::surface_blit_t batch[BATCH_SIZE];
+        size_t nbatch = 0;
+
+        s->begin();
+        if (reference)
+            s->clip_begin(-0.5f, -0.5f, w + 1.0f, h + 1.0f);
+        if (clip)
+            s->clip_begin(64.0f, 48.0f, w - 128.0f, h - 96.0f);
+
+        for (size_t i=0; i<TEST_CALLS; ++i)
+        {
+            float x     = ssize_t((i * 37) % (w + IMAGE_SIZE * 2)) - IMAGE_SIZE;
+            float y     = ssize_t((i * 23) % (h + IMAGE_SIZE * 2)) - IMAGE_SIZE;
+            ssize_t sx  = ssize_t(i % 24) - 8;
+            ssize_t sy  = ssize_t((i * 5) % 24) - 8;
+            ssize_t sw  = (i * 7) % (IMAGE_SIZE + 8);
+            ssize_t sh  = (i * 11) % (IMAGE_SIZE + 8);
+
+            switch (method)
+            {
+                case M_DRAW:
+                    s->draw(img, x, y);
+                    break;
+                case M_DRAW_FILTERED:
+                    s->draw(img, x, y, 1.0f, 1.0f, ws::SFLT_GOOD);
+                    break;
+                case M_DRAW_CLIPPED:
+                    s->draw_clipped(img, x, y, sx, sy, sw, sh);
+                    break;
+                case M_DRAW_BATCH:
+                {
+                    // Source rectangles of the batch should lay inside of the image
+                    ws::surface_blit_t *b   = &batch[nbatch++];
+                    b->fX           = x;
+                    b->fY           = y;
+                    b->nLeft        = lsp_max(sx, ssize_t(0));
+                    b->nTop         = lsp_max(sy, ssize_t(0));
+                    b->nWidth       = lsp_min(sw, IMAGE_SIZE - b->nLeft);
+                    b->nHeight      = lsp_min(sh, IMAGE_SIZE - b->nTop);
+                    if (nbatch >= BATCH_SIZE)
+                    {
+                        s->draw_batch(img, batch, nbatch);
+                        nbatch          = 0;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        if (nbatch > 0)
+            s->draw_batch(img, batch, nbatch);
+
+        if (clip)
+            s->clip_end();
+        if (reference)
+            s->clip_end();
+        s->end();
+    }
+
+    void check(ws::ISurface *fast, ws::ISurface *ref, ws::ISurface *img, const char *name)
+    {
+        for (size_t i=0; i<M_TOTAL; ++i)
+            for (size_t j=0; j<2; ++j)
+            {
+                prepare(fast);
+                prepare(ref);
+                draw(fast, img, i, false, j > 0);
+                draw(ref, img, i, true, j > 0);
+                MTEST_ASSERT_MSG(ws::test::same_pixels(fast, ref), "Pixel mismatch for %s of %s image (%s)",
+                        method_name(i), name, (j > 0) ? "clipped" : "not clipped");
+            }
+    }
+
+    double bench(ws::ISurface *dst, ws::ISurface *src, float dx, float sx, ws::surface_filter_t filter)
+    {
+        dst->begin();
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_CALLS; ++i)
+            dst->draw(src, (i * 13) % 960 + dx, (i * 7) % 704 + dx, sx, sx, filter);
+        double time = ws::test::time_ms() - start;
+        dst->end();
+
+        return BENCH_CALLS / (time * 1000.0);
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *s = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(s != NULL);
+        ws::ISurface *ref = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(ref != NULL);
+
+        // Check that the direct drawing produces the same pixels as cairo
+        ws::ISurface *translucent = fx.create_surface(IMAGE_SIZE, IMAGE_SIZE, ws::SFMT_ARGB32);
+        ws::ISurface *opaque = fx.create_surface(IMAGE_SIZE, IMAGE_SIZE, ws::SFMT_ARGB32);
+        ws::ISurface *rgb24 = fx.create_surface(IMAGE_SIZE, IMAGE_SIZE, ws::SFMT_RGB24);
+        MTEST_ASSERT(translucent != NULL);
+        MTEST_ASSERT(opaque != NULL);
+        MTEST_ASSERT(rgb24 != NULL);
+        prepare_image(translucent, false);
+        prepare_image(opaque, true);
+        prepare_image(rgb24, true);
+
+        check(s, ref, translucent, "translucent ARGB32");
+        check(s, ref, opaque, "opaque ARGB32");
+        check(s, ref, rgb24, "RGB24");
+        printf("Direct drawing matches cairo rendering\n");
+
+        // Translucent and opaque images
+        ws::ISurface *argb = fx.create_surface(64, 64, ws::SFMT_ARGB32);
+        ws::ISurface *rgb = fx.create_surface(64, 64, ws::SFMT_RGB24);
+        MTEST_ASSERT(argb != NULL);
+        MTEST_ASSERT(rgb != NULL);
+
+        Color c(0.2f, 0.6f, 0.9f, 0.5f);
+        argb->begin();
+            argb->fill_circle(32.0f, 32.0f, 28.0f, c);
+        argb->end();
+        rgb->begin();
+            rgb->clear(c);
+        rgb->end();
+
+        printf("ARGB32 aligned: %.3f Mcalls/s, unaligned: %.3f Mcalls/s\n",
+                bench(s, argb, 0.0f, 1.0f, ws::SFLT_GOOD),
+                bench(s, argb, 0.5f, 1.0f, ws::SFLT_GOOD));
+        printf("RGB24 aligned: %.3f Mcalls/s, unaligned: %.3f Mcalls/s\n",
+                bench(s, rgb, 0.0f, 1.0f, ws::SFLT_GOOD),
+                bench(s, rgb, 0.5f, 1.0f, ws::SFLT_GOOD));
+        printf("Scaled x0.75 nearest: %.3f Mcalls/s, fast: %.3f Mcalls/s, good: %.3f Mcalls/s, best: %.3f Mcalls/s\n",
+                bench(s, argb, 0.0f, 0.75f, ws::SFLT_NEAREST),
+                bench(s, argb, 0.0f, 0.75f, ws::SFLT_FAST),
+                bench(s, argb, 0.0f, 0.75f, ws::SFLT_GOOD),
+                bench(s, argb, 0.0f, 0.75f, ws::SFLT_BEST));
+    }
+
+MTEST_END
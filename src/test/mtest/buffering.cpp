@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBXEXT)
+    #include <private/x11/X11Display.h>
+#endif /* USE_LIBX11 && USE_LIBXEXT */
+
+#define FRAME_COUNT         100
+#define WIDGET_COLUMNS      16
+#define WIDGET_ROWS         24
+
+MTEST_BEGIN("ws", buffering)
+
+    void draw_widgets(ws::ISurface *s, size_t frame)
+    {
+        Color bg(0.1f, 0.1f, 0.15f);
+        Color btn(0.25f, 0.45f, 0.65f);
+        Color brd(0.8f, 0.8f, 0.8f);
+        Color txt(1.0f, 1.0f, 0.0f);
+
+        ws::Font f;
+        f.set_name("example");
+        f.set_size(10);
+
+        s->begin();
+        s->clear(bg);
+
+        float w     = float(s->width()) / WIDGET_COLUMNS;
+        float h     = float(s->height()) / WIDGET_ROWS;
+
+        for (size_t y=0; y<WIDGET_ROWS; ++y)
+            for (size_t x=0; x<WIDGET_COLUMNS; ++x)
+            {
+                float l     = x * w + 2.0f;
+                float t     = y * h + 2.0f;
+
+                btn.set_rgb(0.25f, 0.45f, ((x + y + frame) % 32) / 32.0f);
+                s->fill_round_rect(btn, ws::CORNERS_ALL, 3.0f, l, t, w - 4.0f, h - 4.0f);
+                s->wire_round_rect(brd, ws::CORNERS_ALL, 3.0f, l, t, w - 4.0f, h - 4.0f, 1.0f);
+                s->line(l + 4.0f, t + h - 8.0f, l + w - 8.0f, t + 4.0f, 1.0f, brd);
+                s->out_text(f, txt, l + 4.0f, t + h * 0.5f, "W");
+            }
+
+        s->end();
+    }
+
+    double measure(ws::IDisplay *dpy, ws::IWindow *wnd)
+    {
+        ws::ISurface *s = wnd->get_surface();
+        MTEST_ASSERT(s != NULL);
+
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<FRAME_COUNT; ++i)
+        {
+            draw_widgets(s, i);
+            dpy->sync();        // Wait until the X server completes the frame
+        }
+
+        return (ws::test::time_ms() - start) / FRAME_COUNT;
+    }
+
+#if defined(USE_LIBX11) && defined(USE_LIBXEXT)
+    /**
+     * Make the server reject the segment like it does for remote connections
+     * and check that MIT-SHM gets disabled instead of terminating the process
+     */
+    bool force_shm_failure(ws::IDisplay *dpy)
+    {
+        ws::x11::X11Display *xdpy = static_cast<ws::x11::X11Display *>(dpy);
+        if (!xdpy->shm_supported())
+            return false;
+
+        XShmSegmentInfo info;
+        info.shmseg     = 0;
+        info.shmid      = -1;
+        info.shmaddr    = NULL;
+        info.readOnly   = False;
+
+        MTEST_ASSERT(!xdpy->shm_attach(&info));
+        MTEST_ASSERT(!xdpy->shm_supported());
+        return true;
+    }
+#endif /* USE_LIBX11 && USE_LIBXEXT */
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+        ws::IDisplay *dpy = fx.display();
+
+        ws::IWindow *wnd = fx.create_window();
+        MTEST_ASSERT(wnd != NULL);
+        MTEST_ASSERT(wnd->set_caption("Buffering test", "Buffering test") == STATUS_OK);
+        MTEST_ASSERT(wnd->resize(1024, 768) == STATUS_OK);
+        MTEST_ASSERT(wnd->show() == STATUS_OK);
+
+        // Wait until the window becomes visible
+        while (wnd->get_surface() == NULL)
+        {
+            dpy->wait_events(10);
+            dpy->main_iteration();
+        }
+
+        static const ws::buffering_t modes[] = { ws::BUF_NONE, ws::BUF_IMAGE, ws::BUF_PIXMAP };
+        static const char *names[] = { "direct", "image back buffer", "pixmap back buffer" };
+
+        for (size_t i=0; i<sizeof(modes)/sizeof(modes[0]); ++i)
+        {
+            MTEST_ASSERT(wnd->set_buffering(modes[i]) == STATUS_OK);
+            double time = measure(dpy, wnd);
+            printf("Frame time (%s): %.3f ms\n", names[i], time);
+        }
+
+    #if defined(USE_LIBX11) && defined(USE_LIBXEXT)
+        // The image back buffer should fall back to XPutImage
+        if (force_shm_failure(dpy))
+        {
+            MTEST_ASSERT(wnd->set_buffering(ws::BUF_NONE) == STATUS_OK);
+            MTEST_ASSERT(wnd->set_buffering(ws::BUF_IMAGE) == STATUS_OK);
+            double time = measure(dpy, wnd);
+            printf("Frame time (image back buffer, MIT-SHM failed): %.3f ms\n", time);
+        }
+    #endif /* USE_LIBX11 && USE_LIBXEXT */
+    }
+
+MTEST_END
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define SURFACE_WIDTH       1024
+#define SURFACE_HEIGHT      768
+#define TEST_CALLS          4000
+#define BENCH_CALLS         200000
+
+MTEST_BEGIN("ws", direct_fill)
+
+    enum primitive_t
+    {
+        P_FILL_RECT,
+        P_WIRE_RECT,
+        P_FILL_FRAME,
+        P_SQUARE_DOT,
+
+        P_TOTAL
+    };
+
+    static const char *primitive_name(size_t primitive)
+    {
+        switch (primitive)
+        {
+            case P_FILL_RECT:   return "fill_rect";
+            case P_WIRE_RECT:   return "wire_rect";
+            case P_FILL_FRAME:  return "fill_frame";
+            case P_SQUARE_DOT:  return "square_dot";
+            default: break;
+        }
+        return "unknown";
+    }
+
+    class Random
+    {
+        private:
+            uint32_t    nSeed;
+
+        public:
+            inline Random(uint32_t seed)    { nSeed = seed; }
+
+            inline uint32_t next()
+            {
+                nSeed       = nSeed * 1103515245 + 12345;
+                return nSeed >> 8;
+            }
+
+            inline float integer(ssize_t min, ssize_t max)
+            {
+                return min + ssize_t(next() % (max - min + 1));
+            }
+
+            inline float fraction()
+            {
+                return (next() & 0xffff) / 65535.0f;
+            }
+    };
+
+    void prepare(ws::ISurface *s)
+    {
+        Color c(0.1f, 0.2f, 0.3f);
+
+        s->begin();
+        s->clear(c);
+        for (size_t i=0; i<16; ++i)
+        {
+            c.set_rgba(i / 16.0f, 0.5f, 1.0f - i / 16.0f, 0.25f);
+            s->fill_circle(s->width() * 0.5f, s->height() * 0.5f, (16 - i) * 24.0f, c);
+        }
+        s->end();
+    }
+
+    /**
+     * Draw the sequence of primitives. The reference rendering wraps the drawing into the
+     * clip which covers the whole surface but is not aligned to pixels: this forces all
+     * primitives to be rasterized by cairo without affecting the result.
+     */
+    void draw(ws::ISurface *s, size_t primitive, size_t count, uint32_t seed, bool reference, bool clip)
+    {
+        Random rnd(seed);
+        Color c;
+        ssize_t w = s->width(), h = s->height();
+
+        s->begin();
+        if (reference)
+            s->clip_begin(-0.5f, -0.5f, w + 1.0f, h + 1.0f);
+        if (clip)
+            s->clip_begin(64.0f, 48.0f, w - 128.0f, h - 96.0f);
+        bool aa = s->set_antialiasing(primitive != P_WIRE_RECT);
+
+        for (size_t i=0; i<count; ++i)
+        {
+            float l     = rnd.integer(-32, w);
+            float t     = rnd.integer(-32, h);
+            float cw    = rnd.integer(-16, 96);
+            float ch    = rnd.integer(-16, 96);
+            float alpha = (rnd.next() & 1) ? 0.0f : rnd.fraction();
+            c.set_rgba(rnd.fraction(), rnd.fraction(), rnd.fraction(), alpha);
+
+            switch (primitive)
+            {
+                case P_FILL_RECT:
+                    s->fill_rect(c, l, t, cw, ch);
+                    break;
+                case P_WIRE_RECT:
+                    s->wire_rect(c, l, t, cw, ch, 1.0f);
+                    break;
+                case P_FILL_FRAME:
+                {
+                    float il    = l + rnd.integer(-8, 32);
+                    float it    = t + rnd.integer(-8, 32);
+                    float iw    = rnd.integer(0, 80);
+                    float ih    = rnd.integer(0, 80);
+                    s->fill_frame(c, l, t, cw, ch, il, it, iw, ih);
+                    break;
+                }
+                case P_SQUARE_DOT:
+                    s->square_dot(l, t, float(rnd.integer(0, 3) * 2 + 1), c);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        s->set_antialiasing(aa);
+        if (clip)
+            s->clip_end();
+        if (reference)
+            s->clip_end();
+        s->end();
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *fast = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(fast != NULL);
+        ws::ISurface *ref = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(ref != NULL);
+
+        for (size_t i=0; i<P_TOTAL; ++i)
+        {
+            // Check that the direct drawing produces the same pixels as cairo
+            for (size_t j=0; j<2; ++j)
+            {
+                prepare(fast);
+                prepare(ref);
+                draw(fast, i, TEST_CALLS, i * 2 + j, false, j > 0);
+                draw(ref, i, TEST_CALLS, i * 2 + j, true, j > 0);
+                MTEST_ASSERT_MSG(ws::test::same_pixels(fast, ref), "Pixel mismatch for %s (%s)",
+                        primitive_name(i), (j > 0) ? "clipped" : "not clipped");
+            }
+
+            // Measure the throughput
+            prepare(fast);
+            double start = ws::test::time_ms();
+            draw(fast, i, BENCH_CALLS, i, false, false);
+            double tf = ws::test::time_ms() - start;
+
+            prepare(ref);
+            start = ws::test::time_ms();
+            draw(ref, i, BENCH_CALLS, i, true, false);
+            double tr = ws::test::time_ms() - start;
+
+            printf("%-12s direct: %8.3f Mcalls/s, cairo: %8.3f Mcalls/s, speedup: %.2fx\n",
+                    primitive_name(i),
+                    BENCH_CALLS / (tf * 1000.0),
+                    BENCH_CALLS / (tr * 1000.0),
+                    tr / tf);
+        }
+
+    }
+
+MTEST_END
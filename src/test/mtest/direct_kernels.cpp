@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/pixels.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/test/Fixture.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+#define REGION_WIDTH        1024
+#define REGION_HEIGHT       512
+#define LUT_SIZE            256
+#define BENCH_PASSES        100
+
+// Odd sizes of the checked region to cover the tails of vectorized loops
+#define CHECK_WIDTH         37
+#define CHECK_HEIGHT        23
+#define CHECK_STRIDE        41
+#define CHECK_PIXELS        (CHECK_STRIDE * CHECK_HEIGHT)
+#define CHECK_LUT_SIZE      17
+
+MTEST_BEGIN("ws", direct_kernels)
+
+    static double mpixels(double time)
+    {
+        return (double(REGION_WIDTH) * REGION_HEIGHT * BENCH_PASSES) / (time * 1000.0);
+    }
+
+    static uint32_t random_value(uint32_t &seed)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    static uint32_t channel(uint32_t p, size_t i)
+    {
+        return (p >> (i * 8)) & 0xff;
+    }
+
+    void make_premultiplied(uint32_t *buf, size_t n, uint32_t seed)
+    {
+        for (size_t i=0; i<n; ++i)
+        {
+            uint32_t v  = random_value(seed);
+
+            // Groups of transparent and opaque pixels trigger the shortcuts in blending
+            switch ((i >> 2) % 5)
+            {
+                case 0: buf[i] = 0; break;
+                case 1: buf[i] = v | 0xff000000; break;
+                default:
+                {
+                    uint32_t a  = v >> 24;
+                    uint32_t p  = a << 24;
+                    for (size_t j=0; j<3; ++j)
+                        p          |= ((channel(v, j) * a) / 0xff) << (j * 8);
+                    buf[i]      = p;
+                    break;
+                }
+            }
+        }
+    }
+
+    void make_straight(uint32_t *buf, size_t n, uint32_t seed)
+    {
+        for (size_t i=0; i<n; ++i)
+        {
+            uint32_t v  = random_value(seed);
+            switch (i % 7)
+            {
+                case 0: buf[i] = v & 0x00ffffff; break;
+                case 1: buf[i] = v | 0xff000000; break;
+                default: buf[i] = v; break;
+            }
+        }
+    }
+
+    void make_values(float *buf, size_t n, uint32_t seed, float min, float max)
+    {
+        static const float special[] =
+        {
+            NAN, INFINITY, -INFINITY, 1e+30f, -1e+30f, 0.0f, -0.0f
+        };
+        const size_t nspecial = sizeof(special) / sizeof(float);
+
+        for (size_t i=0; i<n; ++i)
+        {
+            uint32_t v  = random_value(seed);
+            switch (i % 11)
+            {
+                case 0: buf[i] = special[(i / 11) % nspecial]; break;
+                case 1: buf[i] = min; break;
+                case 2: buf[i] = max; break;
+                default:
+                    // Values slightly out of the range are also generated
+                    buf[i] = min + (max - min) * ((v % 1201) / 1000.0f - 0.1f);
+                    break;
+            }
+        }
+    }
+
+    void compare(const char *kernel, const uint32_t *a, const uint32_t *b, size_t n, uint32_t tolerance)
+    {
+        for (size_t i=0; i<n; ++i)
+        {
+            for (size_t j=0; j<4; ++j)
+            {
+                uint32_t ca = channel(a[i], j), cb = channel(b[i], j);
+                uint32_t d  = (ca > cb) ? ca - cb : cb - ca;
+                MTEST_ASSERT_MSG(d <= tolerance,
+                    "%s mismatch at pixel %d: 0x%08x vs reference 0x%08x",
+                    kernel, int(i), int(a[i]), int(b[i]));
+            }
+        }
+    }
+
+    void check_kernels()
+    {
+        const size_t stride = CHECK_STRIDE * sizeof(uint32_t);
+        uint32_t *buf   = static_cast<uint32_t *>(malloc(CHECK_PIXELS * sizeof(uint32_t) * 3 + CHECK_LUT_SIZE * sizeof(uint32_t)));
+        float *values   = static_cast<float *>(malloc(CHECK_PIXELS * sizeof(float)));
+        MTEST_ASSERT(buf != NULL);
+        MTEST_ASSERT(values != NULL);
+
+        uint32_t *dst   = buf;
+        uint32_t *ref   = &dst[CHECK_PIXELS];
+        uint32_t *src   = &ref[CHECK_PIXELS];
+        uint32_t *lut   = &src[CHECK_PIXELS];
+
+        // Fill
+        make_straight(dst, CHECK_PIXELS, 1);
+        ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+        ws::pixels::fill(dst, stride, CHECK_WIDTH, CHECK_HEIGHT, 0x80402010);
+        ws::pixels::generic::fill(ref, stride, CHECK_WIDTH, CHECK_HEIGHT, 0x80402010);
+        compare("fill", dst, ref, CHECK_PIXELS, 0);
+
+        // Blend fill with translucent, opaque and fully transparent pixel
+        static const uint32_t solid[] = { 0x80402010, 0xff804020, 0x00000000, 0x01010101 };
+        for (size_t i=0; i<sizeof(solid)/sizeof(uint32_t); ++i)
+        {
+            make_premultiplied(dst, CHECK_PIXELS, 40 + i);
+            ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+            ws::pixels::blend_fill(dst, stride, CHECK_WIDTH, CHECK_HEIGHT, solid[i]);
+            ws::pixels::generic::blend_fill(ref, stride, CHECK_WIDTH, CHECK_HEIGHT, solid[i]);
+            compare("blend_fill", dst, ref, CHECK_PIXELS, 0);
+        }
+
+        // Copy opaque
+        make_straight(src, CHECK_PIXELS, 48);
+        make_straight(dst, CHECK_PIXELS, 49);
+        ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+        ws::pixels::copy_opaque(dst, stride, src, stride, CHECK_WIDTH, CHECK_HEIGHT);
+        ws::pixels::generic::copy_opaque(ref, stride, src, stride, CHECK_WIDTH, CHECK_HEIGHT);
+        compare("copy_opaque", dst, ref, CHECK_PIXELS, 0);
+
+        // Widen, each pixel takes two 32-bit words of the destination on 64-bit platforms
+        {
+            const size_t wstride = CHECK_WIDTH * sizeof(unsigned long);
+            unsigned long *wdst = static_cast<unsigned long *>(malloc(CHECK_WIDTH * CHECK_HEIGHT * sizeof(unsigned long) * 2));
+            MTEST_ASSERT(wdst != NULL);
+            unsigned long *wref = &wdst[CHECK_WIDTH * CHECK_HEIGHT];
+
+            make_straight(src, CHECK_PIXELS, 50);
+            ws::pixels::widen(wdst, wstride, src, stride, CHECK_WIDTH, CHECK_HEIGHT);
+            ws::pixels::generic::widen(wref, wstride, src, stride, CHECK_WIDTH, CHECK_HEIGHT);
+            for (size_t i=0; i<CHECK_WIDTH * CHECK_HEIGHT; ++i)
+                MTEST_ASSERT_MSG(wdst[i] == wref[i],
+                    "widen mismatch at pixel %d: 0x%lx vs reference 0x%lx", int(i), wdst[i], wref[i]);
+            free(wdst);
+        }
+
+        // Premultiply, includes pixels with a == 0 and a == 0xff
+        make_straight(dst, CHECK_PIXELS, 2);
+        ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+        ws::pixels::premultiply(dst, stride, CHECK_WIDTH, CHECK_HEIGHT);
+        ws::pixels::generic::premultiply(ref, stride, CHECK_WIDTH, CHECK_HEIGHT);
+        compare("premultiply", dst, ref, CHECK_PIXELS, 0);
+
+        // Unpremultiply valid pixels and pixels with color components exceeding alpha
+        make_premultiplied(dst, CHECK_PIXELS, 3);
+        ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+        ws::pixels::unpremultiply(dst, stride, CHECK_WIDTH, CHECK_HEIGHT);
+        ws::pixels::generic::unpremultiply(ref, stride, CHECK_WIDTH, CHECK_HEIGHT);
+        compare("unpremultiply", dst, ref, CHECK_PIXELS, 1);
+
+        make_straight(dst, CHECK_PIXELS, 4);
+        ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+        ws::pixels::unpremultiply(dst, stride, CHECK_WIDTH, CHECK_HEIGHT);
+        ws::pixels::generic::unpremultiply(ref, stride, CHECK_WIDTH, CHECK_HEIGHT);
+        compare("unpremultiply", dst, ref, CHECK_PIXELS, 1);
+
+        // Colormap with NaN, infinite and out-of-range values
+        make_straight(lut, CHECK_LUT_SIZE, 5);
+        make_values(values, CHECK_PIXELS, 6, -1.0f, 2.0f);
+        make_straight(dst, CHECK_PIXELS, 7);
+        ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+        ws::pixels::colormap(dst, stride, values, CHECK_STRIDE, CHECK_WIDTH, CHECK_HEIGHT, lut, CHECK_LUT_SIZE, -1.0f, 2.0f);
+        ws::pixels::generic::colormap(ref, stride, values, CHECK_STRIDE, CHECK_WIDTH, CHECK_HEIGHT, lut, CHECK_LUT_SIZE, -1.0f, 2.0f);
+        compare("colormap", dst, ref, CHECK_PIXELS, 0);
+
+        // Colormap with empty range and with the single entry
+        ws::pixels::colormap(dst, stride, values, CHECK_STRIDE, CHECK_WIDTH, CHECK_HEIGHT, lut, CHECK_LUT_SIZE, 0.5f, 0.5f);
+        ws::pixels::generic::colormap(ref, stride, values, CHECK_STRIDE, CHECK_WIDTH, CHECK_HEIGHT, lut, CHECK_LUT_SIZE, 0.5f, 0.5f);
+        compare("colormap", dst, ref, CHECK_PIXELS, 0);
+
+        ws::pixels::colormap(dst, stride, values, CHECK_STRIDE, CHECK_WIDTH, CHECK_HEIGHT, lut, 1, -1.0f, 2.0f);
+        ws::pixels::generic::colormap(ref, stride, values, CHECK_STRIDE, CHECK_WIDTH, CHECK_HEIGHT, lut, 1, -1.0f, 2.0f);
+        compare("colormap", dst, ref, CHECK_PIXELS, 0);
+
+        // Blend with different transparency, including the out-of-range values
+        static const float alpha[] = { 0.0f, 0.3f, 0.999f, 1.0f, -0.5f, 1.5f };
+        for (size_t i=0; i<sizeof(alpha)/sizeof(float); ++i)
+        {
+            make_premultiplied(src, CHECK_PIXELS, 8 + i);
+            make_premultiplied(dst, CHECK_PIXELS, 16 + i);
+            ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+            ws::pixels::blend(dst, stride, src, stride, CHECK_WIDTH, CHECK_HEIGHT, alpha[i]);
+            ws::pixels::generic::blend(ref, stride, src, stride, CHECK_WIDTH, CHECK_HEIGHT, alpha[i]);
+            compare("blend", dst, ref, CHECK_PIXELS, 0);
+        }
+
+        // Blur with both radii, with single radius and with radius exceeding the region
+        static const size_t radius[][2] = { { 3, 5 }, { 1, 1 }, { 50, 0 }, { 0, 4 }, { 0, 40 }, { 0, 0 } };
+        for (size_t i=0; i<sizeof(radius)/sizeof(radius[0]); ++i)
+        {
+            size_t rx = radius[i][0], ry = radius[i][1];
+            make_premultiplied(dst, CHECK_PIXELS, 32 + i);
+            ::memcpy(ref, dst, CHECK_PIXELS * sizeof(uint32_t));
+            MTEST_ASSERT(ws::pixels::blur(dst, stride, CHECK_WIDTH, CHECK_HEIGHT, rx, ry) == STATUS_OK);
+            MTEST_ASSERT(ws::pixels::generic::blur(ref, stride, CHECK_WIDTH, CHECK_HEIGHT, rx, ry) == STATUS_OK);
+            compare("blur", dst, ref, CHECK_PIXELS, 1);
+        }
+        MTEST_ASSERT(ws::pixels::blur(NULL, stride, CHECK_WIDTH, CHECK_HEIGHT, 1, 1) == STATUS_BAD_ARGUMENTS);
+
+        free(values);
+        free(buf);
+    }
+
+    MTEST_MAIN
+    {
+        check_kernels();
+
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *s = fx.create_surface(REGION_WIDTH + 64, REGION_HEIGHT + 64);
+        ws::ISurface *src = fx.create_surface(REGION_WIDTH, REGION_HEIGHT);
+        MTEST_ASSERT(s != NULL);
+        MTEST_ASSERT(src != NULL);
+
+        // Prepare the colormap and the data for the spectrogram-like image
+        uint32_t *lut = static_cast<uint32_t *>(malloc(LUT_SIZE * sizeof(uint32_t)));
+        float *data = static_cast<float *>(malloc(REGION_WIDTH * REGION_HEIGHT * sizeof(float)));
+        MTEST_ASSERT(lut != NULL);
+        MTEST_ASSERT(data != NULL);
+
+        for (size_t i=0; i<LUT_SIZE; ++i)
+        {
+            Color c;
+            c.set_hsl(float(i) / LUT_SIZE, 1.0f, 0.5f);
+            lut[i] = ws::pixels::pixel(c);
+        }
+        for (size_t i=0; i<REGION_WIDTH * REGION_HEIGHT; ++i)
+            data[i] = ((i * 7919) % 1000) * 0.001f;
+
+        // Translucent source for blending, direct access is only available while drawing
+        Color c(0.2f, 0.6f, 0.9f, 0.5f);
+        src->begin();
+        src->clear(c);
+        uint8_t *sp = static_cast<uint8_t *>(src->start_direct());
+        MTEST_ASSERT(sp != NULL);
+        size_t src_stride = src->stride();
+
+        // The region is placed at offset to check partial invalidation
+        ws::rectangle_t r;
+        r.nLeft     = 32;
+        r.nTop      = 32;
+        r.nWidth    = REGION_WIDTH;
+        r.nHeight   = REGION_HEIGHT;
+
+        s->begin();
+        uint8_t *dp = static_cast<uint8_t *>(s->start_direct());
+        MTEST_ASSERT(dp != NULL);
+        size_t stride = s->stride();
+        dp         += r.nTop * stride + r.nLeft * sizeof(uint32_t);
+
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_PASSES; ++i)
+            ws::pixels::colormap(dp, stride, data, REGION_WIDTH, REGION_WIDTH, REGION_HEIGHT, lut, LUT_SIZE, 0.0f, 1.0f);
+        double t_cmap = ws::test::time_ms() - start;
+
+        start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_PASSES; ++i)
+            ws::pixels::blend(dp, stride, sp, src_stride, REGION_WIDTH, REGION_HEIGHT, 0.25f);
+        double t_blend = ws::test::time_ms() - start;
+
+        start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_PASSES; ++i)
+            MTEST_ASSERT(ws::pixels::blur(dp, stride, REGION_WIDTH, REGION_HEIGHT, 4, 4) == STATUS_OK);
+        double t_blur = ws::test::time_ms() - start;
+
+        start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_PASSES; ++i)
+        {
+            ws::pixels::unpremultiply(dp, stride, REGION_WIDTH, REGION_HEIGHT);
+            ws::pixels::premultiply(dp, stride, REGION_WIDTH, REGION_HEIGHT);
+        }
+        double t_conv = ws::test::time_ms() - start;
+
+        s->end_direct(&r);
+        s->end();
+        src->end_direct(NULL);
+        src->end();
+
+        printf("Colormap: %.3f Mpix/s, blend: %.3f Mpix/s, blur: %.3f Mpix/s, unpremultiply+premultiply: %.3f Mpix/s\n",
+                mpixels(t_cmap), mpixels(t_blend), mpixels(t_blur), mpixels(t_conv));
+
+        free(lut);
+        free(data);
+    }
+
+MTEST_END
@@ -132,6 +132,19 @@ MTEST_BEGIN("ws", display)
         MTEST_ASSERT(wnd->resize(320, 200) == STATUS_OK);
         MTEST_ASSERT(wnd->set_size_constraints(160, 100, 640, 400) == STATUS_OK);
 
+        // Icon sets which are not created by the display should be rejected
+        uint32_t pixels[16 * 16];
+        for (size_t i=0; i<16*16; ++i)
+            pixels[i] = (i & 0x10) ? 0xff00c0ff : 0x80ffc000;
+        ws::IIconSet *icon = dpy->create_icon_set();
+        MTEST_ASSERT(icon != NULL);
+        MTEST_ASSERT(icon->add(pixels, 16, 16) == STATUS_OK);
+        MTEST_ASSERT(wnd->set_icon(icon) == STATUS_OK);
+        delete icon;
+
+        ws::IIconSet foreign;
+        MTEST_ASSERT(wnd->set_icon(&foreign) == STATUS_BAD_ARGUMENTS);
+
         size_t screen = wnd->screen();
         ssize_t sw, sh;
         MTEST_ASSERT(dpy->screen_size(screen, &sw, &sh) == STATUS_OK);
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define BENCH_FRAMES        1000
+#define BENCH_WIDGETS       64
+
+MTEST_BEGIN("ws", gradient_cache)
+
+    void draw_widget(ws::ISurface *s, float x, float y)
+    {
+        ws::IGradient *g = s->linear_gradient(x, y, x, y + 32.0f);
+        g->add_color(0.0f, 0.9f, 0.9f, 0.9f);
+        g->add_color(0.5f, 0.6f, 0.6f, 0.7f);
+        g->add_color(1.0f, 0.3f, 0.3f, 0.4f);
+        s->fill_rect(g, x, y, 96.0f, 32.0f);
+        delete g;
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *s = fx.create_surface(1024, 768);
+        MTEST_ASSERT(s != NULL);
+
+        // Widgets are drawn at the same positions every frame: gradients are taken from the cache
+        s->begin();
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_FRAMES; ++i)
+            for (size_t j=0; j<BENCH_WIDGETS; ++j)
+                draw_widget(s, (j % 8) * 120.0f, (j / 8) * 48.0f);
+        double tc = ws::test::time_ms() - start;
+        s->end();
+
+        // Each gradient has unique geometry: patterns are built for every call
+        s->begin();
+        start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_FRAMES; ++i)
+            for (size_t j=0; j<BENCH_WIDGETS; ++j)
+                draw_widget(s, (j % 8) * 120.0f + (i % 16) * 0.25f, (j / 8) * 48.0f + i * 0.001f);
+        double tu = ws::test::time_ms() - start;
+        s->end();
+
+        printf("Cached gradients: %.3f ms/frame, unique gradients: %.3f ms/frame\n",
+                tc / BENCH_FRAMES, tu / BENCH_FRAMES);
+
+    }
+
+MTEST_END
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define MASK_SIZE           256
+#define BENCH_CALLS         2000
+
+MTEST_BEGIN("ws", mask_draw)
+
+    /**
+     * Draw the soft round shadow into the layer
+     */
+    void draw_shadow(ws::ISurface *s)
+    {
+        Color c(0.0f, 0.0f, 0.0f, 1.0f);
+
+        s->begin();
+        s->clear(c);
+        for (size_t i=0; i<16; ++i)
+        {
+            c.set_rgba(0.0f, 0.0f, 0.0f, 1.0f - (i + 1) / 16.0f);
+            s->fill_round_rect(c, SURFMASK_ALL_CORNER, 16.0f - i,
+                    i * 2.0f, i * 2.0f, MASK_SIZE - i * 4.0f, MASK_SIZE - i * 4.0f);
+        }
+        s->end();
+    }
+
+    double bench(ws::ISurface *dst, ws::ISurface *layer, bool mask)
+    {
+        Color c(0.0f, 0.25f, 0.5f);
+
+        dst->begin();
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_CALLS; ++i)
+        {
+            float x = (i * 37) % (dst->width() - MASK_SIZE);
+            float y = (i * 17) % (dst->height() - MASK_SIZE);
+            if (mask)
+                dst->draw_mask(c, layer, x, y);
+            else
+                dst->draw(layer, x, y);
+        }
+        double time = ws::test::time_ms() - start;
+        dst->end();
+
+        return time;
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *dst = fx.create_surface(1024, 768);
+        MTEST_ASSERT(dst != NULL);
+        ws::ISurface *argb = dst->create(MASK_SIZE, MASK_SIZE, ws::SFMT_ARGB32);
+        MTEST_ASSERT(argb != NULL);
+        ws::ISurface *a8 = dst->create(MASK_SIZE, MASK_SIZE, ws::SFMT_A8);
+        MTEST_ASSERT(a8 != NULL);
+        MTEST_ASSERT(a8->format() == ws::SFMT_A8);
+
+        draw_shadow(argb);
+        draw_shadow(a8);
+
+        double ta   = bench(dst, argb, false);
+        double tm   = bench(dst, a8, true);
+
+        printf("ARGB32 layer: %.3f ms, %d bytes; A8 mask: %.3f ms, %d bytes; speedup: %.2fx\n",
+                ta, int(argb->height() * MASK_SIZE * sizeof(uint32_t)),
+                tm, int(a8->height() * MASK_SIZE * sizeof(uint8_t)),
+                ta / tm);
+
+        a8->destroy();
+        delete a8;
+        argb->destroy();
+        delete argb;
+    }
+
+MTEST_END
+
+
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define BENCH_CALLS         100000
+
+MTEST_BEGIN("ws", path_cache)
+
+    void check_arcs(ws::test::Fixture &fx)
+    {
+        static const float radius[] = { 3.0f, 10.5f, 40.0f };
+
+        ws::ISurface *a = fx.create_surface(128, 128);
+        ws::ISurface *b = fx.create_surface(128, 128);
+        MTEST_ASSERT((a != NULL) && (b != NULL));
+
+        Color bg(0.0f, 0.0f, 0.0f);
+        Color c(0.25f, 0.5f, 0.75f, 0.25f);
+
+        for (size_t i=0; i<sizeof(radius)/sizeof(float); ++i)
+        {
+            float r = radius[i];
+
+            // Path translated to the position should produce the same pixels as the direct drawing
+            ws::IPath *path = a->create_path();
+            MTEST_ASSERT(path != NULL);
+            MTEST_ASSERT(path->arc(r, r, r, 0.0f, M_PI * 2.0f) == STATUS_OK);
+
+            a->begin();
+            a->clear(bg);
+            a->fill_path(c, path, 17.0f, 23.0f);
+            a->end();
+
+            b->begin();
+            b->clear(bg);
+            b->fill_circle(17.0f + r, 23.0f + r, r, c);
+            b->end();
+
+            MTEST_ASSERT_MSG(ws::test::same_pixels(a, b), "Arc of radius %.1f does not match fill_circle()", r);
+            delete path;
+        }
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        check_arcs(fx);
+
+        ws::ISurface *s = fx.create_surface(1024, 768);
+        MTEST_ASSERT(s != NULL);
+
+        Color c(0.5f, 0.5f, 0.5f, 0.5f);
+
+        // Buttons of the same size drawn with the cached round rectangle path
+        s->begin();
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_CALLS; ++i)
+            s->fill_round_rect(c, SURFMASK_ALL_CORNER, 4.0f, (i * 13) % 960, (i * 7) % 736, 48.0f, 24.0f);
+        double trr = ws::test::time_ms() - start;
+        s->end();
+
+        // Complex shape built once with the path object
+        ws::IPath *path = s->create_path();
+        MTEST_ASSERT(path != NULL);
+        MTEST_ASSERT(path->round_rect(SURFMASK_ALL_CORNER, 4.0f, 0.0f, 0.0f, 48.0f, 24.0f) == STATUS_OK);
+        MTEST_ASSERT(path->sector(24.0f, 12.0f, 10.0f, 0.0f, M_PI) == STATUS_OK);
+
+        s->begin();
+        start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_CALLS; ++i)
+            s->fill_path(c, path, (i * 13) % 960, (i * 7) % 736);
+        double tp = ws::test::time_ms() - start;
+        s->end();
+
+        printf("fill_round_rect: %.3f Mcalls/s, fill_path: %.3f Mcalls/s\n",
+                BENCH_CALLS / (trr * 1000.0), BENCH_CALLS / (tp * 1000.0));
+
+        delete path;
+    }
+
+MTEST_END
+
+
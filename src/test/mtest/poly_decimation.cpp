@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+#include <private/x11/X11Decimation.h>
+
+#define SURFACE_WIDTH       1536
+#define SURFACE_HEIGHT      512
+#define CURVE_POINTS        65536
+#define BENCH_FRAMES        50
+
+MTEST_BEGIN("ws", poly_decimation)
+
+    /**
+     * Generate dense curve similar to the oscillogram: the noisy signal with
+     * many samples per each pixel column of the surface
+     */
+    void make_curve(float *x, float *y, size_t n, float width, float height)
+    {
+        uint32_t seed   = 1;
+        float dx        = width / (n - 1);
+        float cy        = height * 0.5f;
+
+        for (size_t i=0; i<n; ++i)
+        {
+            seed            = seed * 1103515245 + 12345;
+            float noise     = ((seed >> 8) & 0xffff) / 65535.0f - 0.5f;
+            x[i]            = i * dx;
+            y[i]            = cy + height * (0.3f * sinf(i * 0.0005f) + 0.1f * noise);
+        }
+    }
+
+#ifdef USE_LIBX11
+    /**
+     * Straightforward decimation: keep the first, the lowest, the highest
+     * and the last point of each pixel column in the original order
+     */
+    size_t reference_decimate(float *dx, float *dy, const float *x, const float *y, size_t n)
+    {
+        size_t count    = 0;
+
+        for (size_t i=0; i<n; )
+        {
+            float lo        = floorf(x[i]);
+            size_t j        = i + 1;
+            while ((j < n) && (x[j] >= lo) && (x[j] < lo + 1.0f))
+                ++j;
+
+            size_t imin = i, imax = i;
+            for (size_t k=i+1; k<j; ++k)
+            {
+                if (y[k] < y[imin])
+                    imin        = k;
+                if (y[k] > y[imax])
+                    imax        = k;
+            }
+
+            size_t v[4]     = { i, lsp_min(imin, imax), lsp_max(imin, imax), j - 1 };
+            for (size_t k=i; k<j; ++k)
+            {
+                if ((j - i > 4) && (k != v[0]) && (k != v[1]) && (k != v[2]) && (k != v[3]))
+                    continue;
+                dx[count]       = x[k];
+                dy[count]       = y[k];
+                ++count;
+            }
+
+            i               = j;
+        }
+
+        return count;
+    }
+
+    void check_kernels(const float *x, const float *y, size_t n)
+    {
+        // Extremes of ranges of different lengths and alignments
+        for (size_t off=0; off<4; ++off)
+            for (size_t len=1; len<=64; ++len)
+            {
+                size_t smin, smax, gmin, gmax;
+                ws::x11::find_extremes(&y[off], len, &smin, &smax);
+                ws::x11::generic::find_extremes(&y[off], len, &gmin, &gmax);
+                MTEST_ASSERT_MSG((smin == gmin) && (smax == gmax),
+                    "find_extremes mismatch: offset=%d, length=%d", int(off), int(len));
+            }
+
+        // Runs of points starting at each point
+        for (size_t i=0; i<n; ++i)
+        {
+            float lo        = floorf(x[i]);
+            size_t sr       = ws::x11::find_run_end(x, i, n, lo, lo + 1.0f);
+            size_t gr       = ws::x11::generic::find_run_end(x, i, n, lo, lo + 1.0f);
+            MTEST_ASSERT_MSG(sr == gr, "find_run_end mismatch at point %d: %d vs %d", int(i), int(sr), int(gr));
+        }
+    }
+
+    void check_decimation(const float *x, const float *y, size_t n)
+    {
+        float *buf      = new float[n * 4];
+        MTEST_ASSERT(buf != NULL);
+        float *dx = &buf[0], *dy = &buf[n], *rx = &buf[n*2], *ry = &buf[n*3];
+
+        check_kernels(x, y, n);
+
+        size_t rcount   = reference_decimate(rx, ry, x, y, n);
+
+        // Both the optimized and the scalar paths should produce the same envelope
+        size_t count    = 0;
+        for (size_t pass=0; pass<2; ++pass)
+        {
+            count           = (pass == 0) ?
+                ws::x11::decimate_polyline(dx, dy, x, y, n) :
+                ws::x11::generic::decimate_polyline(dx, dy, x, y, n);
+
+            MTEST_ASSERT_MSG(count == rcount, "Decimated %d points, expected %d", int(count), int(rcount));
+            for (size_t i=0; i<count; ++i)
+                MTEST_ASSERT_MSG((dx[i] == rx[i]) && (dy[i] == ry[i]),
+                    "Point %d differs: {%f, %f} vs {%f, %f}", int(i), dx[i], dy[i], rx[i], ry[i]);
+        }
+
+        printf("Decimation of %d points: %d points left, envelope preserved\n", int(n), int(count));
+        delete [] buf;
+    }
+#endif /* USE_LIBX11 */
+
+    double draw(ws::ISurface *s, const float *x, const float *y, size_t n, bool fill, bool decimation)
+    {
+        Color bg(0.0f, 0.0f, 0.0f);
+        Color fg(0.0f, 1.0f, 0.0f, 0.5f);
+
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_FRAMES; ++i)
+        {
+            s->begin();
+            s->set_decimation(decimation);
+            s->clear(bg);
+            if (fill)
+                s->fill_poly(fg, x, y, n);
+            else
+                s->wire_poly(fg, 1.0f, x, y, n);
+            s->end();
+        }
+
+        return (ws::test::time_ms() - start) / BENCH_FRAMES;
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *s = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(s != NULL);
+
+        float *x = new float[CURVE_POINTS * 2];
+        MTEST_ASSERT(x != NULL);
+        float *y = &x[CURVE_POINTS];
+
+    #ifdef USE_LIBX11
+        // Sparse curve keeps short runs untouched, quantized values produce ties of extremes
+        make_curve(x, y, CURVE_POINTS, CURVE_POINTS / 3, SURFACE_HEIGHT);
+        check_decimation(x, y, CURVE_POINTS);
+        make_curve(x, y, CURVE_POINTS, SURFACE_WIDTH, SURFACE_HEIGHT);
+        for (size_t i=0; i<CURVE_POINTS; ++i)
+            y[i]        = floorf(y[i] * 0.125f);
+        check_decimation(x, y, CURVE_POINTS);
+    #endif /* USE_LIBX11 */
+
+        make_curve(x, y, CURVE_POINTS, SURFACE_WIDTH, SURFACE_HEIGHT);
+
+        for (size_t i=0; i<2; ++i)
+        {
+            const char *name = (i > 0) ? "fill_poly" : "wire_poly";
+            double raw  = draw(s, x, y, CURVE_POINTS, i > 0, false);
+            double dec  = draw(s, x, y, CURVE_POINTS, i > 0, true);
+
+            printf("%-10s %d points: raw path: %8.3f ms/frame, decimated: %8.3f ms/frame, speedup: %.2fx\n",
+                    name, int(CURVE_POINTS), raw, dec, raw / dec);
+        }
+
+        delete [] x;
+    }
+
+MTEST_END
+
+
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/IEventHandler.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define POPUP_ITERATIONS        20
+
+MTEST_BEGIN("ws", popup_pool)
+
+    class Handler: public ws::IEventHandler
+    {
+        private:
+            ws::IWindow    *pWnd;
+            bool            bDrawn;
+
+        public:
+            inline Handler(ws::IWindow *wnd)
+            {
+                pWnd        = wnd;
+                bDrawn      = false;
+            }
+
+            inline bool drawn() const   { return bDrawn; }
+
+            virtual status_t handle_event(const ws::event_t *ev)
+            {
+                if (ev->nType != ws::UIE_REDRAW)
+                    return IEventHandler::handle_event(ev);
+
+                ws::ISurface *s = pWnd->get_surface();
+                if (s == NULL)
+                    return STATUS_OK;
+
+                Color c(0.0f, 0.5f, 0.75f);
+                s->begin();
+                s->clear(c);
+                s->end();
+                bDrawn      = true;
+
+                return STATUS_OK;
+            }
+    };
+
+    double measure_popup(ws::IDisplay *dpy, ws::IWindow *parent)
+    {
+        double start = ws::test::time_ms();
+
+        ws::IWindow *wnd = dpy->create_window(ws::BS_POPUP);
+        MTEST_ASSERT(wnd != NULL);
+        MTEST_ASSERT(wnd->init() == STATUS_OK);
+        MTEST_ASSERT(wnd->set_border_style(ws::BS_POPUP) == STATUS_OK);
+        MTEST_ASSERT(wnd->set_geometry(parent->left() + 16, parent->top() + 16, 160, 240) == STATUS_OK);
+
+        Handler h(wnd);
+        wnd->set_handler(&h);
+        MTEST_ASSERT(wnd->show(parent) == STATUS_OK);
+
+        // Process events until the first frame has been drawn
+        while (!h.drawn())
+        {
+            dpy->wait_events(10);
+            dpy->main_iteration();
+        }
+
+        double time = ws::test::time_ms() - start;
+
+        wnd->hide();
+        wnd->destroy();
+        delete wnd;
+
+        // Let the display to refill the window pool
+        for (size_t i=0; i<10; ++i)
+        {
+            dpy->wait_events(5);
+            dpy->main_iteration();
+        }
+
+        return time;
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+        ws::IDisplay *dpy = fx.display();
+
+        ws::IWindow *wnd = fx.create_window();
+        MTEST_ASSERT(wnd != NULL);
+        MTEST_ASSERT(wnd->set_caption("Test window", "Test window") == STATUS_OK);
+        MTEST_ASSERT(wnd->resize(320, 200) == STATUS_OK);
+        MTEST_ASSERT(wnd->show() == STATUS_OK);
+
+        size_t pool_size = dpy->window_pool_size();
+
+        // Measure time-to-first-frame with and without the window pool
+        for (size_t pass=0; pass<2; ++pass)
+        {
+            MTEST_ASSERT(dpy->set_window_pool_size((pass == 0) ? 0 : lsp_max(pool_size, size_t(1))) == STATUS_OK);
+
+            double min = 0.0, max = 0.0, avg = 0.0;
+            for (size_t i=0; i<POPUP_ITERATIONS; ++i)
+            {
+                double t    = measure_popup(dpy, wnd);
+                min         = (i == 0) ? t : lsp_min(min, t);
+                max         = (i == 0) ? t : lsp_max(max, t);
+                avg        += t;
+            }
+            avg        /= POPUP_ITERATIONS;
+
+            printf("Time to first frame (%s): min=%.3f ms, max=%.3f ms, avg=%.3f ms\n",
+                    (pass == 0) ? "no pool" : "window pool",
+                    min, max, avg);
+        }
+    }
+
+MTEST_END
+
+
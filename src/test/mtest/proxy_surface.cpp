@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/ProxySurface.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define FRAME_COUNT         200
+#define SURFACE_WIDTH       1024
+#define SURFACE_HEIGHT      768
+#define WIDGET_COLUMNS      16
+#define WIDGET_ROWS         24
+
+MTEST_BEGIN("ws", proxy_surface)
+
+    void draw_widgets(ws::ISurface *s, size_t frame)
+    {
+        Color bg(0.1f, 0.1f, 0.15f);
+        Color btn(0.25f, 0.45f, 0.65f);
+        Color brd(0.8f, 0.8f, 0.8f);
+        Color txt(1.0f, 1.0f, 0.0f);
+
+        ws::Font f;
+        f.set_name("example");
+        f.set_size(10);
+
+        s->begin();
+        s->clear(bg);
+
+        float w     = float(s->width()) / WIDGET_COLUMNS;
+        float h     = float(s->height()) / WIDGET_ROWS;
+        float px[4], py[4];
+
+        for (size_t y=0; y<WIDGET_ROWS; ++y)
+            for (size_t x=0; x<WIDGET_COLUMNS; ++x)
+            {
+                float l     = x * w + 2.0f;
+                float t     = y * h + 2.0f;
+
+                s->clip_begin(l, t, w - 4.0f, h - 4.0f);
+
+                btn.set_rgb(0.25f, 0.45f, ((x + y + frame) % 32) / 32.0f);
+                ws::IGradient *g = s->linear_gradient(l, t, l, t + h);
+                g->add_color(0.0f, btn);
+                g->add_color(1.0f, brd);
+                s->fill_round_rect(g, ws::CORNERS_ALL, 3.0f, l, t, w - 4.0f, h - 4.0f);
+                delete g;
+
+                s->wire_round_rect(brd, ws::CORNERS_ALL, 3.0f, l, t, w - 4.0f, h - 4.0f, 1.0f);
+                s->line(l + 4.0f, t + h - 8.0f, l + w - 8.0f, t + 4.0f, 1.0f, brd);
+
+                px[0] = l + w * 0.5f;   py[0] = t + 4.0f;
+                px[1] = l + w - 8.0f;   py[1] = t + h * 0.5f;
+                px[2] = l + w * 0.5f;   py[2] = t + h - 8.0f;
+                px[3] = l + 4.0f;       py[3] = t + h * 0.5f;
+                s->wire_poly(txt, 1.0f, px, py, 4);
+
+                s->out_text(f, txt, l + 4.0f, t + h * 0.5f, "W");
+
+                s->clip_end();
+            }
+
+        s->end();
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *img = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(img != NULL);
+        ws::ProxySurface *proxy = new ws::ProxySurface(img, SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(proxy != NULL);
+
+        // Direct rendering
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<FRAME_COUNT; ++i)
+            draw_widgets(img, i);
+        double direct = (ws::test::time_ms() - start) / FRAME_COUNT;
+
+        // Recording only
+        start = ws::test::time_ms();
+        for (size_t i=0; i<FRAME_COUNT; ++i)
+            draw_widgets(proxy, i);
+        double record = (ws::test::time_ms() - start) / FRAME_COUNT;
+
+        // Replay of the recorded frame
+        start = ws::test::time_ms();
+        for (size_t i=0; i<FRAME_COUNT; ++i)
+        {
+            img->begin();
+            proxy->replay(img);
+            img->end();
+        }
+        double replay = (ws::test::time_ms() - start) / FRAME_COUNT;
+
+        printf("Commands per frame:   %d\n", int(proxy->commands()));
+        printf("Direct rendering:     %.3f ms/frame\n", direct);
+        printf("Recording:            %.3f ms/frame (%.1f%% of direct)\n", record, record * 100.0 / direct);
+        printf("Replay:               %.3f ms/frame (%.1f%% of direct)\n", replay, replay * 100.0 / direct);
+
+        proxy->destroy();
+        delete proxy;
+    }
+
+MTEST_END
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define BENCH_FRAMES        200
+#define BENCH_SPRITES       256
+#define SPRITE_SIZE         16
+
+MTEST_BEGIN("ws", sprite_atlas)
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+        ws::IDisplay *dpy = fx.display();
+
+        ws::ISurface *s = fx.create_surface(1024, 768);
+        MTEST_ASSERT(s != NULL);
+
+        ws::SpriteAtlas *atlas = dpy->create_sprite_atlas(256, 256);
+        MTEST_ASSERT(atlas != NULL);
+
+        // Create small images and pack them into the atlas
+        ws::ISurface **images   = new ws::ISurface *[BENCH_SPRITES];
+        ws::sprite_t *sprites   = new ws::sprite_t[BENCH_SPRITES];
+        float *x                = new float[BENCH_SPRITES];
+        float *y                = new float[BENCH_SPRITES];
+
+        for (size_t i=0; i<BENCH_SPRITES; ++i)
+        {
+            images[i]   = fx.create_surface(SPRITE_SIZE + (i % 5), SPRITE_SIZE + (i % 3));
+            MTEST_ASSERT(images[i] != NULL);
+
+            Color c((i % 7) / 7.0f, (i % 11) / 11.0f, (i % 13) / 13.0f);
+            images[i]->begin();
+                images[i]->fill_circle(SPRITE_SIZE * 0.5f, SPRITE_SIZE * 0.5f, SPRITE_SIZE * 0.4f, c);
+            images[i]->end();
+
+            MTEST_ASSERT(atlas->add(images[i], &sprites[i]) == STATUS_OK);
+            x[i]        = (i % 32) * 32.0f;
+            y[i]        = (i / 32) * 32.0f;
+        }
+
+        printf("Packed %d sprites into %d pages of %dx%d\n",
+                int(BENCH_SPRITES), int(atlas->pages()), int(atlas->page_width()), int(atlas->page_height()));
+
+        // Draw each image separately
+        s->begin();
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_FRAMES; ++i)
+            for (size_t j=0; j<BENCH_SPRITES; ++j)
+                s->draw(images[j], x[j], y[j]);
+        double ts = ws::test::time_ms() - start;
+        s->end();
+
+        // Draw sprites from the atlas
+        s->begin();
+        start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_FRAMES; ++i)
+            atlas->draw(s, sprites, x, y, BENCH_SPRITES);
+        double ta = ws::test::time_ms() - start;
+        s->end();
+
+        printf("Separate surfaces: %.3f ms/frame, sprite atlas: %.3f ms/frame\n",
+                ts / BENCH_FRAMES, ta / BENCH_FRAMES);
+
+        delete [] images;
+        delete [] sprites;
+        delete [] x;
+        delete [] y;
+
+        delete atlas;
+    }
+
+MTEST_END
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#ifdef USE_LIBX11
+    #include <private/x11/X11CairoSurface.h>
+#endif /* USE_LIBX11 */
+
+#define BENCH_FRAMES        500
+#define LAYERS_PER_FRAME    8
+
+MTEST_BEGIN("ws", surface_pool)
+
+    /**
+     * Simulate the toolkit which creates temporary layers of slightly
+     * varying size each frame and draws them on the window surface
+     */
+    double draw_frames(ws::ISurface *dst)
+    {
+        Color c(0.25f, 0.5f, 0.75f, 0.5f);
+
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<BENCH_FRAMES; ++i)
+        {
+            dst->begin();
+            for (size_t j=0; j<LAYERS_PER_FRAME; ++j)
+            {
+                size_t w        = 200 + ((i + j * 7) % 24);
+                size_t h        = 120 + ((i * 3 + j) % 16);
+                ws::ISurface *s = dst->create(w, h);
+                MTEST_ASSERT(s != NULL);
+
+                s->begin();
+                s->fill_round_rect(c, SURFMASK_ALL_CORNER, 8.0f, 0.0f, 0.0f, w, h);
+                s->end();
+
+                ws::ISurface *cp = s->create_copy();
+                MTEST_ASSERT(cp != NULL);
+                dst->draw(cp, j * 16.0f, j * 8.0f);
+
+                cp->destroy();
+                delete cp;
+                s->destroy();
+                delete s;
+            }
+            dst->end();
+        }
+
+        return (ws::test::time_ms() - start) / BENCH_FRAMES;
+    }
+
+#ifdef USE_LIBX11
+    /**
+     * Shrink and grow the image within its capacity: the kept area should
+     * retain the contents and the newly exposed area should be cleared
+     */
+    void check_resize(ws::ISurface *s)
+    {
+        ws::x11::X11CairoSurface *xs = static_cast<ws::x11::X11CairoSurface *>(s);
+        Color c(1.0f, 1.0f, 1.0f);
+
+        s->begin();
+        s->clear(c);
+        s->end();
+
+        MTEST_ASSERT(xs->resize(120, 60));
+        MTEST_ASSERT(xs->resize(200, 100));
+
+        s->begin();
+        const uint8_t *data = static_cast<const uint8_t *>(s->start_direct());
+        MTEST_ASSERT(data != NULL);
+        for (size_t y=0; y<100; ++y)
+        {
+            const uint32_t *row = reinterpret_cast<const uint32_t *>(&data[y * s->stride()]);
+            for (size_t x=0; x<200; ++x)
+            {
+                uint32_t expected = ((x < 120) && (y < 60)) ? 0xffffffff : 0;
+                MTEST_ASSERT_MSG(row[x] == expected, "Pixel {%d, %d} is 0x%08x, expected 0x%08x",
+                    int(x), int(y), int(row[x]), int(expected));
+            }
+        }
+        s->end_direct(NULL);
+        s->end();
+    }
+#endif /* USE_LIBX11 */
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+        ws::IDisplay *dpy = fx.display();
+
+        ws::ISurface *dst = fx.create_surface(640, 480);
+        MTEST_ASSERT(dst != NULL);
+
+    #ifdef USE_LIBX11
+        ws::ISurface *rs = fx.create_surface(200, 100);
+        MTEST_ASSERT(rs != NULL);
+        check_resize(rs);
+    #endif /* USE_LIBX11 */
+
+        size_t limit = dpy->surface_pool_limit();
+        ws::surface_pool_stats_t st;
+
+        // Measure without the pool
+        MTEST_ASSERT(dpy->set_surface_pool_limit(0) == STATUS_OK);
+        double raw      = draw_frames(dst);
+
+        // Measure with the pool
+        MTEST_ASSERT(dpy->set_surface_pool_limit(limit) == STATUS_OK);
+        MTEST_ASSERT(dpy->get_surface_pool_stats(&st) == STATUS_OK);
+        size_t hits     = st.nHits;
+        size_t misses   = st.nMisses;
+        double pooled   = draw_frames(dst);
+        MTEST_ASSERT(dpy->get_surface_pool_stats(&st) == STATUS_OK);
+
+        printf("No pool: %.3f ms/frame, surface pool: %.3f ms/frame, speedup: %.2fx\n",
+                raw, pooled, raw / pooled);
+        printf("Pool statistics: hits=%d, misses=%d, evictions=%d, surfaces=%d, bytes=%d, limit=%d\n",
+                int(st.nHits - hits), int(st.nMisses - misses), int(st.nEvictions),
+                int(st.nSurfaces), int(st.nBytes), int(st.nLimit));
+
+    }
+
+MTEST_END
+
+
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/ProxySurface.h>
+#include <lsp-plug.in/ws/TiledRasterizer.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#define FRAME_COUNT         20
+#define SURFACE_WIDTH       3840
+#define SURFACE_HEIGHT      2160
+#define GRAPH_POINTS        2048
+#define GRAPH_CURVES        16
+
+MTEST_BEGIN("ws", tiled_rasterizer)
+
+    void draw_graph(ws::ISurface *s)
+    {
+        Color bg(0.0f, 0.0f, 0.0f);
+        Color grid(0.0f, 0.5f, 0.0f);
+        Color curve(1.0f, 1.0f, 0.0f);
+        Color txt(1.0f, 1.0f, 1.0f);
+        float *x    = new float[GRAPH_POINTS];
+        float *y    = new float[GRAPH_POINTS];
+
+        ws::Font f;
+        f.set_name("example");
+        f.set_size(16);
+
+        float w     = s->width();
+        float h     = s->height();
+
+        s->begin();
+        s->clear(bg);
+
+        // Grid with labels
+        for (size_t i=0; i<=32; ++i)
+        {
+            float gx    = w * i / 32.0f;
+            float gy    = h * i / 32.0f;
+            s->line(gx, 0.0f, gx, h, 1.0f, grid);
+            s->line(0.0f, gy, w, gy, 1.0f, grid);
+            s->out_text(f, txt, gx + 4.0f, h - 8.0f, "100");
+        }
+
+        // Spectrum-like curves with filled areas
+        for (size_t j=0; j<GRAPH_CURVES; ++j)
+        {
+            for (size_t i=0; i<GRAPH_POINTS; ++i)
+            {
+                x[i]        = w * i / (GRAPH_POINTS - 1);
+                y[i]        = h * (0.5f + 0.4f * sinf(i * (j + 1) * 0.01f) * cosf(i * 0.003f + j));
+            }
+
+            curve.set_rgb(1.0f, float(j) / GRAPH_CURVES, 0.0f);
+            s->wire_poly(curve, 2.0f, x, y, GRAPH_POINTS);
+        }
+
+        ws::IGradient *g = s->linear_gradient(0.0f, 0.0f, 0.0f, h);
+        g->add_color(0.0f, 1.0f, 0.0f, 0.0f, 0.5f);
+        g->add_color(1.0f, 0.0f, 0.0f, 1.0f, 0.5f);
+        s->fill_poly(g, x, y, GRAPH_POINTS);
+        delete g;
+
+        s->end();
+
+        delete [] x;
+        delete [] y;
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *ref = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(ref != NULL);
+        ws::ISurface *img = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(img != NULL);
+        ws::ProxySurface *proxy = new ws::ProxySurface(img, SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(proxy != NULL);
+
+        // Record the frame and render the reference image on the single thread
+        draw_graph(proxy);
+        ref->begin();
+        proxy->replay(ref);
+        ref->end();
+
+        ws::TiledRasterizer rast;
+        size_t cores    = lsp_max(ipc::Thread::system_cores(), size_t(1));
+        double single   = 0.0;
+
+        for (size_t threads=1; threads<=cores; ++threads)
+        {
+            MTEST_ASSERT(rast.set_threads(threads) == STATUS_OK);
+
+            double start = ws::test::time_ms();
+            for (size_t i=0; i<FRAME_COUNT; ++i)
+            {
+                img->begin();
+                MTEST_ASSERT(rast.render(img, proxy) == STATUS_OK);
+                img->end();
+            }
+            double time = (ws::test::time_ms() - start) / FRAME_COUNT;
+            if (threads == 1)
+                single      = time;
+
+            MTEST_ASSERT_MSG(ws::test::same_pixels(ref, img), "Output of %d threads differs from single-threaded rendering", int(threads));
+            printf("Threads: %2d, frame time: %.3f ms, speedup: %.2fx\n", int(threads), time, single / time);
+        }
+
+        proxy->destroy();
+        delete proxy;
+    }
+
+MTEST_END
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2020 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <private/test/Fixture.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+    #include <private/x11/X11CairoSurface.h>
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
+
+#define FRAME_COUNT         500
+#define SURFACE_WIDTH       800
+#define SURFACE_HEIGHT      600
+#define WIDGET_COLUMNS      8
+#define WIDGET_ROWS         8
+
+MTEST_BEGIN("ws", widget_repaint)
+
+    /**
+     * Typical repaint of the widget grid: buttons, knobs, meters and small graphs.
+     */
+    void draw_widgets(ws::ISurface *s, size_t frame)
+    {
+        Color bg(0.1f, 0.1f, 0.15f);
+        Color face(0.25f, 0.45f, 0.65f);
+        Color border(0.8f, 0.8f, 0.8f);
+        Color led(0.0f, 1.0f, 0.0f, 0.5f);
+        Color mesh(1.0f, 1.0f, 1.0f, 0.75f);
+
+        s->begin();
+        s->clear(bg);
+
+        float w     = float(s->width()) / WIDGET_COLUMNS;
+        float h     = float(s->height()) / WIDGET_ROWS;
+
+        for (size_t y=0; y<WIDGET_ROWS; ++y)
+            for (size_t x=0; x<WIDGET_COLUMNS; ++x)
+            {
+                float l     = x * w + 2.0f;
+                float t     = y * h + 2.0f;
+                float k     = ((x * 7 + y * 3 + frame) % 64) / 64.0f;
+
+                s->clip_begin(l, t, w - 4.0f, h - 4.0f);
+
+                // Button
+                bool aa = s->set_antialiasing(false);
+                s->fill_rect(face, l, t, w - 4.0f, 16.0f);
+                s->wire_rect(border, l, t, w - 5.0f, 15.0f, 1.0f);
+                s->set_antialiasing(aa);
+
+                // Knob
+                float cx    = l + w * 0.25f, cy = t + h * 0.5f, r = h * 0.2f;
+                s->fill_circle(cx, cy, r, face);
+                s->wire_arc(cx, cy, r + 2.0f, M_PI * 0.75f, M_PI * (0.75f + 1.5f * k), 3.0f, led);
+                s->line(cx, cy, cx + r * cosf(M_PI * (0.75f + 1.5f * k)), cy + r * sinf(M_PI * (0.75f + 1.5f * k)), 2.0f, border);
+
+                // Meter
+                for (size_t i=0; i<8; ++i)
+                    s->square_dot(l + w * 0.5f + i * 4.0f, t + h - 12.0f, 3.0f, (i < k * 8) ? led : mesh);
+
+                // Graph mesh
+                for (size_t i=0; i<4; ++i)
+                {
+                    float gx    = l + w * 0.5f + i * w * 0.1f;
+                    s->line(gx, t + 20.0f, gx, t + h - 20.0f, 1.0f, mesh);
+                    s->line(l + w * 0.5f, t + 20.0f + i * 8.0f, l + w - 8.0f, t + 20.0f + i * 8.0f, 1.0f, mesh);
+                }
+
+                s->clip_end();
+            }
+
+        s->end();
+    }
+
+    MTEST_MAIN
+    {
+        ws::test::Fixture fx;
+        MTEST_ASSERT(fx.init() == STATUS_OK);
+
+        ws::ISurface *img = fx.create_surface(SURFACE_WIDTH, SURFACE_HEIGHT);
+        MTEST_ASSERT(img != NULL);
+
+        size_t calls = 0, skips = 0;
+        double start = ws::test::time_ms();
+        for (size_t i=0; i<FRAME_COUNT; ++i)
+        {
+            draw_widgets(img, i);
+
+        #if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+            // Counters are reset by begin() and stay valid after end()
+            ws::x11::X11CairoSurface *cs = static_cast<ws::x11::X11CairoSurface *>(img);
+            calls      += cs->state_calls();
+            skips      += cs->state_skips();
+        #endif /* USE_LIBX11 && USE_LIBCAIRO */
+        }
+        double time = (ws::test::time_ms() - start) / FRAME_COUNT;
+
+        printf("Widget repaint: %.3f ms/frame\n", time);
+
+    #if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+        printf("Cairo state changes: issued=%.1f/frame, skipped=%.1f/frame\n",
+            double(calls) / FRAME_COUNT, double(skips) / FRAME_COUNT);
+
+        // The grid repeats the same colors, widths and antialiasing modes
+        MTEST_ASSERT(calls > 0);
+        MTEST_ASSERT(skips > 0);
+    #endif /* USE_LIBX11 && USE_LIBCAIRO */
+    }
+
+MTEST_END